@@ -1,74 +1,25 @@
+#pragma once
 #define _USE_MATH_DEFINES 
 
 #include <GL/glew.h>
 #include <GL/freeglut.h> 
+#include "SceneRegistry.h"
+#include "SimdMath.h"
+#include "TransformHierarchy.h"
+#include "ParametricSurface.h"
+#include "Instancing.h"
 #include <iostream>
 #include <random>
 #include <vector>
 
 namespace AnimatedGarden
 {
-struct Vector
-{
-	Vector(float pX = 0.f, float pY = 0.f, float pZ = 0.f)
-		:
-		X{ pX },
-		Y{ pY },
-		Z{ pZ }
-	{
-
-	}
-
-	float length() const noexcept
-	{
-		return std::sqrt(X * X + Y * Y + Z * Z);
-	}
-
-	Vector& operator+=(const Vector& rhs) noexcept
-	{
-		return *this = *this + rhs;;
-	}
-
-	Vector& operator-=(const Vector& rhs) noexcept
-	{
-		return *this = *this - rhs;;
-	}
-
-	Vector operator+(const Vector& rhs) const noexcept
-	{
-		return { X + rhs.X, Y + rhs.Y, Z + rhs.Z };
-	}
-
-	Vector operator-(const Vector& rhs) const noexcept
-	{
-		return { X - rhs.X, Y - rhs.Y, Z - rhs.Z };
-	}
-
-	Vector operator*(float v) const noexcept
-	{
-		return { X * v, Y * v, Z * v };
-	}
-
-	Vector& operator*=(float v) noexcept
-	{
-		return *this = *this * v;
-	}
+using Vector = SimdMath::Vec3;
+using SimdMath::Mat4;
+using TransformHierarchy::Node;
 
-	bool operator==(const Vector& rhs) const noexcept
-	{
-		return (X == rhs.X) && (Y == rhs.Y) && (Z == rhs.Z);
-	}
-
-	bool operator!=(const Vector& rhs) const noexcept
-	{
-		return !((*this) == rhs);
-	}
-
-	float X;
-	float Y;
-	float Z;
-
-};
+// The nodes of all the flowers, evaluated once per frame with the view as the root
+TransformHierarchy::Hierarchy hierarchy;
 
 struct Color
 {
@@ -146,34 +97,27 @@ static int animationPeriod = 40;
 
 void drawHemisphere(float radius, int longSlices, int latSlices)
 {
-	int  i, j;
-	for (j = 0; j < latSlices; j++)
+	// Every flower draws the same hemisphere, so the mesh is only rebuilt when asked for another one
+	static ParametricSurface::Mesh mesh;
+	static float meshRadius;
+
+	if (mesh.positions.empty() || radius != meshRadius || longSlices != mesh.uSlices || latSlices != mesh.vSlices)
 	{
-		glBegin(GL_TRIANGLE_STRIP);
-		for (i = 0; i <= longSlices; i++)
-		{
-			glVertex3f(radius * cos((float)(j + 1) / latSlices * M_PI / 2.0) * cos(2.0 * (float)i / longSlices * M_PI),
-				radius * sin((float)(j + 1) / latSlices * M_PI / 2.0),
-				-radius * cos((float)(j + 1) / latSlices * M_PI / 2.0) * sin(2.0 * (float)i / longSlices * M_PI));
-			glVertex3f(radius * cos((float)j / latSlices * M_PI / 2.0) * cos(2.0 * (float)i / longSlices * M_PI),
+		mesh = ParametricSurface::tessellate({ longSlices, latSlices }, [=](int i, int j) {
+			return Vector(radius * cos((float)j / latSlices * M_PI / 2.0) * cos(2.0 * (float)i / longSlices * M_PI),
 				radius * sin((float)j / latSlices * M_PI / 2.0),
 				-radius * cos((float)j / latSlices * M_PI / 2.0) * sin(2.0 * (float)i / longSlices * M_PI));
-		}
-		glEnd();
+		});
+		meshRadius = radius;
 	}
-}
 
-void drawCircle(float radius, int numVertices)
-{
-	int i;
-	float t;
-	glBegin(GL_LINE_LOOP);
-	for (i = 0; i < numVertices; ++i)
-	{
-		t = 2 * M_PI * i / numVertices;
-		glVertex3f(radius * cos(t), radius * sin(t), 0.0);
-	}
-	glEnd();
+	glEnableClientState(GL_VERTEX_ARRAY);
+	glVertexPointer(3, GL_FLOAT, 0, mesh.positions.data());
+
+	for (int j = 0; j < mesh.vSlices; j++)
+		glDrawElements(GL_TRIANGLE_STRIP, mesh.getStripLength(), GL_UNSIGNED_INT, mesh.getStrip(j));
+
+	glDisableClientState(GL_VERTEX_ARRAY);
 }
 
 template<typename T1, typename T2>
@@ -191,16 +135,15 @@ struct Sepal
 
 	}
 
-	void draw()
+	Mat4 getTransform() const
 	{
-		glColor3f(1.0, 0.0, 0.0);
-		glPushMatrix();
-		glRotatef(90.0, 0.0, 0.0, 1.0);
+		return Mat4::rotation(90.f, { 0.f, 0.f, 1.f }) * Mat4::scaling({ hemisphereScaleFactor, 1.f, hemisphereScaleFactor });
+	}
 
-		glScalef(hemisphereScaleFactor, 1.0, hemisphereScaleFactor);
+	static void draw()
+	{
+		glColor3f(1.0, 0.0, 0.0);
 		drawHemisphere(2.0, 6, 6);
-
-		glPopMatrix();
 	}
 
 private:
@@ -222,21 +165,30 @@ struct Petal
 
 	}
 
-	void draw(float angle, const Color& color)
+	Mat4 getTransform(float angle) const
 	{
-		glColor3f(color.R, color.G, color.B);
-		glPushMatrix();
+		return Mat4::rotation(angle, { 1.f, 0.f, 0.f }) *
+			Mat4::translation({ 2.f, 0.f, 2.f * hemisphereScaleFactor }) *
+			Mat4::translation({ -2.f, 0.f, 0.f }) *
+			Mat4::rotation(petalOpenAngle, { 0.f, 1.f, 0.f }) *
+			Mat4::translation({ 2.f, 0.f, 0.f }) *
+			Mat4::scaling({ 1.f, petalAspectRatio, 1.f });
+	}
 
-		glRotatef(angle, 1.0, 0.0, 0.0);
-		glTranslatef(2.0, 0.0, 2.0 * hemisphereScaleFactor);
+	// A circle of radius 2 outlined with 10 vertices
+	static void setMesh(Instancing::Batch& batch)
+	{
+		std::vector<Vector> positions;
+		std::vector<unsigned int> indices;
 
-		glTranslatef(-2.0, 0.0, 0.0);
-		glRotatef(petalOpenAngle, 0.0, 1.0, 0.0);
-		glTranslatef(2.0, 0.0, 0.0);
+		for (int i = 0; i < 10; ++i)
+		{
+			const float t = 2 * M_PI * i / 10;
+			positions.push_back(Vector(2.f * cos(t), 2.f * sin(t), 0.f));
+			indices.push_back(i);
+		}
 
-		glScalef(1.0, petalAspectRatio, 1.0);
-		drawCircle(2.0, 10);
-		glPopMatrix();
+		batch.setMesh(GL_LINE_LOOP, positions, indices);
 	}
 
 private:
@@ -248,9 +200,14 @@ private:
 
 struct Stem
 {
-	void draw(float angle)
+	// Every next segment starts rotated at the end of the previous one
+	static Mat4 getTransform(float angle)
+	{
+		return Mat4::rotation(angle, { 0.f, 0.f, 1.f });
+	}
+
+	static void draw()
 	{
-		glRotatef(angle, 0.0, 0.0, 1.0);
 		glColor3f(0.0, 1.0, 0.0);
 		glLineWidth(3.0);
 		glBegin(GL_LINES);
@@ -262,7 +219,20 @@ struct Stem
 
 struct Leaf
 {
-	void draw(bool verse, float t)
+	static Mat4 getTransform(bool verse, float t)
+	{
+		const auto mult = (verse ? 1.f : -1.f);
+
+		const float leafScale = interpolate(0.0f, 0.75f * mult, t);
+
+		return Mat4::rotation(-30.f * mult, { 0.f, 1.f, 0.f }) *
+			Mat4::scaling({ leafScale, leafScale, leafScale }) *
+			Mat4::rotation(-Yangle, { 0.f, 1.f, 0.f }) *
+			Mat4::rotation(-45.f, { 0.f, 0.f, 1.f }) *
+			Mat4::rotation(-120.f, { 0.f, 1.f, 0.f });
+	}
+
+	static void draw()
 	{
 		const std::vector<Vector> v{
 			{0.f, 0.f, 0.f},
@@ -271,10 +241,6 @@ struct Leaf
 			{1.5f, 2.5f, 0.f}
 		};
 
-		const auto mult = (verse ? 1.f : -1.f);
-
-		const float leafScale = interpolate(0.0f, 0.75f * mult, t);
-
 		glEnableClientState(GL_VERTEX_ARRAY);
 
 		glVertexPointer(3, GL_FLOAT, 0, v.data());
@@ -282,16 +248,8 @@ struct Leaf
 		glColor3f(0.f, 1.f, 0.f);
 		glLineWidth(3.f);
 
-		glPushMatrix();
-
-		glRotated(-30.f * mult, 0.f, 1.f, 0.f);
-		glScaled(leafScale, leafScale, leafScale);
-		glRotated(-Yangle, 0.f, 1.f, 0.f);
-		glRotated(-45.f, 0.f, 0.f, 1.f);
-		glRotated(-120.f, 0.f, 1.f, 0.f);
 		glDrawArrays(GL_LINE_LOOP, 0, v.size());
 
-		glPopMatrix();
 		glDisableClientState(GL_VERTEX_ARRAY);
 	}
 };
@@ -305,7 +263,8 @@ struct Flower
 		windT{},
 		tMult{ pTMult },
 		RWind{},
-		petalColor{ initPetalColor() }
+		petalColor{ initPetalColor() },
+		nodes{ initNodes() }
 	{
 
 	}
@@ -328,17 +287,56 @@ struct Flower
 		if (!(t >= 1.f))
 			t += 0.01 * tMult;
 
-		draw();
+		updateNodes();
+	}
+
+	// Expects the hierarchy to be evaluated after the last tick
+	void draw() const
+	{
+		hierarchy.load(nodes.stems[0]);
+		Stem::draw();
+		hierarchy.load(nodes.stems[1]);
+		Stem::draw();
+
+		for (const auto leafNode : nodes.leaves)
+		{
+			hierarchy.load(leafNode);
+			Leaf::draw();
+		}
+
+		hierarchy.load(nodes.stems[2]);
+		Stem::draw();
+		hierarchy.load(nodes.stems[3]);
+		Stem::draw();
+
+		hierarchy.load(nodes.sepal);
+		Sepal::draw();
+	}
+
+	// The petals are drawn for all the flowers at once, their world matrices include the view
+	void appendPetals(std::vector<Instancing::Instance>& instances) const
+	{
+		for (const auto petalNode : nodes.petals)
+			instances.push_back({ hierarchy.getWorld(petalNode), { petalColor.R, petalColor.G, petalColor.B } });
 	}
 
 private:
 
+	struct Nodes
+	{
+		Node stems[4];
+		Node leaves[2];
+		Node sepal;
+		Node petals[6];
+	};
+
 	Transform transform;
 	float t;
 	float tMult;
 	float windT;
 	float RWind;
 	Color petalColor;
+	Nodes nodes;
 
 	Color initPetalColor()
 	{
@@ -352,18 +350,32 @@ private:
 		return v[Random::getRandomInt(0, v.size() - 1)];
 	}
 
-	void draw()
+	Nodes initNodes() const
+	{
+		Nodes n;
+
+		n.stems[0] = hierarchy.add();
+		n.stems[1] = hierarchy.add(n.stems[0]);
+
+		for (auto& leaf : n.leaves)
+			leaf = hierarchy.add(n.stems[1]);
+
+		n.stems[2] = hierarchy.add(n.stems[1]);
+		n.stems[3] = hierarchy.add(n.stems[2]);
+		n.sepal = hierarchy.add(n.stems[3]);
+
+		for (auto& petal : n.petals)
+			petal = hierarchy.add(n.stems[3]);
+
+		return n;
+	}
+
+	void updateNodes() const
 	{
 		const auto& loc = transform.translation;
 		const auto& scale = transform.scale;
 		const auto& rot = transform.rotation;
 
-		glPushMatrix();
-
-		glTranslated(loc.X, loc.Y, loc.Z);
-		glRotated(rot.angle, rot.dirs.X, rot.dirs.Y, rot.dirs.Z);
-		glScaled(scale.X, scale.Y, scale.Z);
-
 		float angleFirstSegment = interpolate(60.f, 80.f, t);
 		float angleSecondSegment = interpolate(-30.f, -20.f, t);
 		float angleThirdSegment = interpolate(-30.f, -20.f, t);
@@ -373,42 +385,37 @@ private:
 		float petalAspectRatio = interpolate(0.1f, 1.f, t);
 		float petalOpenAngle = interpolate(-10.f, -60.f, t);
 
-		Sepal sepal{ hemisphereScaleFactor };
-		Petal petal{ hemisphereScaleFactor, petalOpenAngle, petalAspectRatio };
-		Stem stem{};
-		Leaf leaf;
-
-		stem.draw(angleFirstSegment + RWind * sin(windT));
-
-		glTranslatef(5.0, 0.0, 0.0);
-
-		stem.draw(angleSecondSegment);
+		const Sepal sepal{ hemisphereScaleFactor };
+		const Petal petal{ hemisphereScaleFactor, petalOpenAngle, petalAspectRatio };
 
-		glTranslatef(5.0, 0.0, 0.0);
+		// Every segment is 5 long, the flower head sits 7 after the last one
+		const auto segment = Mat4::translation({ 5.f, 0.f, 0.f });
+		const auto head = Mat4::translation({ 7.f, 0.f, 0.f });
 
-		leaf.draw(true, t);
-		leaf.draw(false, t);
+		hierarchy.setLocal(nodes.stems[0],
+			Mat4::translation(loc) * Mat4::rotation(rot.angle, rot.dirs) * Mat4::scaling(scale) *
+			Stem::getTransform(angleFirstSegment + RWind * sin(windT)));
 
-		stem.draw(angleThirdSegment);
+		hierarchy.setLocal(nodes.stems[1], segment * Stem::getTransform(angleSecondSegment));
 
-		glTranslatef(5.0, 0.0, 0.0);
-		stem.draw(angleFourthSegment);
+		hierarchy.setLocal(nodes.leaves[0], segment * Leaf::getTransform(true, t));
+		hierarchy.setLocal(nodes.leaves[1], segment * Leaf::getTransform(false, t));
 
-		glTranslatef(7.0, 0.0, 0.0);
-		sepal.draw();
+		hierarchy.setLocal(nodes.stems[2], segment * Stem::getTransform(angleThirdSegment));
+		hierarchy.setLocal(nodes.stems[3], segment * Stem::getTransform(angleFourthSegment));
 
-		petal.draw(30.f, petalColor);
-		petal.draw(90.f, petalColor);
-		petal.draw(150.f, petalColor);
-		petal.draw(210.f, petalColor);
-		petal.draw(270.f, petalColor);
-		petal.draw(330.f, petalColor);
+		hierarchy.setLocal(nodes.sepal, head * sepal.getTransform());
 
-		glPopMatrix();
+		const float petalAngles[] = { 30.f, 90.f, 150.f, 210.f, 270.f, 330.f };
+		for (int i{}; i < 6; ++i)
+			hierarchy.setLocal(nodes.petals[i], head * petal.getTransform(petalAngles[i]));
 	}
 };
 
 std::vector<Flower> flowers;
+// The petals of every flower, refilled every frame
+Instancing::Batch petals;
+std::vector<Instancing::Instance> petalInstances;
 
 void initFlowers()
 {
@@ -431,16 +438,27 @@ void tick()
 void drawScene(void)
 {
 	glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-	glLoadIdentity();
-	glTranslatef(0.0, -10.0, -30.0);
-
 	glPolygonMode(GL_FRONT_AND_BACK, GL_LINE);
-	glRotatef(Zangle, 0.0, 0.0, 1.0);
-	glRotatef(Yangle, 0.0, 1.0, 0.0);
-	glRotatef(Xangle, 1.0, 0.0, 0.0);
 
 	tick();
 
+	hierarchy.evaluate(
+		Mat4::translation({ 0.f, -10.f, -30.f }) *
+		Mat4::rotation(Zangle, { 0.f, 0.f, 1.f }) *
+		Mat4::rotation(Yangle, { 0.f, 1.f, 0.f }) *
+		Mat4::rotation(Xangle, { 1.f, 0.f, 0.f }));
+
+	petalInstances.clear();
+	for (const auto& flower : flowers)
+	{
+		flower.draw();
+		flower.appendPetals(petalInstances);
+	}
+
+	petals.setInstances(petalInstances);
+	glLoadIdentity();
+	petals.draw();
+
 	glutSwapBuffers();
 }
 
@@ -467,6 +485,7 @@ void setup(void)
 {
 	glClearColor(1.0, 1.0, 1.0, 0.0);
 	glEnable(GL_DEPTH_TEST);
+	Petal::setMesh(petals);
 	initFlowers();
 }
 
@@ -488,6 +507,7 @@ void keyInput(unsigned char key, int x, int y)
 	case 127:
 		if (isAnimate) isAnimate = 0;
 		flowers.clear();
+		hierarchy.clear();
 		initFlowers();
 		glutPostRedisplay();
 		break;
@@ -559,4 +579,6 @@ int main(int argc, char** argv)
 
 	return 0;
 }
+
+	static SceneRegistry::Registrar registrar{ { "AnimatedGarden", main, setup, drawScene, resize, keyInput } };
 }
\ No newline at end of file
@@ -0,0 +1,121 @@
+#pragma once
+///////////////////////////////////////////////////////////////////////////////////////
+// Points on circles and arcs without a cos/sin call per vertex.
+//
+// The points come from a rotation recurrence: four consecutive angles sit in the
+// lanes of an SSE register and every step rotates all of them by four angle steps
+// at once. Every block of blockSize points is seeded again with exact cos/sin, so
+// the rounding error of the recurrence never grows past a few float ulps.
+///////////////////////////////////////////////////////////////////////////////////////
+
+#define _USE_MATH_DEFINES
+
+#include <cmath>
+#include <vector>
+#include <algorithm>
+#include "SimdMath.h"
+
+namespace ArcGenerator
+{
+	using SimdMath::Vec3;
+
+	// Points between two exact seeds, a multiple of four
+	constexpr int blockSize = 64;
+
+	namespace Detail
+	{
+		// cos/sin of start + step * i for i in [0, n), n <= blockSize,
+		// the arrays must hold blockSize floats
+		inline void unitBlock(double start, double step, int n, float* cosines, float* sines)
+		{
+#if SIMDMATH_SSE
+			alignas(16) float seedCos[4];
+			alignas(16) float seedSin[4];
+
+			for(int i{}; i < 4; ++i)
+			{
+				seedCos[i] = static_cast<float>(std::cos(start + step * i));
+				seedSin[i] = static_cast<float>(std::sin(start + step * i));
+			}
+
+			auto c = _mm_load_ps(seedCos);
+			auto s = _mm_load_ps(seedSin);
+			const auto stepCos = _mm_set1_ps(static_cast<float>(std::cos(step * 4)));
+			const auto stepSin = _mm_set1_ps(static_cast<float>(std::sin(step * 4)));
+
+			for(int i{}; i < n; i += 4)
+			{
+				_mm_storeu_ps(cosines + i, c);
+				_mm_storeu_ps(sines + i, s);
+
+				const auto nextC = _mm_sub_ps(_mm_mul_ps(c, stepCos), _mm_mul_ps(s, stepSin));
+				s = _mm_add_ps(_mm_mul_ps(s, stepCos), _mm_mul_ps(c, stepSin));
+				c = nextC;
+			}
+#else
+			auto c = static_cast<float>(std::cos(start));
+			auto s = static_cast<float>(std::sin(start));
+			const auto stepCos = static_cast<float>(std::cos(step));
+			const auto stepSin = static_cast<float>(std::sin(step));
+
+			for(int i{}; i < n; ++i)
+			{
+				cosines[i] = c;
+				sines[i] = s;
+
+				const auto nextC = c * stepCos - s * stepSin;
+				s = s * stepCos + c * stepSin;
+				c = nextC;
+			}
+#endif
+		}
+	}
+
+	// Calls emit(cos(t), sin(t)) for the N + 1 angles from startAngle to endAngle (radians)
+	template<typename Emit>
+	void forEachPoint(float startAngle, float endAngle, int N, Emit emit)
+	{
+		if(N <= 0)
+		{
+			emit(std::cos(startAngle), std::sin(startAngle));
+			return;
+		}
+
+		const double step = (static_cast<double>(endAngle) - startAngle) / N;
+
+		alignas(16) float cosines[blockSize];
+		alignas(16) float sines[blockSize];
+
+		for(int first{}; first <= N; first += blockSize)
+		{
+			const auto n = std::min(blockSize, N + 1 - first);
+			Detail::unitBlock(startAngle + step * first, step, n, cosines, sines);
+
+			for(int i{}; i < n; ++i)
+				emit(cosines[i], sines[i]);
+		}
+	}
+
+	// Appends the N + 1 points center + R * (cos(t), sin(t), 0) from startAngle to endAngle
+	inline void appendArcPoints(std::vector<Vec3>& points, const Vec3& center, float R, float startAngle, float endAngle, int N)
+	{
+		points.reserve(points.size() + std::max(N, 0) + 1);
+
+		forEachPoint(startAngle, endAngle, N, [&](float c, float s) {
+			points.emplace_back(center.X + R * c, center.Y + R * s, center.Z);
+		});
+	}
+
+	inline std::vector<Vec3> getArcPoints(const Vec3& center, float R, float startAngle, float endAngle, int N)
+	{
+		std::vector<Vec3> points;
+		appendArcPoints(points, center, R, startAngle, endAngle, N);
+		return points;
+	}
+
+	// N + 1 points, the last one closes the circle on the first
+	inline std::vector<Vec3> getCirclePoints(const Vec3& center, float R, int N)
+	{
+		return getArcPoints(center, R, 0.f, static_cast<float>(2 * M_PI), N);
+	}
+}
@@ -1,12 +1,17 @@
+#pragma once
 
 #define _USE_MATH_DEFINES
 
 #include <GL/glew.h>
 #include <GL/freeglut.h> 
+#include "SceneRegistry.h"
+#include "Primitives.h"
+#include "SimdMath.h"
+#include "FrameClock.h"
 #include <iostream>
+#include <cmath>
 #include <vector>
 #include <functional>
-#include <chrono>
 #include <map>
 #include <memory>
 
@@ -16,80 +21,15 @@ namespace BallBouncingUp
 	static int animationPeriod = 25;
 	static float deltaTime;
 	static float t;
-	std::chrono::system_clock::time_point tp;
+	FrameClock::Stopwatch stopwatch;
 
-	struct Vector
-	{
-		Vector(float pX = 0.f, float pY = 0.f, float pZ = 0.f)
-			:
-			X{ pX },
-			Y{ pY },
-			Z{ pZ }
-		{
-
-		}
-
-		float length() const noexcept
-		{
-			return std::sqrt(X * X + Y * Y + Z * Z);
-		}
-
-		Vector& operator+=(const Vector& rhs) noexcept
-		{
-			return *this = *this + rhs;;
-		}
-
-		Vector& operator-=(const Vector& rhs) noexcept
-		{
-			return *this = *this - rhs;;
-		}
-
-		Vector operator+(const Vector& rhs) const noexcept
-		{
-			return { X + rhs.X, Y + rhs.Y, Z + rhs.Z };
-		}
-
-		Vector operator-(const Vector& rhs) const noexcept
-		{
-			return { X - rhs.X, Y - rhs.Y, Z - rhs.Z };
-		}
-
-		Vector operator*(float v) const noexcept
-		{
-			return { X * v, Y * v, Z * v };
-		}
-
-		Vector& operator*=(float v) noexcept
-		{
-			return *this = *this * v;
-		}
-
-		float X;
-		float Y;
-		float Z;
-	};
+	using Vector = SimdMath::Vec3;
 
 	bool isNearlyEqual(float a, float b, float e)
 	{
 		return (a - b) < e;
 	}
 
-	Vector normalize(const Vector& v)
-	{
-		return { v.X / v.length(), v.Y / v.length(), v.Z / v.length() };
-	}
-
-	Vector operator* (float lhs, const Vector& rhs)
-	{
-		return rhs * lhs;
-	}
-
-	std::ostream& operator<<(std::ostream& os, const Vector& v)
-	{
-		os << "X: " << v.X << " Y: " << v.Y << " Z: " << v.Z;
-		return os;
-	}
-
 	struct Rotation
 	{
 		Rotation(float pAngle = 0, const Vector& pDirs = Vector{})
@@ -186,7 +126,7 @@ namespace BallBouncingUp
 			
 			glTranslated(loc.X, loc.Y, loc.Z);
 			glScaled(scale.X, scale.Y, scale.Z);
-			glutWireCube(10.f);
+			Primitives::drawWireCube(10.f);
 
 			glPopMatrix();
 		}
@@ -249,7 +189,7 @@ namespace BallBouncingUp
 			
 			glScaled(scale.X, scale.Y, scale.Z);
 			glColor3d(1.0, 0.0, 0.0);
-			glutWireSphere(radius, 20, 20);
+			Primitives::drawWireSphere(radius, 20, 20);
 			glPopMatrix();
 		}
 	};
@@ -292,14 +232,10 @@ namespace BallBouncingUp
 
 	void drawScene(void)
 	{
-		using namespace std::chrono;
-
 		glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 		glLoadIdentity();
 
-		auto d = duration_cast<milliseconds>(system_clock::now() - tp);
-		deltaTime = float(d.count()) * milliseconds::period::num / milliseconds::period::den;
-		tp = system_clock::now();
+		deltaTime = stopwatch.tick();
 
 		tick(deltaTime);
 		glutSwapBuffers();
@@ -335,7 +271,7 @@ namespace BallBouncingUp
 	{
 		glClearColor(1.0, 1.0, 1.0, 0.0);
 		glEnable(GL_DEPTH_TEST);
-		tp = std::chrono::system_clock::now();
+		stopwatch.reset();
 		initActors();
 	}
 
@@ -367,7 +303,7 @@ namespace BallBouncingUp
 
 			if (isAnimate)
 			{
-				tp = std::chrono::system_clock::now();
+				stopwatch.reset();
 				animate(1);
 			}
 			break;
@@ -412,4 +348,6 @@ namespace BallBouncingUp
 
 		return 0;
 	}
+
+	static SceneRegistry::Registrar registrar{ { "BallBouncingUp", main, setup, drawScene, resize, keyInput } };
 }
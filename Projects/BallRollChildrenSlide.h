@@ -1,12 +1,17 @@
+#pragma once
 
 #define _USE_MATH_DEFINES
 
 #include <GL/glew.h>
 #include <GL/freeglut.h> 
+#include "SceneRegistry.h"
+#include "Primitives.h"
+#include "SimdMath.h"
+#include "FrameClock.h"
 #include <iostream>
+#include <cmath>
 #include <vector>
 #include <functional>
-#include <chrono>
 #include <map>
 #include <memory>
 
@@ -16,75 +21,15 @@ namespace BallRollChildrenSlide
 	static int animationPeriod = 25;
 	static float g = 15.81f;
 	static float deltaTime;
-	std::chrono::system_clock::time_point tp;
+	FrameClock::Stopwatch stopwatch;
 
-	struct Vector
-	{
-		Vector(float pX = 0.f, float pY = 0.f, float pZ = 0.f)
-			:
-			X{ pX },
-			Y{ pY },
-			Z{ pZ }
-		{
-
-		}
-
-		float length() const noexcept
-		{
-			return std::sqrt(X * X + Y * Y + Z * Z);
-		}
-
-		Vector& operator+=(const Vector& rhs) noexcept
-		{
-			return *this = *this + rhs;;
-		}
-
-		Vector& operator-=(const Vector& rhs) noexcept
-		{
-			return *this = *this - rhs;;
-		}
-
-		Vector operator+(const Vector& rhs) const noexcept
-		{
-			return { X + rhs.X, Y + rhs.Y, Z + rhs.Z };
-		}
-
-		Vector operator-(const Vector& rhs) const noexcept
-		{
-			return { X - rhs.X, Y - rhs.Y, Z - rhs.Z };
-		}
-
-		Vector operator*(float v) const noexcept
-		{
-			return { X * v, Y * v, Z * v };
-		}
-
-		float X;
-		float Y;
-		float Z;
-	};
+	using Vector = SimdMath::Vec3;
 
 	bool isNearlyEqual(float a, float b, float e)
 	{
 		return (a - b) < e;
 	}
 
-	Vector normalize(const Vector& v)
-	{
-		return { v.X / v.length(), v.Y / v.length(), v.Z / v.length() };
-	}
-
-	Vector operator* (float lhs, const Vector& rhs)
-	{
-		return rhs * lhs;
-	}
-
-	std::ostream& operator<<(std::ostream& os, const Vector& v)
-	{
-		os << "X: " << v.X << " Y: " << v.Y << " Z: " << v.Z;
-		return os;
-	}
-
 	struct Rotation
 	{
 		Rotation(float pAngle = 0, const Vector& pDirs = Vector{})
@@ -310,7 +255,9 @@ namespace BallRollChildrenSlide
 
 			// -3 cause we don't include first pair, last exist pair and last imaginary pair(it doesn't exist)
 			for (int i = 0, j = 2; i < (verticies.size() / 2 - 3); ++i, j += 2)
-				dirs.push_back(normalize(verticies[j + 2] - verticies[j]));
+				dirs.push_back(verticies[j + 2] - verticies[j]);
+
+			SimdMath::normalize(dirs);
 			
 			dir = dirs[0];
 		}
@@ -511,7 +458,7 @@ namespace BallRollChildrenSlide
 
 			glScaled(scale.X, scale.Y, scale.Z);
 			glColor3d(1.0, 0.0, 0.0);
-			glutWireSphere(radius, 20, 20);
+			Primitives::drawWireSphere(radius, 20, 20);
 			glPopMatrix();
 		}
 
@@ -551,14 +498,10 @@ namespace BallRollChildrenSlide
 
 	void drawScene(void)
 	{
-		using namespace std::chrono;
-
 		glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 		glLoadIdentity();
 
-		auto d = duration_cast<milliseconds>(system_clock::now() - tp);
-		deltaTime = float(d.count()) * milliseconds::period::num / milliseconds::period::den;
-		tp = system_clock::now();
+		deltaTime = stopwatch.tick();
 
 		tick(deltaTime);
 		glutSwapBuffers();
@@ -603,7 +546,7 @@ namespace BallRollChildrenSlide
 	{
 		glClearColor(1.0, 1.0, 1.0, 0.0);
 		glEnable(GL_DEPTH_TEST);
-		tp = std::chrono::system_clock::now();
+		stopwatch.reset();
 		initActors();
 	}
 
@@ -635,7 +578,7 @@ namespace BallRollChildrenSlide
 
 			if (isAnimate)
 			{
-				tp = std::chrono::system_clock::now();
+				stopwatch.reset();
 				animate(1);
 			}
 			break;
@@ -680,4 +623,6 @@ namespace BallRollChildrenSlide
 
 		return 0;
 	}
+
+	static SceneRegistry::Registrar registrar{ { "BallRollChildrenSlide", main, setup, drawScene, resize, keyInput } };
 }
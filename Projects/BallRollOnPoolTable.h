@@ -1,12 +1,17 @@
+#pragma once
 
 #define _USE_MATH_DEFINES
 
 #include <GL/glew.h>
 #include <GL/freeglut.h> 
+#include "SceneRegistry.h"
+#include "Primitives.h"
+#include "SimdMath.h"
+#include "FrameClock.h"
 #include <iostream>
+#include <cmath>
 #include <vector>
 #include <functional>
-#include <chrono>
 #include <map>
 #include <memory>
 
@@ -16,7 +21,7 @@ namespace BallRollOnPoolTable
 	static int animationPeriod = 25;
 	static float deltaTime;
 	static float angleZInclinedPlane;
-	std::chrono::system_clock::time_point tp;
+	FrameClock::Stopwatch stopwatch;
 
 	static float Xangle = 0.0, Yangle = 0.0, Zangle = 0.0;
 	static int width = 500;
@@ -27,56 +32,7 @@ namespace BallRollOnPoolTable
 	static float minZ;
 	static float maxZ;
 
-	struct Vector
-	{
-		Vector(float pX = 0.f, float pY = 0.f, float pZ = 0.f)
-			:
-			X{ pX },
-			Y{ pY },
-			Z{ pZ }
-		{
-
-		}
-
-		float length() const noexcept
-		{
-			return std::sqrt(X * X + Y * Y + Z * Z);
-		}
-
-		Vector& operator+=(const Vector& rhs) noexcept
-		{
-			return *this = *this + rhs;;
-		}
-
-		Vector& operator-=(const Vector& rhs) noexcept
-		{
-			return *this = *this - rhs;;
-		}
-
-		Vector operator+(const Vector& rhs) const noexcept
-		{
-			return { X + rhs.X, Y + rhs.Y, Z + rhs.Z };
-		}
-
-		Vector operator-(const Vector& rhs) const noexcept
-		{
-			return { X - rhs.X, Y - rhs.Y, Z - rhs.Z };
-		}
-
-		Vector operator*(float v) const noexcept
-		{
-			return { X * v, Y * v, Z * v };
-		}
-
-		float X;
-		float Y;
-		float Z;
-	};
-
-	Vector normalize(const Vector& v)
-	{
-		return { v.X / v.length(), v.Y / v.length(), v.Z / v.length() };
-	}
+	using Vector = SimdMath::Vec3;
 
 	bool inRange(float min, float max, float v)
 	{
@@ -103,12 +59,6 @@ namespace BallRollOnPoolTable
 		return (a - b) < e;
 	}
 
-	std::ostream& operator<<(std::ostream& os, const Vector& v)
-	{
-		os << "X: " << v.X << " Y: " << v.Y << " Z: " << v.Z;
-		return os;
-	}
-
 	struct Rotation
 	{
 		Rotation(float pAngle = 0, const Vector& pDirs = Vector{})
@@ -197,7 +147,7 @@ namespace BallRollOnPoolTable
 			glRotated(rot.angle, rot.dirs.X, rot.dirs.Y, rot.dirs.Z);
 			glScaled(scale.X, scale.Y, scale.Z);
 
-			glutWireCube(size);
+			Primitives::drawWireCube(size);
 			glPopMatrix();
 		}
 
@@ -390,7 +340,7 @@ namespace BallRollOnPoolTable
 
 			glScaled(scale.X, scale.Y, scale.Z);
 			glColor3d(1.0, 0.0, 0.0);
-			glutWireSphere(radius, 20, 20);
+			Primitives::drawWireSphere(radius, 20, 20);
 			glPopMatrix();
 		}
 
@@ -632,14 +582,10 @@ namespace BallRollOnPoolTable
 
 	void drawScene(void)
 	{
-		using namespace std::chrono;
-
 		glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 		glLoadIdentity();
 
-		auto d = duration_cast<milliseconds>(system_clock::now() - tp);
-		deltaTime = float(d.count()) * milliseconds::period::num / milliseconds::period::den;
-		tp = system_clock::now();
+		deltaTime = stopwatch.tick();
 
 		tick(deltaTime);
 		glutSwapBuffers();
@@ -730,7 +676,7 @@ namespace BallRollOnPoolTable
 		glClearColor(1.0, 1.0, 1.0, 0.0);
 		glEnable(GL_DEPTH_TEST);
 		initActors();
-		tp = std::chrono::system_clock::now();
+		stopwatch.reset();
 		animate(1);
 	}
 
@@ -848,4 +794,6 @@ namespace BallRollOnPoolTable
 
 		return 0;
 	}
+
+	static SceneRegistry::Registrar registrar{ { "BallRollOnPoolTable", main, setup, drawScene, resize, keyInput } };
 }
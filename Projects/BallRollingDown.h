@@ -1,12 +1,16 @@
+#pragma once
 
 #define _USE_MATH_DEFINES
 
 #include <GL/glew.h>
 #include <GL/freeglut.h> 
+#include "SceneRegistry.h"
+#include "Primitives.h"
+#include "SimdMath.h"
+#include "FrameClock.h"
 #include <iostream>
 #include <vector>
 #include <functional>
-#include <chrono>
 #include <map>
 #include <memory>
 #include <cmath>
@@ -20,65 +24,15 @@ namespace BallRollingDown
 	static float angleZInclinedPlane;
 	static int height = 500;
 	static int width = 1000;
-	std::chrono::system_clock::time_point tp;
+	FrameClock::Stopwatch stopwatch;
 
-	struct Vector
-	{
-		Vector(float pX = 0.f, float pY = 0.f, float pZ = 0.f)
-			:
-			X{ pX },
-			Y{ pY },
-			Z{ pZ }
-		{
-
-		}
-
-		float length() const noexcept
-		{
-			return std::sqrt(X * X + Y * Y + Z * Z);
-		}
-
-		Vector& operator+=(const Vector& rhs) noexcept
-		{
-			return *this = *this + rhs;;
-		}
-
-		Vector& operator-=(const Vector& rhs) noexcept
-		{
-			return *this = *this - rhs;;
-		}
-
-		Vector operator+(const Vector& rhs) const noexcept
-		{
-			return { X + rhs.X, Y + rhs.Y, Z + rhs.Z };
-		}
-
-		Vector operator-(const Vector& rhs) const noexcept
-		{
-			return { X - rhs.X, Y - rhs.Y, Z - rhs.Z };
-		}
-
-		Vector operator*(float v) const noexcept
-		{
-			return { X * v, Y * v, Z * v };
-		}
-
-		float X;
-		float Y;
-		float Z;
-	};
+	using Vector = SimdMath::Vec3;
 
 	bool isNearlyEqual(float a, float b, float e)
 	{
 		return (a - b) < e;
 	}
 
-	std::ostream& operator<<(std::ostream& os, const Vector& v)
-	{
-		os << "X: " << v.X << " Y: " << v.Y << " Z: " << v.Z;
-		return os;
-	}
-
 	struct Rotation
 	{
 		Rotation(float pAngle = 0, const Vector& pDirs = Vector{})
@@ -522,7 +476,7 @@ namespace BallRollingDown
 
 			glScaled(scale.X, scale.Y, scale.Z);
 			glColor3d(1.0, 0.0, 0.0);
-			glutWireSphere(radius, 20, 20);
+			Primitives::drawWireSphere(radius, 20, 20);
 			glPopMatrix();
 		}
 
@@ -603,14 +557,10 @@ namespace BallRollingDown
 
 	void drawScene(void)
 	{
-		using namespace std::chrono;
-
 		glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 		glLoadIdentity();
 
-		auto d = duration_cast<milliseconds>(system_clock::now() - tp);
-		deltaTime = float(d.count()) * milliseconds::period::num / milliseconds::period::den;
-		tp = system_clock::now();
+		deltaTime = stopwatch.tick();
 
 		glPushMatrix();
 		glViewport(0, 0, width / 2, height);
@@ -696,7 +646,7 @@ namespace BallRollingDown
 	{
 		glClearColor(1.0, 1.0, 1.0, 0.0);
 		glEnable(GL_DEPTH_TEST);
-		tp = std::chrono::system_clock::now();
+		stopwatch.reset();
 		initActors();
 		
 		const auto& inclinedPlane = getInclinedPlaneForSure();
@@ -753,7 +703,7 @@ namespace BallRollingDown
 
 			if (isAnimate)
 			{
-				tp = std::chrono::system_clock::now();
+				stopwatch.reset();
 				animate(1);
 			}
 			break;
@@ -814,4 +764,6 @@ namespace BallRollingDown
 
 		return 0;
 	}
+
+	static SceneRegistry::Registrar registrar{ { "BallRollingDown", main, setup, drawScene, resize, keyInput } };
 }
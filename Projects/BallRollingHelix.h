@@ -1,12 +1,18 @@
+#pragma once
 
 #define _USE_MATH_DEFINES
 
 #include <GL/glew.h>
 #include <GL/freeglut.h> 
+#include "SceneRegistry.h"
+#include "Primitives.h"
+#include "SimdMath.h"
+#include "FrameClock.h"
+#include "ParametricSurface.h"
 #include <iostream>
+#include <cmath>
 #include <vector>
 #include <functional>
-#include <chrono>
 #include <map>
 #include <memory>
 
@@ -15,70 +21,15 @@ namespace BallRollingHelix
 	static bool isAnimate;
 	static int animationPeriod = 25;
 	static float deltaTime;
-	std::chrono::system_clock::time_point tp;
+	FrameClock::Stopwatch stopwatch;
 
-	struct Vector
-	{
-		Vector(float pX = 0.f, float pY = 0.f, float pZ = 0.f)
-			:
-			X{ pX },
-			Y{ pY },
-			Z{ pZ }
-		{
-
-		}
-
-		float length() const noexcept
-		{
-			return std::sqrt(X * X + Y * Y + Z * Z);
-		}
-
-		Vector& operator+=(const Vector& rhs) noexcept
-		{
-			return *this = *this + rhs;;
-		}
-
-		Vector& operator-=(const Vector& rhs) noexcept
-		{
-			return *this = *this - rhs;;
-		}
-
-		Vector operator+(const Vector& rhs) const noexcept
-		{
-			return { X + rhs.X, Y + rhs.Y, Z + rhs.Z };
-		}
-
-		Vector operator-(const Vector& rhs) const noexcept
-		{
-			return { X - rhs.X, Y - rhs.Y, Z - rhs.Z };
-		}
-
-		Vector operator*(float v) const noexcept
-		{
-			return { X * v, Y * v, Z * v };
-		}
-
-		float X;
-		float Y;
-		float Z;
-	};
-
-	Vector normalize(const Vector& v)
-	{
-		return { v.X / v.length(), v.Y / v.length(), v.Z / v.length() };
-	}
+	using Vector = SimdMath::Vec3;
 
 	bool isNearlyEqual(float a, float b, float e)
 	{
 		return (a - b) < e;
 	}
 
-	std::ostream& operator<<(std::ostream& os, const Vector& v)
-	{
-		os << "X: " << v.X << " Y: " << v.Y << " Z: " << v.Z;
-		return os;
-	}
-
 	struct Rotation
 	{
 		Rotation(float pAngle = 0, const Vector& pDirs = Vector{})
@@ -140,7 +91,9 @@ namespace BallRollingHelix
 			std::vector<Vector> r;
 
 			for (int i = 0; i < vertexVector.size() - 1; ++i)
-				r.push_back(normalize(vertexVector[i + 1] - vertexVector[i]));
+				r.push_back(vertexVector[i + 1] - vertexVector[i]);
+
+			SimdMath::normalize(r);
 			
 			return r;
 		}
@@ -178,26 +131,16 @@ namespace BallRollingHelix
 			const auto ZOffset = -5.f;
 			const auto Circles = 5;
 
-			std::vector<Vector> v;
-			v.reserve(Circles * (N + 1));
+			// Every circle is a row of the grid and starts on the point the previous one ended on
+			vertexVector = ParametricSurface::evaluate(N, Circles - 1, [&](int i, int j) {
+				const float t = 2 * M_PI * (j * (N + 1) + i) / N;
 
-			float t{};
-			for (int i = 0; i < Circles; ++i)
-			{
-				for (int j = 0; j <= N; ++j)
-				{
-					v.push_back({
+				return Vector{
 					circleCenter.X + R * cos(t),
 					circleCenter.Y + R * sin(t),
-					circleCenter.Z + ZOffset * i + ZOffset * j / N }
-					);
-
-					t += 2 * M_PI / N;
-				}
-			}
-
-			v.shrink_to_fit();
-			vertexVector = std::move(v);
+					circleCenter.Z + ZOffset * j + ZOffset * i / N
+				};
+			});
 		}
 
 	};
@@ -382,7 +325,7 @@ namespace BallRollingHelix
 
 				glScaled(scale.X, scale.Y, scale.Z);
 				glColor3d(1.0, 0.0, 0.0);
-				glutWireSphere(radius, 20, 20);
+				Primitives::drawWireSphere(radius, 20, 20);
 
 				glPopMatrix();
 
@@ -428,14 +371,10 @@ namespace BallRollingHelix
 
 	void drawScene(void)
 	{
-		using namespace std::chrono;
-
 		glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 		glLoadIdentity();
 
-		auto d = duration_cast<milliseconds>(system_clock::now() - tp);
-		deltaTime = float(d.count()) * milliseconds::period::num / milliseconds::period::den;
-		tp = system_clock::now();
+		deltaTime = stopwatch.tick();
 
 		tick(deltaTime);
 		glutSwapBuffers();
@@ -469,7 +408,7 @@ namespace BallRollingHelix
 	{
 		glClearColor(1.0, 1.0, 1.0, 0.0);
 		glEnable(GL_DEPTH_TEST);
-		tp = std::chrono::system_clock::now();
+		stopwatch.reset();
 		initActors();
 	}
 
@@ -495,7 +434,7 @@ namespace BallRollingHelix
 
 			if (isAnimate)
 			{
-				tp = std::chrono::system_clock::now();
+				stopwatch.reset();
 				animate(1);
 			}
 			break;
@@ -540,4 +479,6 @@ namespace BallRollingHelix
 
 		return 0;
 	}
+
+	static SceneRegistry::Registrar registrar{ { "BallRollingHelix", main, setup, drawScene, resize, keyInput } };
 }
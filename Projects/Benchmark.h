@@ -0,0 +1,147 @@
+#pragma once
+///////////////////////////////////////////////////////////////////////////////////////
+// Frame-time statistics and CSV/JSON reports for the benchmark mode of the
+// headless launcher.
+///////////////////////////////////////////////////////////////////////////////////////
+
+#include <cmath>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <ostream>
+#include <iomanip>
+#include <algorithm>
+
+namespace Benchmark
+{
+	struct Sample
+	{
+		double cpuMs;
+		double totalMs;
+		std::uint64_t drawCalls;
+		std::uint64_t allocations;
+	};
+
+	struct Percentiles
+	{
+		double p50;
+		double p95;
+		double p99;
+		double max;
+		double mean;
+	};
+
+	struct Summary
+	{
+		std::string scene;
+		int frames;
+		Percentiles cpuMs;
+		Percentiles totalMs;
+		Percentiles drawCalls;
+		Percentiles allocations;
+	};
+
+	// Nearest-rank percentiles, so every reported value is a frame that really happened
+	inline Percentiles getPercentiles(std::vector<double> values)
+	{
+		if(values.empty())
+			return {};
+
+		std::sort(values.begin(), values.end());
+
+		const auto at = [&values](double p) {
+			const auto rank = static_cast<std::size_t>(std::ceil(p * values.size()));
+			return values[std::min(values.size(), std::max<std::size_t>(rank, 1)) - 1];
+		};
+
+		double sum{};
+		for(const auto v : values)
+			sum += v;
+
+		return { at(0.50), at(0.95), at(0.99), values.back(), sum / values.size() };
+	}
+
+	template<typename Getter>
+	Percentiles getPercentiles(const std::vector<Sample>& samples, Getter getter)
+	{
+		std::vector<double> values;
+		values.reserve(samples.size());
+
+		for(const auto& sample : samples)
+			values.push_back(static_cast<double>(getter(sample)));
+
+		return getPercentiles(std::move(values));
+	}
+
+	inline Summary summarize(const std::string& scene, const std::vector<Sample>& samples)
+	{
+		return {
+			scene,
+			static_cast<int>(samples.size()),
+			getPercentiles(samples, [](const Sample& s) { return s.cpuMs; }),
+			getPercentiles(samples, [](const Sample& s) { return s.totalMs; }),
+			getPercentiles(samples, [](const Sample& s) { return s.drawCalls; }),
+			getPercentiles(samples, [](const Sample& s) { return s.allocations; })
+		};
+	}
+
+	inline void writeCsv(std::ostream& os, const std::vector<Summary>& summaries)
+	{
+		os << "scene,frames";
+		for(const auto metric : { "cpu_ms", "total_ms", "draw_calls", "allocations" })
+		{
+			for(const auto stat : { "p50", "p95", "p99", "max", "mean" })
+				os << ',' << metric << '_' << stat;
+		}
+		os << '\n';
+
+		os << std::fixed << std::setprecision(4);
+		for(const auto& s : summaries)
+		{
+			os << s.scene << ',' << s.frames;
+			for(const auto& p : { s.cpuMs, s.totalMs, s.drawCalls, s.allocations })
+				os << ',' << p.p50 << ',' << p.p95 << ',' << p.p99 << ',' << p.max << ',' << p.mean;
+			os << '\n';
+		}
+	}
+
+	inline void writeJson(std::ostream& os, const std::vector<Summary>& summaries)
+	{
+		const auto writePercentiles = [&os](const char* name, const Percentiles& p, bool last) {
+			os << "    \"" << name << "\": { \"p50\": " << p.p50 << ", \"p95\": " << p.p95
+				<< ", \"p99\": " << p.p99 << ", \"max\": " << p.max << ", \"mean\": " << p.mean << " }"
+				<< (last ? "\n" : ",\n");
+		};
+
+		os << std::fixed << std::setprecision(4) << "[\n";
+		for(std::size_t i{}; i < summaries.size(); ++i)
+		{
+			const auto& s = summaries[i];
+
+			os << "  {\n";
+			os << "    \"scene\": \"" << s.scene << "\",\n";
+			os << "    \"frames\": " << s.frames << ",\n";
+			writePercentiles("cpu_ms", s.cpuMs, false);
+			writePercentiles("total_ms", s.totalMs, false);
+			writePercentiles("draw_calls", s.drawCalls, false);
+			writePercentiles("allocations", s.allocations, true);
+			os << (i + 1 == summaries.size() ? "  }\n" : "  },\n");
+		}
+		os << "]\n";
+	}
+
+	inline void writeTable(std::ostream& os, const std::vector<Summary>& summaries)
+	{
+		os << std::left << std::setw(30) << "scene" << std::right
+			<< std::setw(10) << "p50 ms" << std::setw(10) << "p95 ms" << std::setw(10) << "p99 ms"
+			<< std::setw(10) << "max ms" << std::setw(12) << "draws/frm" << std::setw(12) << "allocs/frm" << '\n';
+
+		os << std::fixed << std::setprecision(3);
+		for(const auto& s : summaries)
+		{
+			os << std::left << std::setw(30) << s.scene << std::right
+				<< std::setw(10) << s.cpuMs.p50 << std::setw(10) << s.cpuMs.p95 << std::setw(10) << s.cpuMs.p99
+				<< std::setw(10) << s.cpuMs.max << std::setw(12) << s.drawCalls.mean << std::setw(12) << s.allocations.mean << '\n';
+		}
+	}
+}
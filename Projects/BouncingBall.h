@@ -1,12 +1,16 @@
+#pragma once
 #include <cmath>
 #include <cstdlib>
 #include <iostream>
 #include <fstream>
 #include <GL/glew.h>
 #include <GL/freeglut.h> 
+#include "SceneRegistry.h"
+#include "Primitives.h"
+#include "SimdMath.h"
+#include "FrameClock.h"
 #include <vector>
 #include <functional>
-#include <chrono>
 #include <vector>
 #include <utility>
 #include <string>
@@ -20,60 +24,15 @@ namespace BouncingBall
 	static int animationPeriod = 25;
 	static float g = 10.1f;
 
-	std::chrono::system_clock::time_point tp;
+	FrameClock::Stopwatch stopwatch;
 
-	struct Vector
-	{
-		Vector(float pX = 0.f, float pY = 0.f, float pZ = 0.f)
-			:
-			X{pX},
-			Y{pY},
-			Z{pZ}
-		{
-			
-		}
-
-		float length() const noexcept
-		{
-			return std::sqrt(X * X + Y * Y + Z * Z);
-		}
-
-		Vector& operator+=(const Vector& rhs) noexcept
-		{
-			return *this = *this + rhs;;
-		}
-
-		Vector operator+(const Vector& rhs) const noexcept
-		{
-			return {X + rhs.X, Y + rhs.Y, Z + rhs.Z};
-		}
-
-		Vector operator*(float v) const noexcept
-		{
-			return { X * v, Y * v, Z * v};
-		}
-
-		float X;
-		float Y;
-		float Z;
-	};
-
-	Vector normalize(const Vector& v)
-	{
-		return { v.X / v.length(), v.Y / v.length(), v.Z / v.length() };
-	}
+	using Vector = SimdMath::Vec3;
 
 	bool isNearlyEqual(float a, float b, float e)
 	{
 		return (a - b) < e;
 	}
 
-	std::ostream& operator<<(std::ostream& os, const Vector& v)
-	{
-		os << "X: " << v.X << " Y: " << v.Y << " Z: " << v.Z;
-		return os;
-	}
-
 	struct Rotation
 	{
 		Rotation(float pAngle = 0, const Vector& pDirs = Vector{})
@@ -227,7 +186,7 @@ namespace BouncingBall
 			glPushMatrix();
 			glTranslated(loc.X, loc.Y, loc.Z);
 			glColor3d(1.0, 0.0, 0.0);
-			glutWireSphere(radius, 10, 10);
+			Primitives::drawWireSphere(radius, 10, 10);
 			glPopMatrix();
 		}
 
@@ -290,7 +249,7 @@ namespace BouncingBall
 			glRotated(rot.angle, rot.dirs.X, rot.dirs.Y, rot.dirs.Z);
 			glScaled(scale.X, scale.Y, scale.Z);
 
-			glutWireCube(size);
+			Primitives::drawWireCube(size);
 			glPopMatrix();
 		}
 
@@ -380,7 +339,7 @@ namespace BouncingBall
 			glRotated(rot.angle, rot.dirs.X, rot.dirs.Y, rot.dirs.Z);
 			glScaled(scale.X, scale.Y, scale.Z);
 
-			glutWireCube(size);
+			Primitives::drawWireCube(size);
 			glPopMatrix();
 		}
 
@@ -491,14 +450,10 @@ namespace BouncingBall
 
 	void drawScene(void)
 	{
-		using namespace std::chrono;
-
 		glClear(GL_COLOR_BUFFER_BIT);
 		glLoadIdentity();
 
-		auto d = duration_cast<milliseconds>(system_clock::now() - tp);
-		auto deltaTime = float(d.count()) * milliseconds::period::num / milliseconds::period::den;
-		tp = system_clock::now();
+		const auto deltaTime = stopwatch.tick();
 		
 		tick(deltaTime);
 		checkCollide();
@@ -553,7 +508,7 @@ namespace BouncingBall
 	void setup(void)
 	{
 		glClearColor(1.0, 1.0, 1.0, 0.0);
-		tp = std::chrono::system_clock::now();
+		stopwatch.reset();
 		initActors();
 	}
 
@@ -582,7 +537,7 @@ namespace BouncingBall
 			
 			if (isAnimate)
 			{
-				tp = std::chrono::system_clock::now();
+				stopwatch.reset();
 				animate(1);
 			}
 			break;
@@ -667,4 +622,6 @@ namespace BouncingBall
 
 		return 0;
 	}
+
+	static SceneRegistry::Registrar registrar{ { "BouncingBall", main, setup, drawScene, resize, keyInput } };
 }
@@ -1,3 +1,4 @@
+#pragma once
 ///////////////////////////////////////////////////////////////////////////////////////          
 //Example of Canvas here
 /////////////////////////////////////////////////////////////////////////////////////// 
@@ -9,6 +10,8 @@
 #include <iostream>
 #include <GL/glew.h>
 #include <GL/freeglut.h>
+#include "SceneRegistry.h"
+#include "LineBatch.h"
 
 namespace Canvas
 {
@@ -127,6 +130,14 @@ namespace Canvas
 			glewExperimental = GL_TRUE;
 			glewInit();
 
+			Setup(width, height);
+		}
+
+		void Setup(int pWidth, int pHeight)
+		{
+			width = pWidth;
+			height = pHeight;
+
 			SetWindow(0.f, width, 0.f, height);
 			SetViewport(0.f, width, 0.f, height);
 			CP.Set(0.f, 0.f);
@@ -134,6 +145,7 @@ namespace Canvas
 		
 		void SetWindow(float l, float r, float b, float t)
 		{
+			lines.flush();
 			glMatrixMode(GL_PROJECTION);
 			glLoadIdentity();
 			gluOrtho2D(l, r, b, t);
@@ -142,6 +154,7 @@ namespace Canvas
 
 		void SetViewport(int l, int r, int b, int t)
 		{
+			lines.flush();
 			viewport.Set(l, r, b, t);
 			glViewport(l, b, r - l, t - b);
 		}
@@ -166,6 +179,8 @@ namespace Canvas
 
 		void ClearScreen()
 		{
+			// The segments not drawn yet would be cleared anyway
+			lines.clear();
 			glClear(GL_COLOR_BUFFER_BIT);
 		}
 
@@ -177,18 +192,13 @@ namespace Canvas
 		void SetColor(float r, float g, float b)
 		{
 			glColor3f(r, g, b);
+			lines.setColor(r, g, b);
 		}
 
 		void LineTo(float x, float y)
 		{
-			glBegin(GL_LINES);
-				glVertex2f(CP.X, CP.Y);
-				glVertex2f(x, y);
-			glEnd();
-
+			lines.add(CP.X, CP.Y, x, y);
 			CP.Set(x, y);
-
-			glFlush();
 		}
 
 		void LineTo(const Point2& p)
@@ -196,6 +206,13 @@ namespace Canvas
 			LineTo(p.X, p.Y);
 		}		
 
+		// Draws the segments added since the last call
+		void Flush()
+		{
+			lines.flush();
+			glFlush();
+		}
+
 		void MoveTo(float x, float y)
 		{
 			CP.Set(x, y);
@@ -236,6 +253,7 @@ namespace Canvas
 		Point2 CP;
 		IntRect viewport;
 		FloatRect window;
+		LineBatch::Batch lines;
 		
 		float width;
 		float height;
@@ -276,6 +294,8 @@ namespace Canvas
 		cvs.MoveTo(cvs.GetScreenWidth() / 2, cvs.GetScreenHeight() / 2);
 		//Arrow(40.f, 20.f, 15.f, 15.f);
 		Star(20.f, 30.f, 20.f, 10.f);
+
+		cvs.Flush();
 	}
 
 	void printInteraction()
@@ -284,6 +304,13 @@ namespace Canvas
 	}
 
 	
+	void setup()
+	{
+		auto& cvs = Canvas::Get();
+		cvs.Setup(640, 480);
+		cvs.SetBackgroundColor(1.f, 1.f, 1.f);
+	}
+
 	int main(int argc, char** argv)
 	{
 		printInteraction();
@@ -298,4 +325,5 @@ namespace Canvas
 		return 0;
 	}
 
+	static SceneRegistry::Registrar registrar{ { "Canvas", main, setup, Display, Canvas::Resize, Canvas::KeyInput } };
 }
@@ -1,77 +1,36 @@
+#pragma once
+///////////////////////////////////////////////////////////////////////////////////////
+// This program draws a car and a camera flying around it
+//
+// Interaction:
+// Press space to toggle the wireframe.
+// Press +/- to widen or narrow the car.
+// Press the arrow keys to move the camera around the car.
+// Turn the mouse wheel to move the camera closer or further.
+///////////////////////////////////////////////////////////////////////////////////////
+
 #include <GL/glew.h>
 #include <GL/freeglut.h> 
+#include "SceneRegistry.h"
+#include "Primitives.h"
+#include "SimdMath.h"
+#include "ArcGenerator.h"
+#include "Shader.h"
+#include "GLContext.h"
 #include <iostream>
 #include <vector>
+#include <array>
 #include <cmath>
 #include <numeric>
 
 namespace Car3D
 {
-	struct Vector
-	{
-	Vector(float pX = 0.f, float pY = 0.f, float pZ = 0.f)
-		:
-		X{ pX },
-		Y{ pY },
-		Z{ pZ }
-	{
-
-	}
-
-	float length() const noexcept
-	{
-		return std::sqrt(X * X + Y * Y + Z * Z);
-	}
-
-	Vector& operator+=(const Vector& rhs) noexcept
-	{
-		return *this = *this + rhs;;
-	}
-
-	Vector& operator-=(const Vector& rhs) noexcept
-	{
-		return *this = *this - rhs;;
-	}
-
-	Vector operator+(const Vector& rhs) const noexcept
-	{
-		return { X + rhs.X, Y + rhs.Y, Z + rhs.Z };
-	}
-
-	Vector operator-(const Vector& rhs) const noexcept
-	{
-		return { X - rhs.X, Y - rhs.Y, Z - rhs.Z };
-	}
-
-	Vector operator*(float v) const noexcept
-	{
-		return { X * v, Y * v, Z * v };
-	}
-
-	bool operator==(const Vector& rhs) const noexcept
-	{
-		return (X == rhs.X) && (Y == rhs.Y) && (Z == rhs.Z);
-	}
-
-	bool operator!=(const Vector& rhs) const noexcept
-	{
-		return !(*this == rhs);
-	}
+	using Vector = SimdMath::Vec3;
 
-		float X;
-		float Y;
-		float Z;
-	};
-
-
-	inline float dotProduct(const Vector& lhs, const Vector& rhs)
-	{
-		return lhs.X * rhs.X + lhs.Y * rhs.Y + lhs.Z * rhs.Z;
-	}
 
 	inline float getAngleBetweenVectors(const Vector& lhs, const Vector& rhs)
 	{
-	const auto scalarProduct = dotProduct(lhs, rhs);
+	const auto scalarProduct = dot(lhs, rhs);
 	const auto lengthsMult = lhs.length() * rhs.length();
 
 	return acosf(scalarProduct / lengthsMult) / M_PI * 180;
@@ -104,50 +63,110 @@ namespace Car3D
 		return r;
 	}
 
-	std::vector<GLint> getFilledFirst(const std::vector<std::vector<Vector>>& fillVertices) 
+	void glutBitmapStr(void* font, const std::string& str)
 	{
-		std::vector<GLint> r;
-		r.reserve(fillVertices.size());
-		
-		GLint nextIndex{};
-		for(int i = 0; i < fillVertices.size(); ++i)
+		for(const auto ch: str) glutBitmapCharacter(font, ch);
+	}
+
+	// GL_PRIMITIVE_RESTART_FIXED_INDEX for GL_UNSIGNED_INT
+	const unsigned int primitiveRestartIndex = 0xFFFFFFFF;
+
+	// Splits a triangle strip stitched together with degenerate triangles into strips
+	// separated by the restart index. The same triangles are drawn, only the winding
+	// of a strip may flip, which doesn't matter without face culling
+	std::vector<unsigned int> getRestartStrips(const std::vector<unsigned int>& strip)
+	{
+		std::vector<unsigned int> r;
+		r.reserve(strip.size());
+
+		const auto isDegenerate = [&strip](std::size_t i) {
+			return strip[i - 2] == strip[i - 1] || strip[i - 1] == strip[i] || strip[i - 2] == strip[i];
+		};
+
+		bool inStrip = false;
+		for(std::size_t i = 2; i < strip.size(); ++i)
 		{
-			r.push_back(nextIndex);
-			nextIndex += fillVertices[i].size();
+			if(isDegenerate(i))
+			{
+				inStrip = false;
+				continue;
+			}
+
+			if(!inStrip)
+			{
+				if(!r.empty())
+					r.push_back(primitiveRestartIndex);
+
+				r.push_back(strip[i - 2]);
+				r.push_back(strip[i - 1]);
+				inStrip = true;
+			}
+
+			r.push_back(strip[i]);
 		}
 
 		return r;
 	}
 
-	std::vector<GLsizei> getFilledCount(const std::vector<std::vector<Vector>>& fillVertices) 
+	struct Color
 	{
-		std::vector<GLsizei> r;
-		
-		for(const auto& vertices : fillVertices)
-			r.push_back(static_cast<GLsizei>(vertices.size()));
-		
-		return r;
-	}
+		float R;
+		float G;
+		float B;
+	};
 
-	void glutBitmapStr(void* font, const std::string& str)
+	// The layout glMultiDrawElementsIndirect reads from GL_DRAW_INDIRECT_BUFFER
+	struct DrawElementsIndirectCommand
 	{
-		for(const auto ch: str) glutBitmapCharacter(font, ch);
-	}
+		GLuint count;
+		GLuint instanceCount;
+		GLuint firstIndex;
+		GLint baseVertex;
+		GLuint baseInstance;
+	};
 
 	struct Car
 	{	
 		Car()
 		:
 		wireFrame{},
-		where{27.f, -7.f, 0.f},
-		sidePartsZOffset{-20.f}
+		bodyLocation{-27.f, -7.f, 0.f},
+		sidePartsZOffset{-20.f},
+		secondBodyPartOffset{},
+		programContext{},
+		program{},
+		bodyMesh{},
+		wheelMesh{}
+		{
+
+		}
+
+		Car(const Car&) = delete;
+		Car& operator=(const Car&) = delete;
+
+		~Car()
 		{
+			if(GLContext::isCurrent(programContext))
+				glDeleteProgram(program);
+
+			if(GLContext::isCurrent(bodyMesh.context))
+			{
+				glDeleteVertexArrays(1, &bodyMesh.vertexArray);
+				glDeleteBuffers(4, bodyMesh.buffers);
+			}
 
+			if(GLContext::isCurrent(wheelMesh.context))
+			{
+				glDeleteVertexArrays(2, wheelMesh.vertexArrays);
+				glDeleteBuffers(5, wheelMesh.buffers);
+			}
 		}
 
 		void init()
 		{
-			glEnableClientState(GL_VERTEX_ARRAY);
+			buildProgram();
+			buildBodyMesh();
+			buildWheelMesh();
 		}
 
 		void draw() const
@@ -159,36 +178,29 @@ namespace Car3D
 				glColor3f(0.f, 0.f, 0.f);
 			}
 
-			const auto leftFrontWheelPoint = Vector{
-				-20.f, -6.f, 0.f
-			};
+			const auto wheelPoints = getWheelPoints();
+			const auto& leftFrontWheelPoint = wheelPoints[0];
+			const auto& rightFrontWheelPoint = wheelPoints[1];
 
-			const auto rightFrontWheelPoint = Vector{
-				20.f, -6.f, 0.f
-			};
+			drawLabel();
 
-			draw3DWheel(leftFrontWheelPoint);
-			draw3DWheel(rightFrontWheelPoint);
+			glUseProgram(program);
+			glEnable(GL_PRIMITIVE_RESTART_FIXED_INDEX);
 
-			drawSideParts(Vector{-27.f, -7.f, -0.f});
-			drawMiddleSideParts();
-			drawFrontWindshield();
-			drawBackWindshield();
-			drawBackLightBulbs();
-			drawLabel();
+			drawWheels();
+			drawBody();
 
-			draw3DWheel(leftFrontWheelPoint + Vector{0.f, 0.f, sidePartsZOffset});
-			draw3DWheel(rightFrontWheelPoint + Vector{0.f, 0.f, sidePartsZOffset});
-			drawSideParts(Vector{-27.f, -7.f, sidePartsZOffset});
+			glDisable(GL_PRIMITIVE_RESTART_FIXED_INDEX);
+			glUseProgram(0);
 
 			glPushMatrix();
 			glTranslatef(leftFrontWheelPoint.X, leftFrontWheelPoint.Y, sidePartsZOffset);
-			glutSolidCylinder(0.5f, 20.f, 20, 20);
+			Primitives::drawSolidCylinder(0.5f, -sidePartsZOffset, 20, 20);
 			glPopMatrix();
 
 			glPushMatrix();
 			glTranslatef(rightFrontWheelPoint.X, rightFrontWheelPoint.Y, sidePartsZOffset);
-			glutSolidCylinder(0.5f, 20.f, 20, 20);
+			Primitives::drawSolidCylinder(0.5f, -sidePartsZOffset, 20, 20);
 			glPopMatrix();
 
 		}
@@ -196,11 +208,62 @@ namespace Car3D
 		void toggleWireframeMode()
 		{
 			wireFrame = !wireFrame;
+			updateBodyColors();
+			glutPostRedisplay();
+		}
+
+		float getSidePartsZOffset() const noexcept
+		{
+			return sidePartsZOffset;
+		}
+
+		// The only place the body changes shape, so the only place its mesh is rebuilt
+		void setSidePartsZOffset(float pSidePartsZOffset)
+		{
+			sidePartsZOffset = pSidePartsZOffset;
+			buildBodyMesh();
+			updateWheelInstances();
 			glutPostRedisplay();
 		}
 
 		private:
 
+		// Triangle strips of the body mesh, offset is counted in indices and
+		// baseVertex moves the side parts to the far side
+		struct MeshPart
+		{
+			GLsizei offset;
+			GLsizei count;
+			GLint baseVertex;
+			Color color;
+			Color wireframeColor;
+		};
+
+		// All the parts are drawn with one glMultiDrawElementsIndirect, the color of
+		// a part is an instanced attribute picked by the baseInstance of its command
+		struct BodyMesh
+		{
+			// The generation of the context the objects below were made in, 0 before the first
+			unsigned context;
+			GLuint vertexArray;
+			GLuint buffers[4]; // vertices, indices, draw commands, part colors
+			std::vector<MeshPart> parts;
+		};
+
+		// One disc and one hub, drawn for every wheel with per-instance offsets.
+		// The instance buffer keeps the offsets of all the discs, then of the hubs
+		struct WheelMesh
+		{
+			// The generation of the context the objects below were made in, 0 before the first
+			unsigned context;
+			GLuint vertexArrays[2]; // disc, hub
+			GLuint buffers[5]; // disc vertices, disc indices, hub vertices, hub indices, instance offsets
+			GLsizei discIndicesN;
+			GLsizei hubIndicesN;
+			GLsizei discsN;
+			GLsizei hubsN;
+		};
+
 		Vector getPointOnSegment(const Vector& v1, const Vector& v2, const float k) const noexcept
 		{
 			return (v1 + v2 * k) * (1 / (1 + k));
@@ -229,26 +292,209 @@ namespace Car3D
 			return r;
 		}
 
-		void draw3DWheel(const Vector& where) const
+		// Shared by the wheels and the body. The offset and the color are per instance
+		// or, when their array is disabled, the current value of the attribute
+		void buildProgram()
 		{
-			glPushMatrix();
+			// Made once per context
+			if(GLContext::isCurrent(programContext))
+				return;
 
-			const auto ZOffset = where.Z == sidePartsZOffset ? -0.5f : -3.5f;
+			const char* vertexShader = R"(
+				#version 330 compatibility
+				layout(location = 0) in vec3 position;
+				layout(location = 1) in vec3 offset;
+				layout(location = 2) in vec3 color;
 
-			glTranslatef(where.X, where.Y, where.Z + ZOffset);
-			glColor3f(0.f, 0.f, 0.f);
-			glutSolidCylinder(1.05, 4.f, 20, 20);
-			glPopMatrix();
-			
-			const int N = 6;
+				void main()
+				{
+					gl_FrontColor = vec4(color, 1.0);
+					gl_Position = gl_ModelViewProjectionMatrix * vec4(position + offset, 1.0);
+				}
+			)";
+
+			const char* fragmentShader = R"(
+				#version 330 compatibility
+
+				void main()
+				{
+					gl_FragColor = gl_Color;
+				}
+			)";
+
+			programContext = GLContext::getGeneration();
+			program = Shader::createProgram(vertexShader, fragmentShader);
+		}
+
+		// Centers of the wheels, the near side first
+		std::array<Vector, 4> getWheelPoints() const
+		{
+			const auto leftFrontWheelPoint = Vector{
+				-20.f, -6.f, 0.f
+			};
+
+			const auto rightFrontWheelPoint = Vector{
+				20.f, -6.f, 0.f
+			};
+
+			const auto farSide = Vector{0.f, 0.f, sidePartsZOffset};
+
+			return {
+				leftFrontWheelPoint, rightFrontWheelPoint, 
+				leftFrontWheelPoint + farSide, rightFrontWheelPoint + farSide
+			};
+		}
+
+		void buildWheelMesh()
+		{
+			// Made once per context, setup() again only fills them again
+			if(!GLContext::isCurrent(wheelMesh.context))
+			{
+				wheelMesh.context = GLContext::getGeneration();
+				glGenVertexArrays(2, wheelMesh.vertexArrays);
+				glGenBuffers(5, wheelMesh.buffers);
+			}
+
+			const auto center = Vector{};
+			const auto scale = 0.5f;
+
+			const auto innerN = 20;
+			const auto innerR = 7.f * scale;
+
+			const auto outerN = 40;
+			const auto outerR = 10.f * scale;
+
+			const auto middleWholeCircleN = 10;
+			const auto middleWholeCircleR = 2.1f * scale;
+
+			const std::vector<std::vector<Vector>> discStrips{
+				connectCircles(getCirclePoints(center, innerR - 0.1f, innerN), getCirclePoints(center, innerR + 0.5f, innerN)),
+				connectCircles(getCirclePoints(center, outerR - 0.1f, outerN), getCirclePoints(center, outerR + 0.5f, outerN)),
+				drawCircleWithTriangleStrip(center, getCirclePoints(center, middleWholeCircleR, middleWholeCircleN))
+			};
+
+			// Same tessellation as glutSolidCylinder(1.05, 4.f, 20, 20)
+			const auto hubR = 1.05f;
+			const auto hubLength = 4.f;
+			const auto hubSlices = 20;
+			const auto hubStacks = 20;
+
+			std::vector<std::vector<Vector>> hubStrips{
+				drawCircleWithTriangleStrip(center, getCirclePoints(center, hubR, hubSlices)),
+				drawCircleWithTriangleStrip(center + Vector{0.f, 0.f, hubLength}, 
+					getCirclePoints(center + Vector{0.f, 0.f, hubLength}, hubR, hubSlices))
+			};
+
+			for(int i{}; i < hubStacks; ++i)
+			{
+				const auto bottom = getCirclePoints(center + Vector{0.f, 0.f, hubLength / hubStacks * i}, hubR, hubSlices);
+				const auto top = getCirclePoints(center + Vector{0.f, 0.f, hubLength / hubStacks * (i + 1)}, hubR, hubSlices);
+
+				std::vector<Vector> strip;
+				strip.reserve(bottom.size() * 2);
+
+				for(std::size_t j{}; j < bottom.size(); ++j)
+				{
+					strip.push_back(bottom[j]);
+					strip.push_back(top[j]);
+				}
+
+				hubStrips.push_back(std::move(strip));
+			}
+
+			const auto discsPerWheel = 6;
+			wheelMesh.hubsN = getWheelPoints().size();
+			wheelMesh.discsN = wheelMesh.hubsN * discsPerWheel;
+
+			wheelMesh.discIndicesN = uploadWheelStrips(discStrips, 0, 0);
+			wheelMesh.hubIndicesN = uploadWheelStrips(hubStrips, 1, wheelMesh.discsN);
+
+			updateWheelInstances();
+		}
+
+		// Fills the vertex array of the disc (0) or of the hub (1), the strips are
+		// separated with the fixed primitive restart index
+		GLsizei uploadWheelStrips(const std::vector<std::vector<Vector>>& strips, int mesh, GLsizei firstInstance)
+		{
+			std::vector<unsigned int> indices;
+			unsigned int nextIndex{};
+
+			for(const auto& strip : strips)
+			{
+				if(!indices.empty())
+					indices.push_back(primitiveRestartIndex);
+
+				for(std::size_t i{}; i < strip.size(); ++i)
+					indices.push_back(nextIndex++);
+			}
+
+			const auto vertices = getFilledVertices(strips);
+
+			glBindVertexArray(wheelMesh.vertexArrays[mesh]);
+
+			glBindBuffer(GL_ARRAY_BUFFER, wheelMesh.buffers[mesh * 2]);
+			glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(float), vertices.data(), GL_STATIC_DRAW);
+			glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 0, nullptr);
+			glEnableVertexAttribArray(0);
+
+			glBindBuffer(GL_ARRAY_BUFFER, wheelMesh.buffers[4]);
+			glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 0, reinterpret_cast<const void*>(firstInstance * 3 * sizeof(float)));
+			glVertexAttribDivisor(1, 1);
+			glEnableVertexAttribArray(1);
+
+			glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, wheelMesh.buffers[mesh * 2 + 1]);
+			glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(unsigned int), indices.data(), GL_STATIC_DRAW);
+
+			glBindVertexArray(0);
+			glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+			return static_cast<GLsizei>(indices.size());
+		}
+
+		// The discs of a wheel go outwards from its center, the hub sticks out
+		// of the body on the near and the far side alike
+		void updateWheelInstances() const
+		{
+			const auto discsPerWheel = wheelMesh.discsN / wheelMesh.hubsN;
 			const auto path = 4.f;
-			const auto step = path / (N - 1);
-			
-			for(int i{}; i < N; ++i)
+			const auto step = path / (discsPerWheel - 1);
+
+			std::vector<Vector> offsets;
+			offsets.reserve(wheelMesh.discsN + wheelMesh.hubsN);
+
+			for(const auto& where : getWheelPoints())
+			{
+				for(int i{}; i < discsPerWheel; ++i)
+				{
+					const auto offset = (where.Z == sidePartsZOffset) ? step * i : -(step * i);
+					offsets.push_back(where + Vector(0.f, 0.f, offset));
+				}
+			}
+
+			for(const auto& where : getWheelPoints())
 			{
-				const auto offset = (where.Z == sidePartsZOffset) ? step * i : -(step * i);
-				drawWheel(where + Vector(0.f, 0.f, offset), 0.5f);
+				const auto ZOffset = where.Z == sidePartsZOffset ? -0.5f : -3.5f;
+				offsets.push_back(where + Vector(0.f, 0.f, ZOffset));
 			}
+
+			const auto instances = getFilledVertices({ offsets });
+
+			glBindBuffer(GL_ARRAY_BUFFER, wheelMesh.buffers[4]);
+			glBufferData(GL_ARRAY_BUFFER, instances.size() * sizeof(float), instances.data(), GL_STATIC_DRAW);
+			glBindBuffer(GL_ARRAY_BUFFER, 0);
+		}
+
+		void drawWheels() const
+		{
+			glVertexAttrib3f(2, 0.f, 0.f, 0.f);
+
+			glBindVertexArray(wheelMesh.vertexArrays[0]);
+			glDrawElementsInstanced(GL_TRIANGLE_STRIP, wheelMesh.discIndicesN, GL_UNSIGNED_INT, nullptr, wheelMesh.discsN);
+
+			glBindVertexArray(wheelMesh.vertexArrays[1]);
+			glDrawElementsInstanced(GL_TRIANGLE_STRIP, wheelMesh.hubIndicesN, GL_UNSIGNED_INT, nullptr, wheelMesh.hubsN);
+
+			glBindVertexArray(0);
 		}
 
 		std::vector<Vector> getBodyParts(const Vector& where) const
@@ -372,205 +618,185 @@ namespace Car3D
 			return r;
 		}
 
-		std::vector<unsigned int*> getPartsIndicesPtr(std::vector<std::vector<unsigned int>>& partsIndices) const
+		std::vector<unsigned int> getFrontWindshieldIndices() const
 		{
-			std::vector<unsigned int*> r;
-
-			r.resize(partsIndices.size());
-
-			for(int i{}; i < partsIndices.size(); ++i)
-				r[i] = partsIndices[i].data();
-
-			return r;
+			return {
+				38, getSecondBodyPartIndex(38),
+				39, getSecondBodyPartIndex(39), getSecondBodyPartIndex(39),
+				27, 27, 26, 26, 8
+			};
 		}
 
-		void drawBodyParts() const
+		std::vector<unsigned int> getBackWindshieldIndices() const
 		{
-			std::vector<std::vector<Vector>> bodyParts{
-				getBodyParts(where),
-				getBodyParts({where.X, where.Y, where.Z == sidePartsZOffset ? 0.f : sidePartsZOffset})	
+			return {
+				47, getSecondBodyPartIndex(47),
+				46, getSecondBodyPartIndex(46)
 			};
-			
-			const auto indecies = getBodyPartIndices();
-
-			const auto vertices = getFilledVertices(bodyParts);
-			glVertexPointer(3, GL_FLOAT, 0, vertices.data());
-			
-			if(!wireFrame)
-				glColor3f(1.f, 0.f, 0.f);
-			
-			glDrawElements(GL_TRIANGLE_STRIP, indecies.size(), GL_UNSIGNED_INT, (const void**)(indecies.data()));
 		}
 
-		void drawLabel() const
+		std::vector<unsigned int> getBackLightBulbsIndices() const
 		{
-			std::vector<std::vector<Vector>> bodyParts{
-				getBodyParts(where),
-				getBodyParts({where.X, where.Y, where.Z == sidePartsZOffset ? 0.f : sidePartsZOffset}),
+			return {
+				42, 43, 44, 45, 45,
+				getSecondBodyPartIndex(42), getSecondBodyPartIndex(42),
+				getSecondBodyPartIndex(43), getSecondBodyPartIndex(44),
+				getSecondBodyPartIndex(45)
 			};
+		}
 
-			const auto indecies = std::vector<unsigned int>{
+		std::vector<unsigned int> getLabelIndices() const
+		{
+			return {
 				50, 51, getSecondBodyPartIndex(50), getSecondBodyPartIndex(51)
 			};
+		}
 
-			const auto vertices = getFilledVertices(bodyParts);
-
-			glVertexPointer(3, GL_FLOAT, 0, vertices.data());
+		// Both sides of the body go into one vertex buffer, the near side first, so the
+		// parts spanning the car index the far side through getSecondBodyPartIndex
+		void buildBodyMesh()
+		{
+			const std::vector<std::vector<Vector>> bodyParts{
+				getBodyParts(bodyLocation),
+				getBodyParts(bodyLocation + Vector{0.f, 0.f, sidePartsZOffset})
+			};
 
-			if(!wireFrame)
-				glColor3f(1.f, 1.f, 1.f);
+			secondBodyPartOffset = bodyParts[0].size();
 
-			const auto pos = where + Vector{-2.8f, 3.5f} + Vector(0.f, 0.f, -17.f);
+			std::vector<unsigned int> indices;
+			bodyMesh.parts.clear();
 
-			glColor3f(0.f, 0.f, 0.f);
-			glRasterPos3f(pos.X, pos.Y, pos.Z);
-			
-			glPushMatrix();
-			glLineWidth(3.f);
-			glTranslatef(-30.f, -3.5f, -16.4f);
-			glRotatef(-90.f, 0.f, 1.f, 0.f);
-			glScalef(0.018f, 0.018f, 0.018f);
-			glutStrokeString(GLUT_STROKE_ROMAN, (const unsigned char*)"B382AM197");
-			glLineWidth(1.f);
-			glPopMatrix();
+			const auto addIndices = [&indices](const std::vector<unsigned int>& partIndices) {
+				const auto offset = static_cast<GLsizei>(indices.size());
+				const auto strips = getRestartStrips(partIndices);
+				indices.insert(indices.end(), strips.begin(), strips.end());
 
-			glColor3f(1.f, 1.f, 1.f);
-			glDrawElements(GL_TRIANGLE_STRIP, indecies.size(), GL_UNSIGNED_INT, (const void**)(indecies.data()));
-		}
+				return std::make_pair(offset, static_cast<GLsizei>(strips.size()));
+			};
 
-		void drawLightBulbs() const
-		{
-			std::vector<std::vector<Vector>> bodyParts{
-				getBodyParts(where),
+			const auto addPart = [this, &addIndices](const std::vector<unsigned int>& partIndices, 
+				const Color& color, const Color& wireframeColor = { 0.f, 0.f, 0.f }) {
+				const auto range = addIndices(partIndices);
+				bodyMesh.parts.push_back({ range.first, range.second, 0, color, wireframeColor });
 			};
 
-			const auto indecies = getLightBulbsPartIndices();
-			const auto vertices = getFilledVertices(bodyParts);
+			// Both sides share the indices of their parts
+			const std::vector<std::pair<std::vector<unsigned int>, Color>> sideParts{
+				{ getBodyPartIndices(), { 1.f, 0.f, 0.f } },
+				{ getLightBulbsPartIndices(), { 1.f, 1.f, 0.f } },
+				{ getWindshieldsPartIndices(), { 0.9f, 0.9f, 0.9f } },
+				{ getSteeringWheelPartIndices(), { 0.f, 0.f, 0.f } }
+			};
 
-			glVertexPointer(3, GL_FLOAT, 0, vertices.data());
+			std::vector<std::pair<GLsizei, GLsizei>> sidePartRanges;
+			for(const auto& part : sideParts)
+				sidePartRanges.push_back(addIndices(part.first));
 
-			if(!wireFrame)
-				glColor3f(1.f, 1.f, 0.f);
+			const auto addSideParts = [&](GLint baseVertex) {
+				for(std::size_t i{}; i < sideParts.size(); ++i)
+				{
+					bodyMesh.parts.push_back({ 
+						sidePartRanges[i].first, sidePartRanges[i].second, baseVertex, sideParts[i].second, { 0.f, 0.f, 0.f } 
+					});
+				}
+			};
 
-			glDrawElements(GL_TRIANGLE_STRIP, indecies.size(), GL_UNSIGNED_INT, (const void**)(indecies.data()));
-		}
+			addSideParts(0);
+			addPart(getBodyMiddleIndices(), { 0.9f, 0.f, 0.f });
+			addPart(getFrontWindshieldIndices(), { 0.9f, 0.9f, 0.9f });
+			addPart(getBackWindshieldIndices(), { 0.9f, 0.9f, 0.9f });
+			addPart(getBackLightBulbsIndices(), { 1.f, 1.f, 0.f });
+			// White in the wireframe mode too
+			addPart(getLabelIndices(), { 1.f, 1.f, 1.f }, { 1.f, 1.f, 1.f });
+			addSideParts(secondBodyPartOffset);
 
-		void drawBackLightBulbs() const
-		{
-			std::vector<std::vector<Vector>> bodyParts{
-				getBodyParts(where),
-				getBodyParts({where.X, where.Y, where.Z == sidePartsZOffset ? 0.f : sidePartsZOffset}),
-			};
+			std::vector<DrawElementsIndirectCommand> commands;
+			commands.reserve(bodyMesh.parts.size());
 
-			const auto indecies = std::vector<unsigned int>{
-				42, 43, 44, 45, 45,
-				getSecondBodyPartIndex(42), getSecondBodyPartIndex(42),
-				getSecondBodyPartIndex(43), getSecondBodyPartIndex(44),
-				getSecondBodyPartIndex(45)
-			};
+			for(std::size_t i{}; i < bodyMesh.parts.size(); ++i)
+			{
+				const auto& part = bodyMesh.parts[i];
+				commands.push_back({ 
+					static_cast<GLuint>(part.count), 1, static_cast<GLuint>(part.offset), part.baseVertex, static_cast<GLuint>(i) 
+				});
+			}
 
 			const auto vertices = getFilledVertices(bodyParts);
 
-			glVertexPointer(3, GL_FLOAT, 0, vertices.data());
+			// The names of another context went with it and are only forgotten
+			if(!GLContext::isCurrent(bodyMesh.context))
+			{
+				bodyMesh.context = GLContext::getGeneration();
+				glGenVertexArrays(1, &bodyMesh.vertexArray);
+				glGenBuffers(4, bodyMesh.buffers);
+			}
 
-			if(!wireFrame)
-				glColor3f(1.f, 1.f, 0.f);
+			glBindVertexArray(bodyMesh.vertexArray);
 
-			glDrawElements(GL_TRIANGLE_STRIP, indecies.size(), GL_UNSIGNED_INT, (const void**)(indecies.data()));
-		}
-
-		void drawFrontWindshield() const
-		{
-			std::vector<std::vector<Vector>> bodyParts{
-				getBodyParts(where),
-				getBodyParts({where.X, where.Y, where.Z == sidePartsZOffset ? 0.f : sidePartsZOffset})
-			};
+			glBindBuffer(GL_ARRAY_BUFFER, bodyMesh.buffers[0]);
+			glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(float), vertices.data(), GL_STATIC_DRAW);
+			glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 0, nullptr);
+			glEnableVertexAttribArray(0);
 
-			const auto indecies =  
-				std::vector<unsigned int>{
-					38, getSecondBodyPartIndex(38),
-					39, getSecondBodyPartIndex(39), getSecondBodyPartIndex(39),
-					27, 27, 26, 26, 8
-			};
+			glBindBuffer(GL_ARRAY_BUFFER, bodyMesh.buffers[3]);
+			glVertexAttribPointer(2, 3, GL_FLOAT, GL_FALSE, 0, nullptr);
+			glVertexAttribDivisor(2, 1);
+			glEnableVertexAttribArray(2);
 
-			const auto vertices = getFilledVertices(bodyParts);
-			glVertexPointer(3, GL_FLOAT, 0, vertices.data());
-			
-			if(!wireFrame)
-				glColor3f(0.9f, 0.9f, 0.9f);
-			
-			glDrawElements(GL_TRIANGLE_STRIP, indecies.size(), GL_UNSIGNED_INT, (const void**)(indecies.data()));
-		}
+			glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, bodyMesh.buffers[1]);
+			glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(unsigned int), indices.data(), GL_STATIC_DRAW);
 
-		void drawBackWindshield() const
-		{
-			std::vector<std::vector<Vector>> bodyParts{
-				getBodyParts(where),
-				getBodyParts({where.X, where.Y, where.Z == sidePartsZOffset ? 0.f : sidePartsZOffset})
-			};
+			glBindVertexArray(0);
+			glBindBuffer(GL_ARRAY_BUFFER, 0);
 
-			const auto indecies =  
-				std::vector<unsigned int>{
-					47, getSecondBodyPartIndex(47),
-					46, getSecondBodyPartIndex(46)
-			};
+			glBindBuffer(GL_DRAW_INDIRECT_BUFFER, bodyMesh.buffers[2]);
+			glBufferData(GL_DRAW_INDIRECT_BUFFER, commands.size() * sizeof(DrawElementsIndirectCommand), commands.data(), GL_STATIC_DRAW);
+			glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
 
-			const auto vertices = getFilledVertices(bodyParts);
-			glVertexPointer(3, GL_FLOAT, 0, vertices.data());
-			
-			if(!wireFrame)
-				glColor3f(0.9f, 0.9f, 0.9f);
-			
-			glDrawElements(GL_TRIANGLE_STRIP, indecies.size(), GL_UNSIGNED_INT, (const void**)(indecies.data()));
+			updateBodyColors();
 		}
 
-		void drawWindshields() const
-		{	
-			std::vector<std::vector<Vector>> bodyParts{
-				getBodyParts(where),
-			};
+		void updateBodyColors() const
+		{
+			std::vector<Color> colors;
+			colors.reserve(bodyMesh.parts.size());
 
-			const auto indecies = getWindshieldsPartIndices();
+			for(const auto& part : bodyMesh.parts)
+				colors.push_back(wireFrame ? part.wireframeColor : part.color);
 
-			const auto vertices = getFilledVertices(bodyParts);
-			glVertexPointer(3, GL_FLOAT, 0, vertices.data());
-			
-			if(!wireFrame)
-				glColor3f(0.9f, 0.9f, 0.9f);
-			
-			glDrawElements(GL_TRIANGLE_STRIP, indecies.size(), GL_UNSIGNED_INT, (const void**)(indecies.data()));
+			glBindBuffer(GL_ARRAY_BUFFER, bodyMesh.buffers[3]);
+			glBufferData(GL_ARRAY_BUFFER, colors.size() * sizeof(Color), colors.data(), GL_STATIC_DRAW);
+			glBindBuffer(GL_ARRAY_BUFFER, 0);
 		}
 
-		void drawSteeringWheel() const
+		void drawBody() const
 		{
-			std::vector<std::vector<Vector>> bodyParts{
-				getBodyParts(where)	
-			};
+			glBindVertexArray(bodyMesh.vertexArray);
+			glBindBuffer(GL_DRAW_INDIRECT_BUFFER, bodyMesh.buffers[2]);
 
-			const auto indecies = getSteeringWheelPartIndices();
+			glMultiDrawElementsIndirect(GL_TRIANGLE_STRIP, GL_UNSIGNED_INT, nullptr, bodyMesh.parts.size(), 0);
 
-			const auto vertices = getFilledVertices(bodyParts);
-			glVertexPointer(3, GL_FLOAT, 0, vertices.data());
-			
-			if(!wireFrame)
-				glColor3f(0.0f, 0.0f, 0.0f);
-			
-			glDrawElements(GL_TRIANGLE_STRIP, indecies.size(), GL_UNSIGNED_INT, (const void**)(indecies.data()));
+			glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+			glBindVertexArray(0);
 		}
 
-		void drawSideParts(const Vector& pWhere) const
-		{	
-			where = pWhere;
-			drawBodyParts();
-			drawLightBulbs();
-			drawWindshields();
-			drawSteeringWheel();
+		void drawLabel() const
+		{
+			glColor3f(0.f, 0.f, 0.f);
+			
+			glPushMatrix();
+			glLineWidth(3.f);
+			glTranslatef(-30.f, -3.5f, -16.4f);
+			glRotatef(-90.f, 0.f, 1.f, 0.f);
+			glScalef(0.018f, 0.018f, 0.018f);
+			glutStrokeString(GLUT_STROKE_ROMAN, (const unsigned char*)"B382AM197");
+			glLineWidth(1.f);
+			glPopMatrix();
 		}
 
-		unsigned int getSecondBodyPartIndex(int index) const
+		unsigned int getSecondBodyPartIndex(unsigned int index) const
 		{
-			const auto size = getBodyParts(where).size();
-			return index + size;
+			return index + secondBodyPartOffset;
 		}
 
 		std::vector<unsigned int> getBodyMiddleIndices() const
@@ -649,76 +875,6 @@ namespace Car3D
 			return r;
 		} 
 
-		std::vector<Vector> getSecondBodyParts() const
-		{
-			return getBodyParts({where.X, where.Y, sidePartsZOffset});
-		}
- 
-		void drawMiddleSideParts() const
-		{
-			std::vector<std::vector<Vector>> bodyParts{
-				getBodyParts(where),
-				getBodyParts({where.X, where.Y, where.Z == sidePartsZOffset ? 0.f : sidePartsZOffset}),
-			};
-
-			std::vector<std::vector<unsigned int>> partsIndices{
-				getBodyMiddleIndices()
-			};
-
-			const auto vertices = getFilledVertices(bodyParts);
-			glVertexPointer(3, GL_FLOAT, 0, vertices.data());
-			
-			const auto countIndices = getCountIndices(partsIndices);
-			const auto indices = getPartsIndicesPtr(partsIndices);
-			
-			if(!wireFrame)
-				glColor3f(0.9f, 0.0f, 0.0f);
-			
-			glMultiDrawElements(GL_TRIANGLE_STRIP, countIndices.data(), GL_UNSIGNED_INT, (const void**)(indices.data()), indices.size());
-		}
-
-		void drawWheel(const Vector& where, float scale) const
-		{	
-			const auto innerN = 20;
-			const auto innerR = 7.f * scale;
-
-			const auto outerN = 40;
-			const auto outerR = 10.f * scale;
-
-			const auto middleWholeCircleN = 10;
-			const auto middleWholeCircleR = 2.1f * scale;
-
-			std::vector<std::vector<Vector>> circles{
-				connectCircles(getCirclePoints(where, innerR - 0.1f, innerN), getCirclePoints(where, innerR + 0.5f, innerN)),
-				connectCircles(getCirclePoints(where, outerR - 0.1f, outerN), getCirclePoints(where, outerR + 0.5f, outerN)),
-				drawCircleWithTriangleStrip(where, getCirclePoints(where, middleWholeCircleR, middleWholeCircleN))
-			};
-
-			const auto vertices = getFilledVertices(circles);
-
-			glVertexPointer(3, GL_FLOAT, 0, vertices.data());
-
-			const auto first = getFilledFirst(circles);
-			const auto count = getFilledCount(circles);
-			
-			if(!wireFrame)
-				glColor3f(0.f, 0.f, 0.f);
-			
-			glVertexPointer(3, GL_FLOAT, 0.f, vertices.data());
-			glMultiDrawArrays(GL_TRIANGLE_STRIP, first.data(), count.data(), circles.size());
-		}
-		
-		std::vector<int> getCountIndices(const std::vector<std::vector<unsigned int>>& partsIndices) const
-		{
-			std::vector<int> r;
-			r.reserve(partsIndices.size());
-
-			for(const auto& i : partsIndices)
-				r.push_back(i.size());
-
-			return r;
-		}
-
 		std::vector<Vector> connectCircles(const std::vector<Vector>& lhs, const std::vector<Vector>& rhs) const
 		{
 			std::vector<Vector> r;
@@ -747,22 +903,18 @@ namespace Car3D
 
 		std::vector<Vector> getCirclePoints(const Vector& center, float R, int N) const
 		{
-			std::vector<Vector> r;
-
-			float t;
-			for(int i{}; i <= N; ++i)
-			{
-				t = (2.f * M_PI / N * i);
-				const auto vertex = Vector(center.X + R * cos(t), center.Y + R * sin(t), center.Z);
-				r.push_back(vertex);
-			}
-
-			return r;
+			return ArcGenerator::getCirclePoints(center, R, N);
 		}
 
 		bool wireFrame;
-		mutable Vector where;
+		Vector bodyLocation;
 		float sidePartsZOffset;
+		unsigned int secondBodyPartOffset;
+		// The generation of the context the program was made in, 0 before the first
+		unsigned programContext;
+		GLuint program;
+		BodyMesh bodyMesh;
+		WheelMesh wheelMesh;
 
 	} car;
 
@@ -929,6 +1081,12 @@ namespace Car3D
 		case 'g':
 		case 'G':
 			break;
+		case '+':
+			car.setSidePartsZOffset(clamp(-30.f, -10.f, car.getSidePartsZOffset() - 1.f));
+			break;
+		case '-':
+			car.setSidePartsZOffset(clamp(-30.f, -10.f, car.getSidePartsZOffset() + 1.f));
+			break;
 		
 		default:
 			break;
@@ -953,8 +1111,18 @@ namespace Car3D
 	}
 
 
+	void printInteraction(void)
+	{
+		std::cout << "Interaction:\n";
+		std::cout << "Press space to toggle the wireframe" << std::endl;
+		std::cout << "Press +/- to widen or narrow the car" << std::endl;
+		std::cout << "Press the arrow keys to move the camera around the car" << std::endl;
+		std::cout << "Turn the mouse wheel to move the camera closer or further" << std::endl;
+	}
+
 	int main(int argc, char **argv)
 	{
+		printInteraction();
 		glutInit(&argc, argv);
 
 		glutInitContextVersion(4, 3);
@@ -981,4 +1149,6 @@ namespace Car3D
 
 		glutMainLoop();
 	}
+
+	static SceneRegistry::Registrar registrar{ { "Car3D", main, setup, drawScene, resize, keyInput } };
 }
\ No newline at end of file
@@ -10,6 +10,7 @@
 #include <iostream>
 #include <GL/glew.h>
 #include <GL/freeglut.h>
+#include "SceneRegistry.h"
 
 namespace ChildrenSlide
 {
@@ -107,4 +108,6 @@ namespace ChildrenSlide
 
 		return 0;
 	}
+
+	static SceneRegistry::Registrar registrar{ { "ChildrenSlide", main, setup, drawScene, resize, keyInput } };
 }
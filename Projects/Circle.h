@@ -1,3 +1,4 @@
+#pragma once
 /////////////////////////////////////////////////////////////////////         
 // This program draws a circle with glDrawArrays()
 //
@@ -12,6 +13,7 @@
 #include <iostream>
 #include <GL/glew.h>
 #include <GL/freeglut.h> 
+#include "SceneRegistry.h"
 #include <vector>
 
 namespace Circle
@@ -164,4 +166,6 @@ namespace Circle
 
 		return 0;
 	}
+
+	static SceneRegistry::Registrar registrar{ { "Circle", main, setup, drawScene, resize, keyInput } };
 }
\ No newline at end of file
@@ -0,0 +1,117 @@
+#pragma once
+///////////////////////////////////////////////////////////////////////////////////////
+// Timing of the segment clipping kernels on 10 million random segments, printed
+// by the headless launcher with --clipping.
+//
+// The segments lie in a box three times the size of the clip rectangle in both
+// directions, so they are a mix of inside, outside and crossing ones. They come
+// from a fixed seed, so runs can be compared.
+///////////////////////////////////////////////////////////////////////////////////////
+
+#include <chrono>
+#include <random>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <ostream>
+#include <iomanip>
+#include "Benchmark.h"
+#include "SegmentClip.h"
+
+namespace ClipBenchmark
+{
+	using SegmentClip::Kernel;
+
+	constexpr std::size_t segmentsN = 10000000;
+	constexpr SegmentClip::Rect rect{ 0.f, 640.f, 0.f, 480.f };
+
+	struct Result
+	{
+		std::string kernel;
+		std::size_t accepted;
+		Benchmark::Percentiles ms;
+	};
+
+	class TestSegments
+	{
+	public:
+
+		TestSegments()
+			:
+			x0(segmentsN), y0(segmentsN), x1(segmentsN), y1(segmentsN)
+		{
+			std::mt19937 rng(1);
+			std::uniform_real_distribution<float> distX(rect.l - (rect.r - rect.l), rect.r + (rect.r - rect.l));
+			std::uniform_real_distribution<float> distY(rect.b - (rect.t - rect.b), rect.t + (rect.t - rect.b));
+
+			for(std::size_t i{}; i < segmentsN; ++i)
+			{
+				x0[i] = distX(rng);
+				y0[i] = distY(rng);
+				x1[i] = distX(rng);
+				y1[i] = distY(rng);
+			}
+		}
+
+		SegmentClip::Segments get()
+		{
+			return { x0.data(), y0.data(), x1.data(), y1.data() };
+		}
+
+	private:
+
+		std::vector<float> x0;
+		std::vector<float> y0;
+		std::vector<float> x1;
+		std::vector<float> y1;
+	};
+
+	// clip(in, out, accepted) runs one kernel over all the segments
+	template<typename Clip>
+	Result measure(const std::string& kernel, TestSegments& in, TestSegments& out, std::vector<std::uint8_t>& accepted, Clip clip)
+	{
+		std::vector<double> times;
+		std::size_t acceptedN{};
+
+		for(int run{}; run < 5; ++run)
+		{
+			const auto start = std::chrono::steady_clock::now();
+			acceptedN = clip(in.get(), out.get(), accepted.data());
+			const auto end = std::chrono::steady_clock::now();
+
+			times.push_back(std::chrono::duration<double, std::milli>(end - start).count());
+		}
+
+		return { kernel, acceptedN, Benchmark::getPercentiles(std::move(times)) };
+	}
+
+	inline void run(std::ostream& os)
+	{
+		TestSegments in;
+		TestSegments out;
+		std::vector<std::uint8_t> accepted(segmentsN);
+
+		os << std::right << std::setw(26) << "kernel" << std::setw(12) << "accepted" << std::setw(12) << "p50 ms"
+			<< std::setw(12) << "max ms" << std::setw(12) << "Mseg/s" << '\n';
+
+		os << std::fixed << std::setprecision(3);
+
+		const auto print = [&os](const Result& r) {
+			os << std::setw(26) << r.kernel << std::setw(12) << r.accepted << std::setw(12) << r.ms.p50
+				<< std::setw(12) << r.ms.max << std::setw(12) << segmentsN / r.ms.p50 / 1000.0 << std::endl;
+		};
+
+		for(const auto kernel : { Kernel::cohenSutherland, Kernel::liangBarsky })
+		{
+			const std::string name = kernel == Kernel::cohenSutherland ? "Cohen-Sutherland" : "Liang-Barsky";
+
+			print(measure("scalar " + name, in, out, accepted, [kernel](const SegmentClip::Segments& in, const SegmentClip::Segments& out, std::uint8_t* accepted) {
+				return SegmentClip::clipScalar(in, out, 0, segmentsN, rect, kernel, accepted);
+			}));
+
+			print(measure("batch " + name, in, out, accepted, [kernel](const SegmentClip::Segments& in, const SegmentClip::Segments& out, std::uint8_t* accepted) {
+				return SegmentClip::clip(in, out, segmentsN, rect, kernel, accepted);
+			}));
+		}
+	}
+}
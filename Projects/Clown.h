@@ -1,3 +1,4 @@
+#pragma once
 
 #define _USE_MATH_DEFINES 
 
@@ -6,6 +7,8 @@
 #include <iostream>
 #include <GL/glew.h>
 #include <GL/freeglut.h> 
+#include "SceneRegistry.h"
+#include "Primitives.h"
 #include <random>
 #include <type_traits>
 
@@ -77,7 +80,7 @@ namespace Clown
 		const auto t = std::abs(sin(M_PI / 180 * angle));
 
 		const auto outerSphereR = minOuterR + t * (maxOuterR - minOuterR);
-		glutSolidSphere(outerSphereR, 15, 2);
+		Primitives::drawSolidSphere(outerSphereR, 15, 2);
 
 		glColor3f(eyeColor.R, eyeColor.G, eyeColor.B);
 
@@ -91,7 +94,7 @@ namespace Clown
 		glTranslated(whiteEyeX, whiteEyeY, Z);
 		const auto inSphereR = 0.075f;
 		const auto inSphereROffset = inSphereR + t * (inSphereR * maxMinRatio / 2);
-		glutSolidSphere(inSphereROffset, 15, 2);
+		Primitives::drawSolidSphere(inSphereROffset, 15, 2);
 
 		glPopMatrix();
 	}
@@ -104,7 +107,7 @@ namespace Clown
 		glTranslatef(0.0, 0.0, -9.0);
 
 		glColor3f(0.0, 0.0, 1.0);
-		glutWireSphere(2.0, 20, 20);
+		Primitives::drawWireSphere(2.0, 20, 20);
 
 		glPushMatrix();
 
@@ -114,7 +117,7 @@ namespace Clown
 		glTranslatef(0.f, 0.f, 3.5);
 		glRotatef(220.f, 0.f, 1.f, 0.f);
 		glColor3f(Random<int>::getRandomValue(0, 1), Random<int>::getRandomValue(0, 1), Random<int>::getRandomValue(0, 1));
-		glutWireCone(coneNoseBase, coneNoseHeight, 10, 10);
+		Primitives::drawWireCone(coneNoseBase, coneNoseHeight, 10, 10);
 
 		glPopMatrix();
 
@@ -137,10 +140,10 @@ namespace Clown
 
 		// Hat.
 		glColor3f(0.0, 1.0, 0.0);
-		glutWireCone(2.0, 4.0, 20, 20);
+		Primitives::drawWireCone(2.0, 4.0, 20, 20);
 
 		// Brim.
-		glutWireTorus(0.2, 2.2, 10, 25);
+		Primitives::drawWireTorus(0.2, 2.2, 10, 25);
 
 		glPopMatrix();
 
@@ -150,7 +153,7 @@ namespace Clown
 		glTranslatef(3.5, 0.0, 0.0);
 
 		glColor3f(1.0, 0.0, 0.0);
-		glutWireSphere(0.5, 10, 10);
+		Primitives::drawWireSphere(0.5, 10, 10);
 
 		glPopMatrix();
 
@@ -160,7 +163,7 @@ namespace Clown
 		glTranslatef(-3.5, 0.0, 0.0);
 
 		glColor3f(1.0, 0.0, 0.0);
-		glutWireSphere(0.5, 10, 10);
+		Primitives::drawWireSphere(0.5, 10, 10);
 
 		glPopMatrix();
 
@@ -296,5 +299,7 @@ namespace Clown
 
 		return 0;
 	}
+
+	static SceneRegistry::Registrar registrar{ { "Clown", main, setup, drawScene, resize, keyInput } };
 }
 
@@ -1,3 +1,4 @@
+#pragma once
 
 #define _USE_MATH_DEFINES
 
@@ -5,6 +6,7 @@
 #include <iostream>
 #include <GL/glew.h>
 #include <GL/freeglut.h> 
+#include "SceneRegistry.h"
 #include <vector>
 
 namespace ColoredDisc
@@ -134,4 +136,6 @@ namespace ColoredDisc
 
 		return 0;
 	}
+
+	static SceneRegistry::Registrar registrar{ { "ColoredDisc", main, setup, drawScene, resize, keyInput } };
 }
\ No newline at end of file
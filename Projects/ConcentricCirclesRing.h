@@ -1,3 +1,4 @@
+#pragma once
 /////////////////////////////////////////////////////////////////////         
 // This program draws a circle with glDrawArrays()
 //
@@ -12,6 +13,8 @@
 #include <iostream>
 #include <GL/glew.h>
 #include <GL/freeglut.h> 
+#include "SceneRegistry.h"
+#include "Instancing.h"
 #include <vector>
 #include <random>
 
@@ -23,7 +26,8 @@ namespace ConcentricCirclesRing
 	static int N = 10; 
 	static const float offset = 0.05f;
 	static const int concentricCircles = 1.f / offset;
-	static unsigned int circle;
+	// One circle drawn scaled towards the center once per color
+	static Instancing::Batch circles;
 	static const float lineWidth = 3.f;
 
 	struct RGB
@@ -52,26 +56,38 @@ namespace ConcentricCirclesRing
 		}
 	}
 
-	void initCircles(bool initial = true)
+	void initCircles()
 	{
-		if (initial)
-			circle = glGenLists(1);
-
-		glNewList(circle, GL_COMPILE);
-		glBegin(GL_LINE_STRIP);
+		std::vector<SimdMath::Vec3> positions;
+		std::vector<unsigned int> indices;
 		float t;
 		for (int i = 0; i <= N; ++i)
 		{
 			t = 2 * M_PI * i / N;
-			glVertex3f(X + R * cos(t), Y - R * sin(t), 0.0);
+			positions.push_back(SimdMath::Vec3(X + R * cos(t), Y - R * sin(t), 0.f));
+			indices.push_back(i);
 		}
-		glEnd();
-		glEndList();
+
+		circles.setMesh(GL_LINE_STRIP, positions, indices);
 	}
 
-	void reinitilizeCircles()
+	// Every circle is scaled about the center of the ring
+	void initInstances()
 	{
-		initCircles(false);
+		std::vector<Instancing::Instance> instances;
+
+		for (int i = 0; i < concentricCircles; ++i)
+		{
+			const auto scale = 1.f - offset * i;
+			const auto color = circlesColors[i];
+
+			instances.push_back({
+				SimdMath::Mat4::translation({ X * (1.f - scale), Y * (1.f - scale), 0.f }) * SimdMath::Mat4::scaling({ scale, scale, 1.f }),
+				{ color.R, color.G, color.B }
+			});
+		}
+
+		circles.setInstances(instances);
 	}
 
 	void setup()
@@ -80,29 +96,16 @@ namespace ConcentricCirclesRing
 
 		initColors();
 		initCircles();
+		initInstances();
 	}
 	
-	void drawRingWithColor(float XScale, float YScale, RGB color)
-	{
-		glColor3f(color.R, color.G, color.B);
-		glPushMatrix();
-		glTranslatef(X * (1.f - XScale), Y * (1.f - YScale), 0.f);
-		glScalef(XScale, YScale, 1.f);
-		glCallList(circle);
-		glPopMatrix();
-	}
-
 	void drawScene(void)
 	{
 		glClear(GL_COLOR_BUFFER_BIT);
 
 		glLineWidth(lineWidth);
 
-		for (int i = 0; i < concentricCircles; ++i)
-		{
-			const auto color = circlesColors[i];
-			drawRingWithColor(1.f - 0.05f * i, 1.f - 0.05f * i, color);
-		}
+		circles.draw();
 
 		glFlush();
 	}
@@ -126,14 +129,14 @@ namespace ConcentricCirclesRing
 			break;
 		case '+':
 			N++;
-			reinitilizeCircles();
+			initCircles();
 			glutPostRedisplay();
 			break;
 		case '-':
 			if (N > 3)
 			{
 				N--;
-				reinitilizeCircles();
+				initCircles();
 				glutPostRedisplay();
 			}
 			break;
@@ -173,4 +176,6 @@ namespace ConcentricCirclesRing
 
 		return 0;
 	}
+
+	static SceneRegistry::Registrar registrar{ { "ConcentricCirclesRing", main, setup, drawScene, resize, keyInput } };
 }
\ No newline at end of file
@@ -14,41 +14,53 @@
 #include <iostream>
 #include <GL/glew.h>
 #include <GL/freeglut.h>
+#include "SceneRegistry.h"
+#include <vector>
+#include "SimdMath.h"
 
 namespace Cone
 {
 	static int N;
+	// The apex and then the N + 1 points of the base circle, rebuilt when the amount of sides changes
+	static std::vector<SimdMath::Vec3> fan;
 
-	void drawScene(void)
+	void fillFan()
 	{
 		const float X = 0.f;
 		const float Y = 10.f;
 		const float Z = -20.f;
+		const float R = 20.0;
 
-		float R = 20.0;
-		float t;
-
-		glClear(GL_COLOR_BUFFER_BIT);
-		glColor3f(0.0, 0.0, 0.0);
-
-		glPolygonMode(GL_FRONT_AND_BACK, GL_LINE);
-		glBegin(GL_TRIANGLE_FAN);
+		fan.clear();
+		fan.emplace_back(X, Y, Z);
 
-		glVertex3f(X, Y, Z);
 		for (int i = 0; i <= N; ++i)
 		{
-			t = (2 * M_PI * i / N);
+			const float t = (2 * M_PI * i / N);
 
-			glVertex3f(X + R * cos(t), -20.f, -50.f + R * sin(t));
+			fan.emplace_back(X + R * cos(t), -20.f, -50.f + R * sin(t));
 		}
+	}
+
+	void drawScene(void)
+	{
+		if (fan.size() != static_cast<std::size_t>(N) + 2)
+			fillFan();
+
+		glClear(GL_COLOR_BUFFER_BIT);
+		glColor3f(0.0, 0.0, 0.0);
+
+		glPolygonMode(GL_FRONT_AND_BACK, GL_LINE);
 
-		glEnd();
+		glVertexPointer(3, GL_FLOAT, 0, fan.data());
+		glDrawArrays(GL_TRIANGLE_FAN, 0, fan.size());
 
 		glFlush();
 	}
 
 	void setup(void)
 	{
+		glEnableClientState(GL_VERTEX_ARRAY);
 		glClearColor(1.0, 1.0, 1.0, 0.0);
 	}
 
@@ -153,4 +165,6 @@ namespace Cone
 
 		return 0;
 	}
+
+	static SceneRegistry::Registrar registrar{ { "Cone", main, setup, drawScene, resize, keyInput } };
 }
@@ -14,12 +14,28 @@
 #include <iostream>
 #include <GL/glew.h>
 #include <GL/freeglut.h>
+#include "SceneRegistry.h"
+#include "SimdMath.h"
+#include "ParametricSurface.h"
 
 namespace CrossSectionRing
 {
 	static int N = 3;
 	static int XAngle, YAngle = 55, ZAngle;
 	static int rotateAngle = 5;
+	static ParametricSurface::Mesh mesh;
+
+	// Row 1 is the near rim at z = -30 so the strip starts there, rebuilt when the amount of sides changes
+	void fillMesh()
+	{
+		const float R = 20.0;
+
+		mesh = ParametricSurface::tessellate({ N, 1 }, [=](int i, int j) {
+			const float t = (2 * M_PI * i / N);
+
+			return SimdMath::Vec3(R * cos(t), R * sin(t), j == 0 ? -50.f : -30.f);
+		});
+	}
 
 	void drawScene(void)
 	{
@@ -30,32 +46,23 @@ namespace CrossSectionRing
 		glRotatef(YAngle, 0.f, 1.f, 0.f);
 		glRotatef(ZAngle, 0.f, 0.f, 1.f);
 
-		float R = 20.0;
-		float t;
+		if (mesh.uSlices != N)
+			fillMesh();
 
 		glClear(GL_COLOR_BUFFER_BIT);
 		glColor3f(0.0, 0.0, 0.0);
 
 		glPolygonMode(GL_FRONT_AND_BACK, GL_LINE);
-		glBegin(GL_TRIANGLE_STRIP);
 
-		for (int i = 0; i <= N; ++i)
-		{
-			t = (2 * M_PI * i / N);
-
-			//glVertex3f(20, R * sin(t), -75 + R * cos(t));
-			//glVertex3f(50,   R * sin(t), -75 + R * cos(t));
-			glVertex3f(R * cos(t), R * sin(t), -30.f);
-			glVertex3f(R * cos(t), R * sin(t), -50.f);
-		}
-
-		glEnd();
+		glVertexPointer(3, GL_FLOAT, 0, mesh.positions.data());
+		glDrawElements(GL_TRIANGLE_STRIP, mesh.indices.size(), GL_UNSIGNED_INT, mesh.indices.data());
 
 		glFlush();
 	}
 
 	void setup(void)
 	{
+		glEnableClientState(GL_VERTEX_ARRAY);
 		glClearColor(1.0, 1.0, 1.0, 0.0);
 	}
 
@@ -193,4 +200,6 @@ namespace CrossSectionRing
 
 		return 0;
 	}
+
+	static SceneRegistry::Registrar registrar{ { "CrossSectionRing", main, setup, drawScene, resize, keyInput } };
 }
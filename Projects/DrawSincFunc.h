@@ -1,3 +1,4 @@
+#pragma once
 ///////////////////////////////////////////////////////////////////////////////////////          
 //Draw sinc function
 /////////////////////////////////////////////////////////////////////////////////////// 
@@ -9,6 +10,7 @@
 #include <iostream>
 #include <GL/glew.h>
 #include <GL/freeglut.h>
+#include "SceneRegistry.h"
 
 namespace DrawSincFunc
 {
@@ -283,4 +285,5 @@ namespace DrawSincFunc
 		return 0;
 	}
 
+	static SceneRegistry::Registrar registrar{ { "DrawSincFunc", main, setup, drawScene, resize, keyInput } };
 }
@@ -1,3 +1,4 @@
+#pragma once
 
 #define _USE_MATH_DEFINES
 
@@ -7,9 +8,12 @@
 #include <fstream>
 #include <GL/glew.h>
 #include <GL/freeglut.h> 
+#include "SceneRegistry.h"
+#include "Primitives.h"
+#include "SimdMath.h"
+#include "FrameClock.h"
 #include <vector>
 #include <functional>
-#include <chrono>
 #include <vector>
 #include <utility>
 #include <string>
@@ -27,60 +31,15 @@ namespace FallingBallAndWater
 	static float drag = 1.5;
 	static uint16_t gravityHandlerId;
 
-	std::chrono::system_clock::time_point tp;
+	FrameClock::Stopwatch stopwatch;
 
-	struct Vector
-	{
-		Vector(float pX = 0.f, float pY = 0.f, float pZ = 0.f)
-			:
-			X{ pX },
-			Y{ pY },
-			Z{ pZ }
-		{
-
-		}
-
-		float length() const noexcept
-		{
-			return std::sqrt(X * X + Y * Y + Z * Z);
-		}
-
-		Vector& operator+=(const Vector& rhs) noexcept
-		{
-			return *this = *this + rhs;;
-		}
-
-		Vector operator+(const Vector& rhs) const noexcept
-		{
-			return { X + rhs.X, Y + rhs.Y, Z + rhs.Z };
-		}
-
-		Vector operator*(float v) const noexcept
-		{
-			return { X * v, Y * v, Z * v };
-		}
-
-		float X;
-		float Y;
-		float Z;
-	};
-
-	Vector normalize(const Vector& v)
-	{
-		return { v.X / v.length(), v.Y / v.length(), v.Z / v.length() };
-	}
+	using Vector = SimdMath::Vec3;
 
 	bool isNearlyEqual(float a, float b, float e)
 	{
 		return (a - b) < e;
 	}
 
-	std::ostream& operator<<(std::ostream& os, const Vector& v)
-	{
-		os << "X: " << v.X << " Y: " << v.Y << " Z: " << v.Z;
-		return os;
-	}
-
 	struct Rotation
 	{
 		Rotation(float pAngle = 0, const Vector& pDirs = Vector{})
@@ -299,7 +258,7 @@ private:
 			glPushMatrix();
 			glTranslated(loc.X, loc.Y, loc.Z);
 			glColor3d(1.0, 0.0, 0.0);
-			glutSolidSphere(radius, 20, 20);
+			Primitives::drawSolidSphere(radius, 20, 20);
 			glPopMatrix();
 		}
 
@@ -478,7 +437,7 @@ private:
 			glTranslated(loc.X, loc.Y, loc.Z);
 			glScaled(scale.X, scale.Y, scale.Z);
 
-			glutSolidCube(size);
+			Primitives::drawSolidCube(size);
 			glPopMatrix();
 		}
 
@@ -514,14 +473,10 @@ private:
 
 	void drawScene(void)
 	{
-		using namespace std::chrono;
-
 		glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 		glLoadIdentity();
 
-		auto d = duration_cast<milliseconds>(system_clock::now() - tp);
-		auto deltaTime = float(d.count()) * milliseconds::period::num / milliseconds::period::den;
-		tp = system_clock::now();
+		const auto deltaTime = stopwatch.tick();
 
 		tick(deltaTime);
 		checkCollide();
@@ -573,7 +528,7 @@ private:
 	{
 		glClearColor(1.0, 1.0, 1.0, 0.0);
 		glEnable(GL_DEPTH_TEST);
-		tp = std::chrono::system_clock::now();
+		stopwatch.reset();
 		initActors();
 	}
 
@@ -599,7 +554,7 @@ private:
 
 			if (isAnimate)
 			{
-				tp = std::chrono::system_clock::now();
+				stopwatch.reset();
 				animate(1);
 			}
 			break;
@@ -648,4 +603,6 @@ private:
 
 		return 0;
 	}
+
+	static SceneRegistry::Registrar registrar{ { "FallingBallAndWater", main, setup, drawScene, resize, keyInput } };
 }
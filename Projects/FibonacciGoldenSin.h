@@ -1,3 +1,4 @@
+#pragma once
 ///////////////////////////////////////////////////////////////////////////////////////          
 //Example of Canvas here
 /////////////////////////////////////////////////////////////////////////////////////// 
@@ -9,6 +10,8 @@
 #include <iostream>
 #include <GL/glew.h>
 #include <GL/freeglut.h>
+#include "SceneRegistry.h"
+#include "LineBatch.h"
 #include <memory>
 
 namespace FibonacciGoldenSin
@@ -212,6 +215,14 @@ namespace FibonacciGoldenSin
 			glewExperimental = GL_TRUE;
 			glewInit();
 
+			Setup(width, height);
+		}
+
+		void Setup(int pWidth, int pHeight)
+		{
+			width = pWidth;
+			height = pHeight;
+
 			SetWindow(0.f, width, 0.f, height);
 			SetViewport(0.f, width, 0.f, height);
 			CP.Set(0.f, 0.f);
@@ -219,6 +230,7 @@ namespace FibonacciGoldenSin
 		
 		void SetWindow(float l, float r, float b, float t)
 		{
+			lines.flush();
 			glMatrixMode(GL_PROJECTION);
 			glLoadIdentity();
 			gluOrtho2D(l, r, b, t);
@@ -227,6 +239,7 @@ namespace FibonacciGoldenSin
 
 		void SetViewport(int l, int r, int b, int t)
 		{
+			lines.flush();
 			glViewport(l, b, r - l, t - b);
 			viewport.Set(l, r, b, t);
 		}
@@ -251,6 +264,8 @@ namespace FibonacciGoldenSin
 
 		void ClearScreen()
 		{
+			// The segments not drawn yet would be cleared anyway
+			lines.clear();
 			glClear(GL_COLOR_BUFFER_BIT);
 		}
 
@@ -262,18 +277,13 @@ namespace FibonacciGoldenSin
 		void SetColor(float r, float g, float b)
 		{
 			glColor3f(r, g, b);
+			lines.setColor(r, g, b);
 		}
 
 		void LineTo(float x, float y)
 		{
-			glBegin(GL_LINES);
-				glVertex2f(CP.X, CP.Y);
-				glVertex2f(x, y);
-			glEnd();
-
+			lines.add(CP.X, CP.Y, x, y);
 			CP.Set(x, y);
-
-			glFlush();
 		}
 
 		void LineTo(const Point2& p)
@@ -281,6 +291,13 @@ namespace FibonacciGoldenSin
 			LineTo(p.X, p.Y);
 		}		
 
+		// Draws the segments added since the last call
+		void Flush()
+		{
+			lines.flush();
+			glFlush();
+		}
+
 		void MoveTo(float x, float y)
 		{
 			CP.Set(x, y);
@@ -308,6 +325,7 @@ namespace FibonacciGoldenSin
 		Point2 CP;
 		IntRect viewport;
 		FloatRect window;
+		LineBatch::Batch lines;
 		
 		float width;
 		float height;
@@ -359,6 +377,8 @@ namespace FibonacciGoldenSin
 				const auto y = seq[i];
 				cvs.LineTo(x, y);
 			}
+
+			cvs.Flush();
 		}
 
 		private:
@@ -402,6 +422,14 @@ namespace FibonacciGoldenSin
 	}
 
 	
+	void setup()
+	{
+		auto& cvs = Canvas::Get();
+		cvs.Setup(640, 480);
+		cvs.SetBackgroundColor(1.f, 1.f, 1.f);
+		GraphImpl::Get().SetGraphAlgo(GRAPH_ALGO::FIBO_RABBITS, 20);
+	}
+
 	int main(int argc, char** argv)
 	{
 		if(argc != 3)
@@ -462,4 +490,5 @@ namespace FibonacciGoldenSin
 		return 0;
 	}
 
+	static SceneRegistry::Registrar registrar{ { "FibonacciGoldenSin", main, setup, Display, Canvas::Resize, Canvas::KeyInput } };
 }
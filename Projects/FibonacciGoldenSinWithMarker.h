@@ -1,3 +1,4 @@
+#pragma once
 ///////////////////////////////////////////////////////////////////////////////////////          
 //Example of some draw graphs
 /////////////////////////////////////////////////////////////////////////////////////// 
@@ -9,6 +10,8 @@
 #include <iostream>
 #include <GL/glew.h>
 #include <GL/freeglut.h>
+#include "SceneRegistry.h"
+#include "LineBatch.h"
 
 namespace FibonacciGoldenSinWithMarker
 {
@@ -246,12 +249,21 @@ namespace FibonacciGoldenSinWithMarker
 			glewExperimental = GL_TRUE;
 			glewInit();
 
+			Setup(width, height);
+		}
+
+		void Setup(int pWidth, int pHeight)
+		{
+			width = pWidth;
+			height = pHeight;
+
 			SetWindow(0.f, width, 0.f, height);
 			CP.Set(0.f, 0.f);
 		}
 		
 		void SetWindow(float l, float r, float b, float t)
 		{
+			lines.flush();
 			glMatrixMode(GL_PROJECTION);
 			glLoadIdentity();
 			gluOrtho2D(l, r, b, t);
@@ -260,6 +272,7 @@ namespace FibonacciGoldenSinWithMarker
 
 		void SetViewport(int l, int r, int b, int t)
 		{
+			lines.flush();
 			glViewport(l, b, r - l, t - b);
 			viewport.Set(l, r, b, t);
 		}
@@ -292,6 +305,8 @@ namespace FibonacciGoldenSinWithMarker
 
 		void ClearScreen()
 		{
+			// The segments not drawn yet would be cleared anyway
+			lines.clear();
 			glClear(GL_COLOR_BUFFER_BIT);
 		}
 
@@ -303,6 +318,7 @@ namespace FibonacciGoldenSinWithMarker
 		void SetColor(float r, float g, float b)
 		{
 			glColor3f(r, g, b);
+			lines.setColor(r, g, b);
 		}
 
 		void CountMinMaxCoords(float x, float y)
@@ -316,11 +332,7 @@ namespace FibonacciGoldenSinWithMarker
 
 		void LineTo(float x, float y)
 		{
-			glBegin(GL_LINES);
-				glVertex2f(CP.X, CP.Y);
-				glVertex2f(x, y);
-			glEnd();
-
+			lines.add(CP.X, CP.Y, x, y);
 			CP.Set(x, y);
 			
 			CountMinMaxCoords(x, y);
@@ -331,6 +343,13 @@ namespace FibonacciGoldenSinWithMarker
 			LineTo(p.X, p.Y);
 		}		
 
+		// Draws the segments added since the last call
+		void Flush()
+		{
+			lines.flush();
+			glFlush();
+		}
+
 		void MoveTo(float x, float y)
 		{
 			CP.Set(x, y);
@@ -445,6 +464,7 @@ namespace FibonacciGoldenSinWithMarker
 		Point2 CP;
 		IntRect viewport;
 		FloatRect window;
+		LineBatch::Batch lines;
 		
 		float width;
 		float height;
@@ -545,6 +565,8 @@ namespace FibonacciGoldenSinWithMarker
 				cvs.LineTo(x, y);
 				Star(0.2f, 0.3f, 0.2f, 0.1f);
 			}
+
+			cvs.Flush();
 			
 			if(cvs.IsShouldFitAgain())
 			{
@@ -675,6 +697,14 @@ namespace FibonacciGoldenSinWithMarker
 		std::cout << "And of course quit with (ESC) button\n";
 	}
 
+	void setup()
+	{
+		auto& cvs = Canvas::Get();
+		cvs.Setup(640, 480);
+		cvs.SetBackgroundColor(1.f, 1.f, 1.f);
+		GraphImpl::Get().SetGraphAlgo(GRAPH_ALGO::FIBO_RABBITS, 20);
+	}
+
 	int main(int argc, char** argv)
 	{
 		if(argc != 3)
@@ -735,4 +765,5 @@ namespace FibonacciGoldenSinWithMarker
 		return 0;
 	}
 
+	static SceneRegistry::Registrar registrar{ { "FibonacciGoldenSinWithMarker", main, setup, Display, Canvas::Resize, Canvas::KeyInput } };
 }
@@ -1,9 +1,12 @@
+#pragma once
 #define _USE_MATH_DEFINES
 
 #include <iostream>
 #include <cmath>
 #include <GL/glew.h>
 #include <GL/freeglut.h> 
+#include "SceneRegistry.h"
+#include "SimdMath.h"
 
 namespace FlyingCameraOnSphere
 {
@@ -15,76 +18,11 @@ namespace FlyingCameraOnSphere
 	const std::size_t p{30};
 	const std::size_t q{30};
 
-	struct Vector
-	{
-		Vector(float pX = 0.f, float pY = 0.f, float pZ = 0.f)
-			:
-			X{ pX },
-			Y{ pY },
-			Z{ pZ }
-		{
-
-		}
-
-		float length() const noexcept
-		{
-			return std::sqrt(X * X + Y * Y + Z * Z);
-		}
-
-		Vector& operator+=(const Vector& rhs) noexcept
-		{
-			return *this = *this + rhs;;
-		}
-
-		Vector& operator-=(const Vector& rhs) noexcept
-		{
-			return *this = *this - rhs;;
-		}
-
-		Vector operator+(const Vector& rhs) const noexcept
-		{
-			return { X + rhs.X, Y + rhs.Y, Z + rhs.Z };
-		}
-
-		Vector operator-(const Vector& rhs) const noexcept
-		{
-			return { X - rhs.X, Y - rhs.Y, Z - rhs.Z };
-		}
-
-		Vector operator*(float v) const noexcept
-		{
-			return { X * v, Y * v, Z * v };
-		}
-
-		float X;
-		float Y;
-		float Z;
-	};
-
-	Vector operator*(float scalar, const Vector& rhs)
-	{
-		return rhs * scalar;
-	}
-
-	std::ostream& operator<<(std::ostream& os, const Vector& v)
-	{
-		os << "X: " << v.X << " Y: " << v.Y << " Z: " << v.Z;
-		return os;
-	}
-
-	float scalarProduct(const Vector& lhs, const Vector& rhs)
-	{
-		return lhs.X * rhs.X + lhs.Y * rhs.Y + lhs.Z * rhs.Z;
-	}
+	using Vector = SimdMath::Vec3;
 
 	Vector perpOfScalarProduct(const Vector& on, const Vector& of)
 	{
-		return of - (scalarProduct(on, of) / (on.length() * of.length())) * on;
-	}
-
-	Vector normalize(const Vector& v)
-	{
-		return v * (1.f / v.length());
+		return of - (dot(on, of) / (on.length() * of.length())) * on;
 	}
 
 	template<typename T>
@@ -287,5 +225,7 @@ namespace FlyingCameraOnSphere
 
 		return 0;
 	}
+
+	static SceneRegistry::Registrar registrar{ { "FlyingCameraOnSphere", main, setup, drawScene, resize, keyInput } };
 }
 
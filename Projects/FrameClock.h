@@ -0,0 +1,43 @@
+#pragma once
+///////////////////////////////////////////////////////////////////////////////////////
+// Frame timing for the animated scenes.
+//
+// Stopwatch::tick() returns the seconds since the previous tick measured with
+// steady_clock, or the fixed timestep when one is set (benchmarks use it so the
+// same frames are simulated on every run no matter how long they take).
+///////////////////////////////////////////////////////////////////////////////////////
+
+#include <chrono>
+
+namespace FrameClock
+{
+	// Seconds every tick() reports instead of the measured time, 0 means real time
+	inline float& fixedTimestep()
+	{
+		static float timestep{};
+		return timestep;
+	}
+
+	struct Stopwatch
+	{
+		using Clock = std::chrono::steady_clock;
+
+		void reset()
+		{
+			tp = Clock::now();
+		}
+
+		float tick()
+		{
+			const auto now = Clock::now();
+			const auto elapsed = std::chrono::duration<float>(now - tp).count();
+			tp = now;
+
+			return fixedTimestep() > 0.f ? fixedTimestep() : elapsed;
+		}
+
+	private:
+
+		Clock::time_point tp{ Clock::now() };
+	};
+}
@@ -0,0 +1,158 @@
+#pragma once
+///////////////////////////////////////////////////////////////////////////////////////
+// Counters read by the benchmarks around every frame: draw calls and heap
+// allocations.
+//
+// Draw calls are counted by redirecting the GL draw entry points to counting
+// wrappers with macros, so this header must come after <GL/glew.h> and before
+// any scene; a multi-draw or instanced call counts as one call, like the
+// driver sees it. Allocations are counted by replacing the global operator new.
+// Include it from exactly one .cpp file, the same way as Scenes.h.
+///////////////////////////////////////////////////////////////////////////////////////
+
+#include <new>
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <GL/glew.h>
+
+namespace FrameCounters
+{
+	struct Counters
+	{
+		std::uint64_t drawCalls;
+		std::uint64_t allocations;
+	};
+
+	inline std::atomic<std::uint64_t>& drawCallsCounter()
+	{
+		static std::atomic<std::uint64_t> counter{};
+		return counter;
+	}
+
+	inline std::atomic<std::uint64_t>& allocationsCounter()
+	{
+		static std::atomic<std::uint64_t> counter{};
+		return counter;
+	}
+
+	inline Counters get()
+	{
+		return { drawCallsCounter().load(std::memory_order_relaxed), allocationsCounter().load(std::memory_order_relaxed) };
+	}
+
+	inline void countDrawCall()
+	{
+		drawCallsCounter().fetch_add(1, std::memory_order_relaxed);
+	}
+
+	inline void begin(GLenum mode)
+	{
+		countDrawCall();
+		glBegin(mode);
+	}
+
+	inline void callList(GLuint list)
+	{
+		countDrawCall();
+		glCallList(list);
+	}
+
+	inline void callLists(GLsizei n, GLenum type, const void* lists)
+	{
+		countDrawCall();
+		glCallLists(n, type, lists);
+	}
+
+	inline void drawArrays(GLenum mode, GLint first, GLsizei count)
+	{
+		countDrawCall();
+		glDrawArrays(mode, first, count);
+	}
+
+	inline void drawElements(GLenum mode, GLsizei count, GLenum type, const void* indices)
+	{
+		countDrawCall();
+		glDrawElements(mode, count, type, indices);
+	}
+
+	inline void multiDrawArrays(GLenum mode, const GLint* first, const GLsizei* count, GLsizei drawcount)
+	{
+		countDrawCall();
+		glMultiDrawArrays(mode, first, count, drawcount);
+	}
+
+	inline void multiDrawElements(GLenum mode, const GLsizei* count, GLenum type, const void* const* indices, GLsizei drawcount)
+	{
+		countDrawCall();
+		glMultiDrawElements(mode, count, type, indices, drawcount);
+	}
+
+	inline void drawArraysInstanced(GLenum mode, GLint first, GLsizei count, GLsizei instancecount)
+	{
+		countDrawCall();
+		glDrawArraysInstanced(mode, first, count, instancecount);
+	}
+
+	inline void drawElementsInstanced(GLenum mode, GLsizei count, GLenum type, const void* indices, GLsizei instancecount)
+	{
+		countDrawCall();
+		glDrawElementsInstanced(mode, count, type, indices, instancecount);
+	}
+
+	inline void multiDrawArraysIndirect(GLenum mode, const void* indirect, GLsizei drawcount, GLsizei stride)
+	{
+		countDrawCall();
+		glMultiDrawArraysIndirect(mode, indirect, drawcount, stride);
+	}
+
+	inline void multiDrawElementsIndirect(GLenum mode, GLenum type, const void* indirect, GLsizei drawcount, GLsizei stride)
+	{
+		countDrawCall();
+		glMultiDrawElementsIndirect(mode, type, indirect, drawcount, stride);
+	}
+}
+
+#undef glBegin
+#undef glCallList
+#undef glCallLists
+#undef glDrawArrays
+#undef glDrawElements
+#undef glMultiDrawArrays
+#undef glMultiDrawElements
+#undef glDrawArraysInstanced
+#undef glDrawElementsInstanced
+#undef glMultiDrawArraysIndirect
+#undef glMultiDrawElementsIndirect
+
+#define glBegin FrameCounters::begin
+#define glCallList FrameCounters::callList
+#define glCallLists FrameCounters::callLists
+#define glDrawArrays FrameCounters::drawArrays
+#define glDrawElements FrameCounters::drawElements
+#define glMultiDrawArrays FrameCounters::multiDrawArrays
+#define glMultiDrawElements FrameCounters::multiDrawElements
+#define glDrawArraysInstanced FrameCounters::drawArraysInstanced
+#define glDrawElementsInstanced FrameCounters::drawElementsInstanced
+#define glMultiDrawArraysIndirect FrameCounters::multiDrawArraysIndirect
+#define glMultiDrawElementsIndirect FrameCounters::multiDrawElementsIndirect
+
+void* operator new(std::size_t size)
+{
+	FrameCounters::allocationsCounter().fetch_add(1, std::memory_order_relaxed);
+
+	if(const auto ptr = std::malloc(size == 0 ? 1 : size))
+		return ptr;
+
+	throw std::bad_alloc{};
+}
+
+void operator delete(void* ptr) noexcept
+{
+	std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept
+{
+	std::free(ptr);
+}
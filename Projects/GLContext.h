@@ -0,0 +1,56 @@
+#pragma once
+///////////////////////////////////////////////////////////////////////////////////////
+// Which OpenGL context the objects kept between frames belong to.
+//
+// Buffer, vertex array and program names only mean something in the context
+// that made them, and the headless launcher makes a new context sharing nothing
+// for every scene. Each context gets a new generation: whatever keeps GL names
+// across scenes remembers the generation it made them in, makes them again in
+// another one and deletes them only while its own is still current.
+//
+// Offscreen::Context begins and ends its generations. The glut window is
+// generation 1, main() ends it when the program exits, so the names still held
+// by statics then are left to the window system.
+///////////////////////////////////////////////////////////////////////////////////////
+
+namespace GLContext
+{
+	namespace Detail
+	{
+		struct Generations
+		{
+			unsigned current = 1;
+			unsigned last = 1;
+		};
+
+		inline Generations& getGenerations()
+		{
+			static Generations generations;
+			return generations;
+		}
+	}
+
+	// The generation of the current context, 0 when there is none
+	inline unsigned getGeneration() noexcept
+	{
+		return Detail::getGenerations().current;
+	}
+
+	inline bool isCurrent(unsigned generation) noexcept
+	{
+		return generation != 0 && generation == getGeneration();
+	}
+
+	// A new context was made current
+	inline void begin() noexcept
+	{
+		auto& generations = Detail::getGenerations();
+		generations.current = ++generations.last;
+	}
+
+	// The current context is about to be destroyed
+	inline void end() noexcept
+	{
+		Detail::getGenerations().current = 0;
+	}
+}
@@ -1,3 +1,4 @@
+#pragma once
 //////////////////////////////////////////////////////////////////////////         
 // This program shows how to create simple menus with GLUT
 //////////////////////////////////////////////////////////////////////////
@@ -6,6 +7,7 @@
 
 #include <GL/glew.h>
 #include <GL/freeglut.h> 
+#include "SceneRegistry.h"
 #include <array>
 
 namespace GlutMenuTest
@@ -185,4 +187,6 @@ namespace GlutMenuTest
 
 		return 0;
 	}
+
+	static SceneRegistry::Registrar registrar{ { "GlutMenuTest", main, setup, drawScene, resize, keyInput } };
 }
\ No newline at end of file
@@ -1,3 +1,4 @@
+#pragma once
 ///////////////////////////////////////////////////////////////////////////////////////          
 //Example of usage divine proportion with sequence of golden rectangles
 /////////////////////////////////////////////////////////////////////////////////////// 
@@ -9,6 +10,8 @@
 #include <iostream>
 #include <GL/glew.h>
 #include <GL/freeglut.h>
+#include "SceneRegistry.h"
+#include "LineBatch.h"
 
 namespace GoldenRectanglesRegression
 {
@@ -126,6 +129,14 @@ namespace GoldenRectanglesRegression
 			glewExperimental = GL_TRUE;
 			glewInit();
 
+			Setup(width, height);
+		}
+
+		void Setup(int pWidth, int pHeight)
+		{
+			width = pWidth;
+			height = pHeight;
+
 			SetWindow(0.f, width, 0.f, height);
 			SetViewport(0.f, width, 0.f, height);
 			CP.Set(0.f, 0.f);
@@ -133,6 +144,7 @@ namespace GoldenRectanglesRegression
 		
 		void SetWindow(float l, float r, float b, float t)
 		{
+			lines.flush();
 			glMatrixMode(GL_PROJECTION);
 			glLoadIdentity();
 			gluOrtho2D(l, r, b, t);
@@ -141,6 +153,7 @@ namespace GoldenRectanglesRegression
 
 		void SetViewport(int l, int r, int b, int t)
 		{
+			lines.flush();
 			viewport.Set(l, r, b, t);
 			glViewport(l, b, r - l, t - b);
 		}
@@ -165,6 +178,8 @@ namespace GoldenRectanglesRegression
 
 		void ClearScreen()
 		{
+			// The segments not drawn yet would be cleared anyway
+			lines.clear();
 			glClear(GL_COLOR_BUFFER_BIT);
 		}
 
@@ -176,18 +191,13 @@ namespace GoldenRectanglesRegression
 		void SetColor(float r, float g, float b)
 		{
 			glColor3f(r, g, b);
+			lines.setColor(r, g, b);
 		}
 
 		void LineTo(float x, float y)
 		{
-			glBegin(GL_LINES);
-				glVertex2f(CP.X, CP.Y);
-				glVertex2f(x, y);
-			glEnd();
-
+			lines.add(CP.X, CP.Y, x, y);
 			CP.Set(x, y);
-
-			glFlush();
 		}
 
 		void LineTo(const Point2& p)
@@ -195,6 +205,13 @@ namespace GoldenRectanglesRegression
 			LineTo(p.X, p.Y);
 		}		
 
+		// Draws the segments added since the last call
+		void Flush()
+		{
+			lines.flush();
+			glFlush();
+		}
+
 		void MoveTo(float x, float y)
 		{
 			CP.Set(x, y);
@@ -266,6 +283,7 @@ namespace GoldenRectanglesRegression
 		Point2 CP;
 		IntRect viewport;
 		FloatRect window;
+		LineBatch::Batch lines;
 		
 		float width;
 		float height;
@@ -340,6 +358,8 @@ namespace GoldenRectanglesRegression
 
 		DrawRectangleAt(cvs, StartPoint, widthHeight.first, widthHeight.second);
 		DrawRectanglesRegression(cvs, widthHeight);
+
+		cvs.Flush();
 	}
 	
 	void printInteraction()
@@ -348,6 +368,13 @@ namespace GoldenRectanglesRegression
 		std::cout << "Press (ESC) to quit\n";
 	}
 
+	void setup()
+	{
+		auto& cvs = Canvas::Get();
+		cvs.Setup(640, 480);
+		cvs.SetBackgroundColor(1.f, 1.f, 1.f);
+	}
+
 	int main(int argc, char** argv)
 	{
 		printInteraction();
@@ -362,4 +389,5 @@ namespace GoldenRectanglesRegression
 		return 0;
 	}
 
+	static SceneRegistry::Registrar registrar{ { "GoldenRectanglesRegression", main, setup, Display, Canvas::Resize, Canvas::KeyInput } };
 }
@@ -1,82 +1,28 @@
+#pragma once
+///////////////////////////////////////////////////////////////////////////////////////
+// This program draws a circle of half-star sectors
+//
+// Interaction:
+// Press space to toggle the wireframe.
+// Press +/- to add or remove a sector.
+// Press >/< to grow or shrink the inner circle.
+///////////////////////////////////////////////////////////////////////////////////////
+
 #include <GL/glew.h>
 #include <GL/freeglut.h> 
+#include "SceneRegistry.h"
+#include "SimdMath.h"
+#include "ArcGenerator.h"
+#include "GLContext.h"
 #include <iostream>
 #include <vector>
 #include <cmath>
-#include <numeric>
+#include <cstddef>
+#include <algorithm>
 
 namespace HalfStarCircle
 {
-	struct Vector
-	{
-	Vector(float pX = 0.f, float pY = 0.f, float pZ = 0.f)
-		:
-		X{ pX },
-		Y{ pY },
-		Z{ pZ }
-	{
-
-	}
-
-	float length() const noexcept
-	{
-		return std::sqrt(X * X + Y * Y + Z * Z);
-	}
-
-	Vector& operator+=(const Vector& rhs) noexcept
-	{
-		return *this = *this + rhs;;
-	}
-
-	Vector& operator-=(const Vector& rhs) noexcept
-	{
-		return *this = *this - rhs;;
-	}
-
-	Vector operator+(const Vector& rhs) const noexcept
-	{
-		return { X + rhs.X, Y + rhs.Y, Z + rhs.Z };
-	}
-
-	Vector operator-(const Vector& rhs) const noexcept
-	{
-		return { X - rhs.X, Y - rhs.Y, Z - rhs.Z };
-	}
-
-	Vector operator*(float v) const noexcept
-	{
-		return { X * v, Y * v, Z * v };
-	}
-
-	bool operator==(const Vector& rhs) const noexcept
-	{
-		return (X == rhs.X) && (Y == rhs.Y) && (Z == rhs.Z);
-	}
-
-	bool operator!=(const Vector& rhs) const noexcept
-	{
-		return !(*this == rhs);
-	}
-
-		float X;
-		float Y;
-		float Z;
-	};
-
-
-	inline float dotProduct(const Vector& lhs, const Vector& rhs)
-	{
-		return lhs.X * rhs.X + lhs.Y * rhs.Y + lhs.Z * rhs.Z;
-	}
-
-	inline float getAngleBetweenVectors(const Vector& lhs, const Vector& rhs)
-	{
-	const auto scalarProduct = dotProduct(lhs, rhs);
-	const auto lengthsMult = lhs.length() * rhs.length();
-
-	return acosf(scalarProduct / lengthsMult) / M_PI * 180;
-
-	}
+	using Vector = SimdMath::Vec3;
 
 
 	struct HalfStarCircle
@@ -86,23 +32,48 @@ namespace HalfStarCircle
 		wireFrame{},
 		innerR{15.f},
 		outerR{30.f},
-		center{}
+		sectorsN{6},
+		center{},
+		mesh{},
+		meshDirty{true}
 		{
 
 		}
 
+		// The objects are made once per context, setup may run again in the same one
 		void init()
 		{
-			glEnableClientState(GL_VERTEX_ARRAY);
+			if(!GLContext::isCurrent(mesh.context))
+			{
+				mesh.context = GLContext::getGeneration();
+
+				glGenVertexArrays(1, &mesh.vertexArray);
+				glGenBuffers(1, &mesh.buffer);
+
+				glBindVertexArray(mesh.vertexArray);
+				glBindBuffer(GL_ARRAY_BUFFER, mesh.buffer);
+				glEnableClientState(GL_VERTEX_ARRAY);
+				glEnableClientState(GL_COLOR_ARRAY);
+				glVertexPointer(3, GL_FLOAT, sizeof(MeshVertex), reinterpret_cast<void*>(offsetof(MeshVertex, position)));
+				glColorPointer(3, GL_FLOAT, sizeof(MeshVertex), reinterpret_cast<void*>(offsetof(MeshVertex, color)));
+				glBindVertexArray(0);
+				glBindBuffer(GL_ARRAY_BUFFER, 0);
+			}
+
+			buildMesh();
 		}
 
-		void draw() const
+		void draw()
 		{
+			if(meshDirty)
+				buildMesh();
+
 			glPolygonMode(GL_FRONT_AND_BACK, wireFrame ? GL_LINE : GL_FILL);
-			drawOutlineCircles();
-			drawStarParts();
-			drawOutlineParts();
-			
+
+			glBindVertexArray(mesh.vertexArray);
+			glMultiDrawArrays(GL_TRIANGLE_STRIP, mesh.stripFirsts.data(), mesh.stripCounts.data(), mesh.stripCounts.size());
+			glMultiDrawArrays(GL_TRIANGLE_FAN, mesh.fanFirsts.data(), mesh.fanCounts.data(), mesh.fanCounts.size());
+			glBindVertexArray(0);
 		}
 
 		void toggleWireframeMode()
@@ -111,154 +82,124 @@ namespace HalfStarCircle
 			glutPostRedisplay();
 		}
 
-		private:
-
-		std::vector<std::vector<Vector>> getSectorsVertices(bool isStarsSectors) const
+		float getInnerR() const noexcept
 		{
-			std::vector<std::vector<Vector>> r; 
-
-			std::vector<Vector> innerCirclePoints;
-			std::vector<Vector> outerCirclePoints;
-
-			if(isStarsSectors)
-			{
-				innerCirclePoints = getStarInnerCirclePoints();
-				outerCirclePoints = getStarOuterCirclePoints();
-			}
-			else
-			{
-				outerCirclePoints = getStarInnerCirclePoints();
-				innerCirclePoints = getStarOuterCirclePoints();
-				innerCirclePoints.insert(innerCirclePoints.begin(), innerCirclePoints.back());
-				innerCirclePoints.pop_back();
-			}
-
-			r.reserve(outerCirclePoints.size());
-			for(int i{}; i < outerCirclePoints.size(); ++i)
-			{
-				std::vector<Vector> sector;
-				const auto N = 7;
-				sector.reserve(N + 1);
-				sector.push_back(outerCirclePoints[i]);
-				const auto arcPoints = getArcPointsFromTo(
-					center,
-					getAngleOfVectorInRad(innerCirclePoints[i]), 
-					getAngleOfVectorInRad(innerCirclePoints[i == 5 ? 0 : i + 1]) + ((i == 5) ? 2.f * M_PI : 0.f),
-					isStarsSectors ? getStarR() : getOuterR(),
-					N
-				);
-
-				for(const auto& i : arcPoints)
-					sector.push_back(i);
-
-				r.push_back(sector);
-			}
+			return innerR;
+		}
 
-			return r;
+		int getSectorsN() const noexcept
+		{
+			return sectorsN;
 		}
 
-		void drawSectors(bool isStarsSectors) const
+		// The setters of the shape only mark the mesh, it is rebuilt by the next draw
+		void setRadii(float pInnerR, float pOuterR)
 		{
-			const auto sectorsVertices = getSectorsVertices(isStarsSectors);
+			innerR = pInnerR;
+			outerR = pOuterR;
+			invalidateMesh();
+		}
 
-			const auto vertices = getFilledVertices(sectorsVertices);
-			glVertexPointer(3, GL_FLOAT, 0, vertices.data());
-			const auto first = getFilledFirst(sectorsVertices);
-			const auto count = getFilledCount(sectorsVertices);
+		void setSectorsN(int pSectorsN)
+		{
+			sectorsN = pSectorsN;
+			invalidateMesh();
+		}
 
-			if(isStarsSectors)
-				glColor3f(1.f, 1.f, 0.f);
-			else
-				glColor3f(1.f, 0.f, 1.f);
+		private:
 
-			glMultiDrawArrays(GL_TRIANGLE_FAN, first.data(), count.data(), count.size());
-		}
+		struct MeshVertex
+		{
+			Vector position;
+			Vector color;
+		};
 
-		void drawStarParts() const
-		{	
-			drawSectors(true);
-		}
-		
-		void drawOutlineParts() const
+		// The outline circles as triangle strips and the sectors as triangle fans in one vertex buffer
+		struct StarMesh
 		{
-			drawSectors(false);
+			unsigned context;
+			GLuint vertexArray;
+			GLuint buffer;
+			std::vector<GLint> stripFirsts;
+			std::vector<GLsizei> stripCounts;
+			std::vector<GLint> fanFirsts;
+			std::vector<GLsizei> fanCounts;
+		};
+
+		void invalidateMesh()
+		{
+			meshDirty = true;
+			glutPostRedisplay();
 		}
 
-		float getAngleOfVectorInRad(const Vector& p) const 
+		void buildMesh()
 		{
-			auto r = getAngleBetweenVectors(p, {1.f, 0.f}) * M_PI / 180.f;
+			std::vector<MeshVertex> vertices;
 
-			if((p.X < 0.f) && (p.Y < 0.f))
-			{
-				r += 2.f * (M_PI - r);
-			}
-			else if((p.X > 0.f) && (p.Y < 0.f))
-			{
-				r = 2 * M_PI - r; 
-			}
+			mesh.stripFirsts.clear();
+			mesh.stripCounts.clear();
+			mesh.fanFirsts.clear();
+			mesh.fanCounts.clear();
+
+			appendParts(vertices, getOutlineCirclesVertices(), { 0.f, 0.f, 0.f }, mesh.stripFirsts, mesh.stripCounts);
+			appendParts(vertices, getSectorsVertices(true), { 1.f, 1.f, 0.f }, mesh.fanFirsts, mesh.fanCounts);
+			appendParts(vertices, getSectorsVertices(false), { 1.f, 0.f, 1.f }, mesh.fanFirsts, mesh.fanCounts);
 
-			return r; 
+			glBindBuffer(GL_ARRAY_BUFFER, mesh.buffer);
+			glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(MeshVertex), vertices.data(), GL_STATIC_DRAW);
+			glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+			meshDirty = false;
 		}
 
-		void drawVertices(const std::vector<Vector>& vertices) const 
+		void appendParts(std::vector<MeshVertex>& vertices, const std::vector<std::vector<Vector>>& parts, const Vector& color,
+			std::vector<GLint>& firsts, std::vector<GLsizei>& counts) const
 		{
-			glColor3f(0.f, 0.f, 0.f);
-			glPointSize(5.5f);
-			glBegin(GL_POINTS);
-				for(const auto& v : vertices)
-					glVertex2f(v.X, v.Y);
-			glEnd();
+			for(const auto& part : parts)
+			{
+				firsts.push_back(static_cast<GLint>(vertices.size()));
+				counts.push_back(static_cast<GLsizei>(part.size()));
+
+				for(const auto& v : part)
+					vertices.push_back({ v, color });
+			}
 		}
 
-		std::vector<float> getFilledVertices(const std::vector<std::vector<Vector>>& fillVertices) const
+		// The star sectors are fans from the star tips over the inner circle,
+		// the outline sectors fans from the star's inner points over the outer circle
+		std::vector<std::vector<Vector>> getSectorsVertices(bool isStarsSectors) const
 		{
-			std::vector<float> r;
+			std::vector<std::vector<Vector>> r; 
 
-			std::vector<int> sizes;
-			sizes.reserve(fillVertices.size());
+			const auto apexes = isStarsSectors ? getStarOuterCirclePoints() : getStarInnerCirclePoints();
+			const float step = 2.f * M_PI / sectorsN;
+			const float firstAngle = isStarsSectors ? step / 2.f : 0.f;
+			const auto R = isStarsSectors ? getStarR() : getOuterR();
 
-			for(const auto i : fillVertices)
-				sizes.push_back(i.size());
-			
-			const auto verticesN = std::accumulate(sizes.begin(), sizes.end(), 0);
-			r.reserve(verticesN * 3);
-			
-			for(const auto& vertices : fillVertices)
+			r.reserve(apexes.size());
+			for(int i{}; i < apexes.size(); ++i)
 			{
-				for(const auto& v : vertices)
-				{
-					r.push_back(v.X);
-					r.push_back(v.Y);
-					r.push_back(v.Z);
-				}
-			}
+				std::vector<Vector> sector;
+				const auto N = 7;
+				sector.reserve(N + 2);
+				sector.push_back(apexes[i]);
 
-			return r;
-		}
+				ArcGenerator::appendArcPoints(sector, { center.X, center.Y }, R, firstAngle + step * i, firstAngle + step * (i + 1), N);
 
-		std::vector<GLint> getFilledFirst(const std::vector<std::vector<Vector>>& fillVertices) const 
-		{
-			std::vector<GLint> r;
-			r.reserve(fillVertices.size());
-			
-			GLint nextIndex{};
-			for(int i = 0; i < fillVertices.size(); ++i)
-			{
-				r.push_back(nextIndex);
-				nextIndex += fillVertices[i].size();
+				r.push_back(std::move(sector));
 			}
 
 			return r;
 		}
 
-		std::vector<GLsizei> getFilledCount(const std::vector<std::vector<Vector>>& fillVertices) const 
+		void drawVertices(const std::vector<Vector>& vertices) const 
 		{
-			std::vector<GLsizei> r;
-			
-			for(const auto& vertices : fillVertices)
-				r.push_back(static_cast<GLsizei>(vertices.size()));
-			
-			return r;
+			glColor3f(0.f, 0.f, 0.f);
+			glPointSize(5.5f);
+			glBegin(GL_POINTS);
+				for(const auto& v : vertices)
+					glVertex2f(v.X, v.Y);
+			glEnd();
 		}
 
 		std::vector<Vector> connectCircles(const std::vector<Vector>& lhs, const std::vector<Vector>& rhs) const
@@ -287,7 +228,7 @@ namespace HalfStarCircle
 			return r;
 		}
 
-		void drawOutlineCircles() const
+		std::vector<std::vector<Vector>> getOutlineCirclesVertices() const
 		{
 			const auto innerN = 40;
 			const auto outerN = 40;
@@ -301,28 +242,12 @@ namespace HalfStarCircle
 				for(auto& v : c)
 					v.Z = 0.5f;
 
-			const auto vertices = getFilledVertices(circles);
-			const auto first = getFilledFirst(circles);
-			const auto count = getFilledCount(circles);
-			
-			glColor3f(0.f, 0.f, 0.f);
-			glVertexPointer(3, GL_FLOAT, 0.f, vertices.data());
-			glMultiDrawArrays(GL_TRIANGLE_STRIP, first.data(), count.data(), circles.size());
+			return circles;
 		}
 
 		std::vector<Vector> getCirclePoints(float R, int N) const
 		{
-			std::vector<Vector> r;
-
-			float t;
-			for(int i{}; i <= N; ++i)
-			{
-				t = (2.f * M_PI / N * i);
-				const auto vertex = Vector(center.X + R * cos(t), center.Y + R * sin(t));
-				r.push_back(vertex);
-			}
-
-			return r;
+			return ArcGenerator::getCirclePoints({ center.X, center.Y }, R, N);
 		}
 
 		float getOuterR() const noexcept
@@ -339,11 +264,10 @@ namespace HalfStarCircle
 		{
 			std::vector<Vector> r;
 
-			const auto offsetAngleRad = 30.f * M_PI / 180.f;
+			const auto offsetAngleRad = M_PI / sectorsN;
 			const auto R = getStarR();
-			const auto pointsN = 6;
 
-			for(int i{}; i < pointsN; ++i)
+			for(int i{}; i < sectorsN; ++i)
 			{
 				const float t = (offsetAngleRad + (2.f * offsetAngleRad * i));
 				
@@ -362,11 +286,10 @@ namespace HalfStarCircle
 		{
 			std::vector<Vector> r;
 
-			const auto offsetAngleRad = 60.f * M_PI / 180.f;
+			const auto offsetAngleRad = 2.f * M_PI / sectorsN;
 			const auto R = getOuterR();
-			const auto pointsN = 6;
 
-			for(int i{}; i < pointsN; ++i)
+			for(int i{}; i < sectorsN; ++i)
 			{
 				const float t = (offsetAngleRad + (offsetAngleRad * i));
 				
@@ -381,37 +304,17 @@ namespace HalfStarCircle
 			return r;
 		}
 
-		std::vector<Vector> getArcPointsFromTo(const Vector& centerPoint, float startAngle, float endAngle, float R, int N) const
-		{
-			std::vector<Vector> r;
-			r.reserve(N);
-
-			float offset = startAngle;
-			float t;
-			float path = endAngle - startAngle;
-
-			for(int i{}; i <= N; ++i)
-			{
-				t = offset + (path / N) * i;
-
-				Vector point{
-					centerPoint.X + R * cos(t),
-					centerPoint.Y + R * sin(t)
-				};
-
-				r.push_back(point);
-			}
-
-			return r;
-		}
-
 		bool wireFrame;
 	
 		float innerR;
 		float outerR;
+		int sectorsN;
 
 		Vector center;
 
+		StarMesh mesh;
+		bool meshDirty;
+
 	} halfStarCircle;
 
 	void drawScene(void)
@@ -452,13 +355,34 @@ namespace HalfStarCircle
 		case ' ':
 			halfStarCircle.toggleWireframeMode();
 			break;
+		case '+':
+			halfStarCircle.setSectorsN(std::min(halfStarCircle.getSectorsN() + 1, 12));
+			break;
+		case '-':
+			halfStarCircle.setSectorsN(std::max(halfStarCircle.getSectorsN() - 1, 3));
+			break;
+		case '>':
+			halfStarCircle.setRadii(std::min(halfStarCircle.getInnerR() + 1.f, 25.f), 30.f);
+			break;
+		case '<':
+			halfStarCircle.setRadii(std::max(halfStarCircle.getInnerR() - 1.f, 5.f), 30.f);
+			break;
 		default:
 			break;
 		}
 	}
 
+	void printInteraction(void)
+	{
+		std::cout << "Interaction:\n";
+		std::cout << "Press space to toggle the wireframe" << std::endl;
+		std::cout << "Press +/- to add or remove a sector" << std::endl;
+		std::cout << "Press >/< to grow or shrink the inner circle" << std::endl;
+	}
+
 	int main(int argc, char **argv)
 	{
+		printInteraction();
 		glutInit(&argc, argv);
 
 		glutInitContextVersion(4, 3);
@@ -482,4 +406,6 @@ namespace HalfStarCircle
 
 		glutMainLoop();
 	}
+
+	static SceneRegistry::Registrar registrar{ { "HalfStarCircle", main, setup, drawScene, resize, keyInput } };
 }
\ No newline at end of file
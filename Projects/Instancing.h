@@ -0,0 +1,224 @@
+#pragma once
+///////////////////////////////////////////////////////////////////////////////////////
+// Instanced drawing of one mesh at many transforms and colors.
+//
+// A Batch keeps the mesh in a vertex and an element buffer next to a buffer of
+// per-instance model matrices and colors, and draws all the instances with one
+// glDrawElementsInstanced. Its program applies the instance matrix before the
+// current modelview and projection, so scenes keep positioning the batch with
+// the fixed-function matrix stack. The GL objects belong to the context that
+// was current when the batch was first filled, in another one it makes them
+// again.
+///////////////////////////////////////////////////////////////////////////////////////
+
+#include <vector>
+#include <cstddef>
+#include <utility>
+#include <iterator>
+#include <algorithm>
+#include <GL/glew.h>
+#include "SimdMath.h"
+#include "Shader.h"
+#include "GLContext.h"
+
+namespace Instancing
+{
+	using SimdMath::Vec3;
+	using SimdMath::Mat4;
+
+	// Joins strips and loops of one mesh, it is enabled while a batch draws
+	constexpr unsigned int primitiveRestart = 0xFFFFFFFF;
+
+	struct Instance
+	{
+		Mat4 transform;
+		Vec3 color;
+	};
+
+	namespace Detail
+	{
+		// The instance matrix comes in as four columns at locations 2 to 5
+		inline GLuint createProgram()
+		{
+			return Shader::createProgram(R"(
+				#version 330 compatibility
+				layout(location = 0) in vec3 position;
+				layout(location = 1) in vec3 color;
+				layout(location = 2) in mat4 transform;
+
+				void main()
+				{
+					gl_FrontColor = vec4(color, 1.0);
+					gl_Position = gl_ModelViewProjectionMatrix * transform * vec4(position, 1.0);
+				}
+			)", R"(
+				#version 330 compatibility
+
+				void main()
+				{
+					gl_FragColor = gl_Color;
+				}
+			)");
+		}
+	}
+
+	class Batch
+	{
+	public:
+
+		Batch() = default;
+		Batch(const Batch&) = delete;
+		Batch& operator=(const Batch&) = delete;
+
+		Batch(Batch&& other) noexcept
+		{
+			take(other);
+		}
+
+		Batch& operator=(Batch&& other) noexcept
+		{
+			if(this != &other)
+			{
+				destroy();
+				take(other);
+			}
+
+			return *this;
+		}
+
+		~Batch()
+		{
+			destroy();
+		}
+
+		// The GL objects are made by the first call in a context, later calls replace the mesh
+		void setMesh(GLenum pMode, const std::vector<Vec3>& positions, const std::vector<unsigned int>& indices)
+		{
+			if(!GLContext::isCurrent(context))
+				init();
+
+			mode = pMode;
+			indicesN = static_cast<GLsizei>(indices.size());
+
+			glBindBuffer(GL_ARRAY_BUFFER, buffers[VERTICES]);
+			glBufferData(GL_ARRAY_BUFFER, positions.size() * sizeof(Vec3), positions.data(), GL_STATIC_DRAW);
+			glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+			glBindVertexArray(vertexArray);
+			glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(unsigned int), indices.data(), GL_STATIC_DRAW);
+			glBindVertexArray(0);
+		}
+
+		// The buffer is orphaned every time, so batches can be refilled every frame
+		void setInstances(const std::vector<Instance>& instances)
+		{
+			if(!GLContext::isCurrent(context))
+				init();
+
+			instancesN = static_cast<GLsizei>(instances.size());
+
+			glBindBuffer(GL_ARRAY_BUFFER, buffers[INSTANCES]);
+			glBufferData(GL_ARRAY_BUFFER, instances.size() * sizeof(Instance), instances.data(), GL_STREAM_DRAW);
+			glBindBuffer(GL_ARRAY_BUFFER, 0);
+		}
+
+		std::size_t getInstancesN() const noexcept
+		{
+			return instancesN;
+		}
+
+		void draw() const
+		{
+			if(!GLContext::isCurrent(context) || !indicesN || !instancesN)
+				return;
+
+			glUseProgram(program);
+			glBindVertexArray(vertexArray);
+			glEnable(GL_PRIMITIVE_RESTART_FIXED_INDEX);
+
+			glDrawElementsInstanced(mode, indicesN, GL_UNSIGNED_INT, nullptr, instancesN);
+
+			glDisable(GL_PRIMITIVE_RESTART_FIXED_INDEX);
+			glBindVertexArray(0);
+			glUseProgram(0);
+		}
+
+	private:
+
+		enum Buffers
+		{
+			VERTICES,
+			INDICES,
+			INSTANCES
+		};
+
+		// The names of another context went with it and are only forgotten
+		void init()
+		{
+			context = GLContext::getGeneration();
+			indicesN = 0;
+			instancesN = 0;
+			program = Detail::createProgram();
+
+			glGenVertexArrays(1, &vertexArray);
+			glGenBuffers(3, buffers);
+
+			glBindVertexArray(vertexArray);
+
+			glBindBuffer(GL_ARRAY_BUFFER, buffers[VERTICES]);
+			glEnableVertexAttribArray(0);
+			glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(Vec3), nullptr);
+
+			glBindBuffer(GL_ARRAY_BUFFER, buffers[INSTANCES]);
+			glEnableVertexAttribArray(1);
+			glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(Instance), reinterpret_cast<void*>(offsetof(Instance, color)));
+			glVertexAttribDivisor(1, 1);
+
+			for(GLuint column{}; column < 4; ++column)
+			{
+				const auto offset = offsetof(Instance, transform) + column * 4 * sizeof(float);
+
+				glEnableVertexAttribArray(2 + column);
+				glVertexAttribPointer(2 + column, 4, GL_FLOAT, GL_FALSE, sizeof(Instance), reinterpret_cast<void*>(offset));
+				glVertexAttribDivisor(2 + column, 1);
+			}
+
+			glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, buffers[INDICES]);
+
+			glBindVertexArray(0);
+			glBindBuffer(GL_ARRAY_BUFFER, 0);
+		}
+
+		void destroy()
+		{
+			if(GLContext::isCurrent(context))
+			{
+				glDeleteProgram(program);
+				glDeleteVertexArrays(1, &vertexArray);
+				glDeleteBuffers(3, buffers);
+			}
+
+			context = 0;
+		}
+
+		void take(Batch& other) noexcept
+		{
+			mode = other.mode;
+			indicesN = other.indicesN;
+			instancesN = other.instancesN;
+			context = std::exchange(other.context, 0u);
+			program = other.program;
+			vertexArray = other.vertexArray;
+			std::copy(std::begin(other.buffers), std::end(other.buffers), std::begin(buffers));
+		}
+
+		GLenum mode = GL_TRIANGLES;
+		GLsizei indicesN = 0;
+		GLsizei instancesN = 0;
+		// The generation of the context the objects below were made in, 0 before the first
+		unsigned context = 0;
+		GLuint program = 0;
+		GLuint vertexArray = 0;
+		GLuint buffers[3] = {};
+	};
+}
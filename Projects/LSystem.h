@@ -0,0 +1,449 @@
+#pragma once
+///////////////////////////////////////////////////////////////////////////////////////
+// L-systems expanded as a stream of symbols and drawn by a turtle.
+//
+// A Stream never builds the string of a generation: it keeps one position per
+// generation in the replacements it is expanding, so a curve of a million
+// segments is read with a stack as deep as the number of generations.
+//
+// interpret() gives a symbol to anything with the Forward, Turn, Push and Pop of
+// the turtle canvases. generate() runs the symbols through its own turtle and
+// hands the segments over in batches of about batchSegments. Large curves are
+// split into chunks of the first generations, which are evaluated on several
+// threads from the origin and moved to where the chunk before them stopped.
+///////////////////////////////////////////////////////////////////////////////////////
+
+#include <array>
+#include <cmath>
+#include <limits>
+#include <string>
+#include <thread>
+#include <vector>
+#include <utility>
+#include <cstdint>
+#include <algorithm>
+#include "TurtleProgram.h"
+
+namespace LSystem
+{
+	using TurtleProgram::State;
+	using TurtleProgram::Segment;
+
+	// Below this many segments a curve is generated on the calling thread
+	constexpr std::uint64_t parallelSegments = 1 << 16;
+	constexpr std::size_t batchSegments = 1 << 16;
+
+	class Grammar
+	{
+	public:
+
+		Grammar(std::string pAxiom, const std::vector<std::pair<char, std::string>>& rules, float pAngle)
+			:
+			axiom{ std::move(pAxiom) },
+			angle{ pAngle }
+		{
+			for(const auto& rule : rules)
+			{
+				replacements[static_cast<unsigned char>(rule.first)] = rule.second;
+				hasRule[static_cast<unsigned char>(rule.first)] = true;
+			}
+		}
+
+		const std::string& getAxiom() const noexcept
+		{
+			return axiom;
+		}
+
+		float getAngle() const noexcept
+		{
+			return angle;
+		}
+
+		// nullptr for the symbols that stay the same in the next generation
+		const std::string* getReplacement(char symbol) const noexcept
+		{
+			const auto i = static_cast<unsigned char>(symbol);
+			return hasRule[i] ? &replacements[i] : nullptr;
+		}
+
+		// The string after one more generation
+		std::string expand(const std::string& s) const
+		{
+			std::string r;
+			for(const auto symbol : s)
+			{
+				const auto* replacement = getReplacement(symbol);
+				if(replacement)
+					r += *replacement;
+				else
+					r += symbol;
+			}
+
+			return r;
+		}
+
+	private:
+
+		std::string axiom;
+		std::array<std::string, 256> replacements;
+		std::array<bool, 256> hasRule{};
+		float angle;
+	};
+
+	// The symbols [first, last) turn into after some generations, in order
+	class Stream
+	{
+	public:
+
+		Stream(const Grammar& pGrammar, const char* first, const char* last, int generations)
+			:
+			grammar{ pGrammar }
+		{
+			stack.push_back({ first, last, generations });
+		}
+
+		Stream(const Grammar& pGrammar, int generations)
+			:
+			Stream(pGrammar, pGrammar.getAxiom().data(), pGrammar.getAxiom().data() + pGrammar.getAxiom().size(), generations)
+		{}
+
+		bool next(char& symbol)
+		{
+			while(!stack.empty())
+			{
+				auto& frame = stack.back();
+				if(frame.first == frame.last)
+				{
+					stack.pop_back();
+					continue;
+				}
+
+				const auto s = *frame.first++;
+				const auto* replacement = frame.generations > 0 ? grammar.getReplacement(s) : nullptr;
+
+				if(!replacement)
+				{
+					symbol = s;
+					return true;
+				}
+
+				const auto generations = frame.generations - 1;
+				stack.push_back({ replacement->data(), replacement->data() + replacement->size(), generations });
+			}
+
+			return false;
+		}
+
+	private:
+
+		struct Frame
+		{
+			const char* first;
+			const char* last;
+			int generations;
+		};
+
+		const Grammar& grammar;
+		std::vector<Frame> stack;
+	};
+
+	// F and G draw a step, f moves a step, + and L turn left, - and R turn right, [ and ] save and restore the turtle
+	template<typename Turtle>
+	void interpret(char symbol, float angle, float length, Turtle& turtle)
+	{
+		switch(symbol)
+		{
+			case 'F':
+			case 'G':
+				turtle.Forward(length, true);
+				break;
+			case 'f':
+				turtle.Forward(length, false);
+				break;
+			case '+':
+			case 'L':
+				turtle.Turn(angle);
+				break;
+			case '-':
+			case 'R':
+				turtle.Turn(-angle);
+				break;
+			case '[':
+				turtle.Push();
+				break;
+			case ']':
+				turtle.Pop();
+				break;
+		}
+	}
+
+	namespace Detail
+	{
+		// A turtle that keeps its segments, a Pop with nothing saved starts a new run from the origin
+		struct Turtle
+		{
+			struct Run
+			{
+				std::vector<Segment> segments;
+				State end;
+			};
+
+			explicit Turtle(State pState)
+				:
+				state{ pState },
+				runs(1)
+			{}
+
+			void Forward(float dist, bool isVisible)
+			{
+				const auto next = TurtleProgram::advance(state, dist);
+
+				if(isVisible)
+					runs.back().segments.push_back({ state.X, state.Y, next.X, next.Y });
+
+				state = next;
+			}
+
+			void Turn(float angle)
+			{
+				state.CD += angle;
+			}
+
+			void Push()
+			{
+				saved.push_back(state);
+			}
+
+			void Pop()
+			{
+				if(!saved.empty())
+				{
+					state = saved.back();
+					saved.pop_back();
+					return;
+				}
+
+				runs.back().end = state;
+				runs.emplace_back();
+				state = {};
+			}
+
+			// Closes the last run, saved keeps the states pushed and not popped
+			void finish()
+			{
+				runs.back().end = state;
+			}
+
+			State state;
+			std::vector<Run> runs;
+			std::vector<State> saved;
+		};
+
+		// Moves what a turtle made from the origin to the position and direction of frame
+		class Placement
+		{
+		public:
+
+			explicit Placement(const State& pFrame)
+				:
+				frame{ pFrame },
+				c{ static_cast<float>(cos(RadPerDeg * pFrame.CD)) },
+				s{ static_cast<float>(sin(RadPerDeg * pFrame.CD)) }
+			{}
+
+			State operator()(const State& local) const noexcept
+			{
+				return { frame.X + local.X * c - local.Y * s, frame.Y + local.X * s + local.Y * c, frame.CD + local.CD };
+			}
+
+			Segment operator()(const Segment& local) const noexcept
+			{
+				return {
+					frame.X + local.X0 * c - local.Y0 * s, frame.Y + local.X0 * s + local.Y0 * c,
+					frame.X + local.X1 * c - local.Y1 * s, frame.Y + local.X1 * s + local.Y1 * c
+				};
+			}
+
+		private:
+
+			static constexpr float RadPerDeg = 0.017453393f;
+
+			State frame;
+			float c;
+			float s;
+		};
+
+		// segmentsN[g][symbol] is the number of segments symbol draws after g generations, saturated
+		inline std::vector<std::array<std::uint64_t, 256>> countSegments(const Grammar& grammar, int generations)
+		{
+			constexpr auto most = std::numeric_limits<std::uint64_t>::max() / 256;
+
+			std::vector<std::array<std::uint64_t, 256>> r(generations + 1);
+			for(int symbol{}; symbol < 256; ++symbol)
+				r[0][symbol] = symbol == 'F' || symbol == 'G';
+
+			for(int g = 1; g <= generations; ++g)
+			{
+				for(int symbol{}; symbol < 256; ++symbol)
+				{
+					const auto* replacement = grammar.getReplacement(static_cast<char>(symbol));
+					if(!replacement)
+					{
+						r[g][symbol] = r[0][symbol];
+						continue;
+					}
+
+					std::uint64_t n{};
+					for(const auto c : *replacement)
+						n = std::min(most, n + r[g - 1][static_cast<unsigned char>(c)]);
+
+					r[g][symbol] = n;
+				}
+			}
+
+			return r;
+		}
+	}
+
+	// The number of segments the axiom draws after the given generations
+	inline std::uint64_t getSegmentsN(const Grammar& grammar, int generations)
+	{
+		const auto segmentsN = Detail::countSegments(grammar, generations);
+
+		std::uint64_t r{};
+		for(const auto c : grammar.getAxiom())
+			r += segmentsN[generations][static_cast<unsigned char>(c)];
+
+		return r;
+	}
+
+	// Calls draw(segments) for the segments of the curve in order, returns where the turtle stops
+	template<typename Draw>
+	State generate(const Grammar& grammar, int generations, State start, float length, Draw draw)
+	{
+		const auto segmentsN = Detail::countSegments(grammar, generations);
+		const auto threadsN = static_cast<std::size_t>(std::thread::hardware_concurrency());
+
+		std::uint64_t total{};
+		for(const auto c : grammar.getAxiom())
+			total += segmentsN[generations][static_cast<unsigned char>(c)];
+
+		if(threadsN < 2 || total < parallelSegments)
+		{
+			Detail::Turtle turtle{ start };
+			auto& segments = turtle.runs.back().segments;
+
+			Stream stream{ grammar, generations };
+			for(char symbol; stream.next(symbol);)
+			{
+				// Pops past the start are ignored, as the canvases do
+				if(symbol == ']' && turtle.saved.empty())
+					continue;
+
+				interpret(symbol, grammar.getAngle(), length, turtle);
+
+				if(segments.size() >= batchSegments)
+				{
+					draw(segments);
+					segments.clear();
+				}
+			}
+
+			draw(segments);
+
+			return turtle.state;
+		}
+
+		// The first generations are expanded until every symbol draws at most a chunk
+		const auto chunkSegments = std::max<std::uint64_t>(batchSegments / threadsN, 1);
+
+		auto prefix = grammar.getAxiom();
+		auto prefixGenerations = 0;
+		const auto isFine = [&] {
+			return std::all_of(prefix.begin(), prefix.end(), [&](char c) {
+				return segmentsN[generations - prefixGenerations][static_cast<unsigned char>(c)] <= chunkSegments;
+			});
+		};
+
+		while(prefixGenerations < generations && !isFine())
+		{
+			prefix = grammar.expand(prefix);
+			++prefixGenerations;
+		}
+
+		const auto remaining = generations - prefixGenerations;
+
+		std::vector<std::pair<std::size_t, std::size_t>> chunks;
+		for(std::size_t first{}; first < prefix.size();)
+		{
+			auto last = first;
+			std::uint64_t n{};
+			while(last < prefix.size() && (last == first || n + segmentsN[remaining][static_cast<unsigned char>(prefix[last])] <= chunkSegments))
+				n += segmentsN[remaining][static_cast<unsigned char>(prefix[last++])];
+
+			chunks.emplace_back(first, last);
+			first = last;
+		}
+
+		State state = start;
+		std::vector<State> saved;
+		std::vector<Segment> segments;
+
+		for(std::size_t wave{}; wave < chunks.size(); wave += threadsN)
+		{
+			const auto chunksN = std::min(threadsN, chunks.size() - wave);
+
+			std::vector<Detail::Turtle> turtles(chunksN, Detail::Turtle{ {} });
+			const auto evaluate = [&](std::size_t i) {
+				const auto [first, last] = chunks[wave + i];
+
+				Stream stream{ grammar, prefix.data() + first, prefix.data() + last, remaining };
+				for(char symbol; stream.next(symbol);)
+					interpret(symbol, grammar.getAngle(), length, turtles[i]);
+
+				turtles[i].finish();
+			};
+
+			std::vector<std::thread> threads;
+			threads.reserve(chunksN - 1);
+
+			for(std::size_t i = 1; i < chunksN; ++i)
+				threads.emplace_back(evaluate, i);
+
+			evaluate(0);
+
+			for(auto& thread : threads)
+				thread.join();
+
+			// The runs are placed in order, every run after the first starts where a Pop of the chunk restored
+			for(const auto& turtle : turtles)
+			{
+				Detail::Placement placement{ state };
+
+				for(std::size_t i{}; i < turtle.runs.size(); ++i)
+				{
+					if(i > 0)
+					{
+						placement = Detail::Placement{ saved.empty() ? state : saved.back() };
+						if(!saved.empty())
+							saved.pop_back();
+					}
+
+					for(const auto& segment : turtle.runs[i].segments)
+						segments.push_back(placement(segment));
+
+					state = placement(turtle.runs[i].end);
+				}
+
+				// The states saved and not restored yet were made in the frame of the last run
+				for(const auto& s : turtle.saved)
+					saved.push_back(placement(s));
+			}
+
+			draw(segments);
+			segments.clear();
+		}
+
+		return state;
+	}
+}
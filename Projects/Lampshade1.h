@@ -1,3 +1,4 @@
+#pragma once
 ///////////////////////////////////////////////////////////////////////////////////////          
 // This program draws lampshade1
 //
@@ -11,6 +12,7 @@
 #include <iostream>
 #include <GL/glew.h>
 #include <GL/freeglut.h>
+#include "SceneRegistry.h"
 #include <vector>
 
 namespace Lampshade1
@@ -149,5 +151,7 @@ namespace Lampshade1
 
 		return 0;
 	}
+
+	static SceneRegistry::Registrar registrar{ { "Lampshade1", main, setup, drawScene, resize, keyInput } };
 }
 
@@ -1,8 +1,10 @@
+#pragma once
 ///////////////////////////////////////////////////////////////////////////////////////          
 // This program draws lampshade2
 //
 // Interaction:
 // Press x, X, y, Y, z, Z to turn the lampshade.
+// Press o to toggle between the strip and a vertex cache optimized triangle list.
 /////////////////////////////////////////////////////////////////////////////////////// 
 
 #define _USE_MATH_DEFINES 
@@ -11,6 +13,11 @@
 #include <iostream>
 #include <GL/glew.h>
 #include <GL/freeglut.h>
+#include "SceneRegistry.h"
+#include "SimdMath.h"
+#include "ParametricSurface.h"
+#include "VertexCache.h"
+#include "MeshCache.h"
 #include <vector>
 
 namespace Lampshade2
@@ -20,42 +27,38 @@ namespace Lampshade2
 	static float R1 = 12.5f;
 	static int N = 15;
 
-	static std::vector<float> vertices;
-	static std::vector<unsigned int> indices;
+	static ParametricSurface::Mesh mesh;
+	static bool isVertexCacheOptimized;
 
-	void fillVertices()
+	// Part of the mesh cache key, bumped when the formula below changes
+	constexpr int meshVersion = 1;
+
+	// Row 1 is the bottom circle so the strip starts there as it always did
+	void fillMesh()
 	{
-		vertices.reserve((N + 1) * 2);
+		mesh = MeshCache::getMesh("Lampshade2", MeshCache::getKey(meshVersion, N, R0, R1, isVertexCacheOptimized), [] {
+			auto mesh = ParametricSurface::tessellate({ N, 1 }, [](int i, int j) {
+				const float t = 2 * M_PI * i / N;
+				const auto R = j == 0 ? R1 : R0;
 
-		float t;
-		for (int i = 0; i <= N; ++i)
-		{
-			t = 2 * M_PI * i / N;
+				return SimdMath::Vec3(R * cos(t), j == 0 ? 10.f : 0.f, R * sin(t));
+			});
 
-			vertices.push_back(R0 * cos(t));
-			vertices.push_back(0.f);
-			vertices.push_back(R0 * sin(t));
+			return isVertexCacheOptimized ? VertexCache::optimize(std::move(mesh)) : mesh;
+		});
 
-			vertices.push_back(R1 * cos(t));
-			vertices.push_back(10.f);
-			vertices.push_back(R1 * sin(t));
-		}
+		glVertexPointer(3, GL_FLOAT, 0, mesh.positions.data());
 	}
 
-	void fillIndices()
+	void printVertexCacheStats()
 	{
-		const auto reserveCap = (N + 1) * 2;
-		indices.reserve(reserveCap);
-		for (int i = 0; i < reserveCap; ++i)
-			indices.push_back(i);
+		std::cout << (isVertexCacheOptimized ? "Optimized triangle list: " : "Strip: ") << VertexCache::getStats(mesh) << std::endl;
 	}
 
 	void setup(void)
 	{
-		fillVertices();
-		fillIndices();
 		glEnableClientState(GL_VERTEX_ARRAY);
-		glVertexPointer(3, GL_FLOAT, 0, vertices.data());
+		fillMesh();
 		glClearColor(1.0, 1.0, 1.0, 0.0);
 	}
 
@@ -74,7 +77,7 @@ namespace Lampshade2
 		glPolygonMode(GL_FRONT_AND_BACK, GL_LINE);
 		glColor3f(0.0, 0.0, 0.0);
 
-		glDrawElements(GL_TRIANGLE_STRIP, indices.size(), GL_UNSIGNED_INT, indices.data());
+		glDrawElements(isVertexCacheOptimized ? GL_TRIANGLES : GL_TRIANGLE_STRIP, mesh.indices.size(), GL_UNSIGNED_INT, mesh.indices.data());
 
 		glFlush();
 	}
@@ -95,6 +98,12 @@ namespace Lampshade2
 		case 27:
 			exit(0);
 			break;
+		case 'o':
+			isVertexCacheOptimized = !isVertexCacheOptimized;
+			fillMesh();
+			printVertexCacheStats();
+			glutPostRedisplay();
+			break;
 		case 'x':
 			Xangle += 5.0;
 			if (Xangle > 360.0) Xangle -= 360.0;
@@ -134,6 +143,7 @@ namespace Lampshade2
 	{
 		std::cout << "Interaction:\n";
 		std::cout << "Press x, X, y, Y, z, Z to turn the lampshade" << std::endl;
+		std::cout << "Press o to toggle between the strip and a vertex cache optimized triangle list" << std::endl;
 	}
 
 	int main(int argc, char** argv)
@@ -161,5 +171,7 @@ namespace Lampshade2
 
 		return 0;
 	}
+
+	static SceneRegistry::Registrar registrar{ { "Lampshade2", main, setup, drawScene, resize, keyInput } };
 }
 
@@ -0,0 +1,169 @@
+#pragma once
+///////////////////////////////////////////////////////////////////////////////////////
+// Screen-space level of detail for tessellated spheres and ellipsoids.
+//
+// A Levels keeps the meshes of a surface at its full resolution and at every
+// halving of it, all tessellated once up front. Each draw projects the bounding
+// radius with the current matrices and viewport, and draws the coarsest level
+// whose silhouette stays within maxError pixels of the real surface, so small
+// and distant bodies draw few vertices without anything being rebuilt.
+///////////////////////////////////////////////////////////////////////////////////////
+
+#define _USE_MATH_DEFINES
+
+#include <cmath>
+#include <limits>
+#include <vector>
+#include <cstddef>
+#include <algorithm>
+#include <GL/glew.h>
+#include "ParametricSurface.h"
+
+namespace LevelOfDetail
+{
+	// How far in pixels the silhouette of a level may be from the real surface
+	constexpr float maxError = 1.f;
+
+	// The radius in pixels of a sphere of the given radius around the origin of the
+	// current modelview, infinite when the camera is inside it
+	inline float getProjectedRadius(float radius)
+	{
+		GLfloat modelview[16], projection[16];
+		GLint viewport[4];
+
+		glGetFloatv(GL_MODELVIEW_MATRIX, modelview);
+		glGetFloatv(GL_PROJECTION_MATRIX, projection);
+		glGetIntegerv(GL_VIEWPORT, viewport);
+
+		// The modelview may scale, the largest axis bounds the sphere
+		float scale{};
+		for(int c{}; c < 3; ++c)
+			scale = std::max(scale, std::hypot(modelview[4 * c], modelview[4 * c + 1], modelview[4 * c + 2]));
+
+		const auto eyeRadius = radius * scale;
+		// Perspective projections divide by the distance along -Z, orthographic ones by nothing
+		const auto isPerspective = projection[11] != 0.f;
+		const auto w = isPerspective ? -modelview[14] : 1.f;
+
+		if(isPerspective && w <= eyeRadius)
+			return std::numeric_limits<float>::infinity();
+
+		const auto pixelsPerUnit = std::max(projection[0] * viewport[2], projection[5] * viewport[3]) / 2.f;
+
+		return eyeRadius * pixelsPerUnit / w;
+	}
+
+	// The largest angle between two vertices of a circle of pixelRadius
+	// which keeps its chords within maxError pixels of the arc
+	inline float getMaxStep(float pixelRadius)
+	{
+		if(pixelRadius <= maxError)
+			return static_cast<float>(M_PI);
+
+		return 2.f * std::acos(1.f - maxError / pixelRadius);
+	}
+
+	class Levels
+	{
+	public:
+
+		Levels() = default;
+
+		// The strips point into the meshes, a move keeps them but a copy would not
+		Levels(const Levels&) = delete;
+		Levels& operator=(const Levels&) = delete;
+		Levels(Levels&&) = default;
+		Levels& operator=(Levels&&) = default;
+
+		// tessellate(uSlices, vSlices) returns the mesh of a level. The first level has the
+		// given resolution and every next one half the slices, down to minSlices, with the
+		// rows scaled alike. The columns go around once and the rows span vAngle
+		template<typename Tessellate>
+		Levels(int uSlices, int vSlices, Tessellate tessellate, float vAngle = M_PI, int minSlices = 4)
+		{
+			auto u = uSlices;
+
+			while(true)
+			{
+				const auto v = std::max(1, (vSlices * u + uSlices - 1) / uSlices);
+
+				levels.push_back({ tessellate(u, v), std::max(2.f * static_cast<float>(M_PI) / u, vAngle / v), {} });
+
+				if(u <= minSlices)
+					break;
+
+				u = std::max(minSlices, u / 2);
+			}
+
+			for(auto& level : levels)
+				for(int j{}; j < static_cast<int>(level.mesh.counts.size()); ++j)
+					level.strips.push_back(level.mesh.getStrip(j));
+		}
+
+		std::size_t size() const noexcept
+		{
+			return levels.size();
+		}
+
+		const ParametricSurface::Mesh& getMesh(std::size_t level) const
+		{
+			return levels[level].mesh;
+		}
+
+		// The coarsest level fine enough for a surface pixelRadius pixels big, else the finest
+		std::size_t getLevel(float pixelRadius) const
+		{
+			const auto maxStep = getMaxStep(pixelRadius);
+
+			for(auto level = levels.size(); level-- > 1;)
+				if(levels[level].step <= maxStep)
+					return level;
+
+			return 0;
+		}
+
+		// The level for the current matrices, radius bounds the surface around the modelview origin
+		std::size_t getLevelFor(float radius) const
+		{
+			return getLevel(getProjectedRadius(radius));
+		}
+
+		// Draws a level from client memory, the vertex array state is restored afterwards
+		void draw(std::size_t level) const
+		{
+			const auto& mesh = levels[level].mesh;
+
+			glPushClientAttrib(GL_CLIENT_VERTEX_ARRAY_BIT);
+			glEnableClientState(GL_VERTEX_ARRAY);
+			glVertexPointer(3, GL_FLOAT, 0, mesh.positions.data());
+
+			switch(mesh.topology)
+			{
+			case ParametricSurface::Topology::strips:
+				glMultiDrawElements(GL_TRIANGLE_STRIP, mesh.counts.data(), GL_UNSIGNED_INT, levels[level].strips.data(), levels[level].strips.size());
+				break;
+			case ParametricSurface::Topology::triangles:
+				glDrawElements(GL_TRIANGLES, mesh.indices.size(), GL_UNSIGNED_INT, mesh.indices.data());
+				break;
+			case ParametricSurface::Topology::lines:
+				glDrawElements(GL_LINES, mesh.indices.size(), GL_UNSIGNED_INT, mesh.indices.data());
+				break;
+			}
+
+			glPopClientAttrib();
+		}
+
+	private:
+
+		struct Level
+		{
+			ParametricSurface::Mesh mesh;
+			// The largest angle between neighbouring vertices of the level
+			float step;
+			// Strips only, the rows in client memory for glMultiDrawElements
+			std::vector<const void*> strips;
+		};
+
+		std::vector<Level> levels;
+	};
+}
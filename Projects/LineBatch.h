@@ -0,0 +1,120 @@
+#pragma once
+///////////////////////////////////////////////////////////////////////////////////////
+// Line segments gathered on the CPU and drawn together.
+//
+// The turtle canvases used to draw every segment with its own glBegin/glEnd and
+// glFlush. A Batch keeps the segments with the color each was added in, and
+// flush() uploads them to a vertex buffer, which grows by doubling, and draws
+// all of them with one glDrawArrays(GL_LINES). The buffer belongs to the context
+// of the first flush, in another context flush() makes it again.
+///////////////////////////////////////////////////////////////////////////////////////
+
+#include <vector>
+#include <cstddef>
+#include <algorithm>
+#include <GL/glew.h>
+#include "GLContext.h"
+
+namespace LineBatch
+{
+	struct Vertex
+	{
+		float X;
+		float Y;
+		float R;
+		float G;
+		float B;
+	};
+
+	class Batch
+	{
+	public:
+
+		Batch() = default;
+		Batch(const Batch&) = delete;
+		Batch& operator=(const Batch&) = delete;
+
+		~Batch()
+		{
+			if(GLContext::isCurrent(context))
+				glDeleteBuffers(1, &buffer);
+		}
+
+		// The color of the segments added from now on
+		void setColor(float r, float g, float b)
+		{
+			color[0] = r;
+			color[1] = g;
+			color[2] = b;
+		}
+
+		void add(float x0, float y0, float x1, float y1)
+		{
+			vertices.push_back({ x0, y0, color[0], color[1], color[2] });
+			vertices.push_back({ x1, y1, color[0], color[1], color[2] });
+		}
+
+		// Drops the segments not drawn yet
+		void clear()
+		{
+			vertices.clear();
+		}
+
+		std::size_t getSegmentsN() const noexcept
+		{
+			return vertices.size() / 2;
+		}
+
+		// Draws the segments added since the last flush, the vertex array state is restored afterwards
+		void flush()
+		{
+			if(vertices.empty())
+				return;
+
+			// The name of another context went with it and is only forgotten
+			if(!GLContext::isCurrent(context))
+			{
+				context = GLContext::getGeneration();
+				glGenBuffers(1, &buffer);
+				capacity = 0;
+			}
+
+			glBindVertexArray(0);
+			glBindBuffer(GL_ARRAY_BUFFER, buffer);
+
+			// The storage is orphaned every time, so the upload does not wait for the last draw
+			const auto size = vertices.size() * sizeof(Vertex);
+			if(size > capacity)
+				capacity = std::max(size, 2 * capacity);
+
+			glBufferData(GL_ARRAY_BUFFER, capacity, nullptr, GL_STREAM_DRAW);
+			glBufferSubData(GL_ARRAY_BUFFER, 0, size, vertices.data());
+
+			glPushClientAttrib(GL_CLIENT_VERTEX_ARRAY_BIT);
+			glEnableClientState(GL_VERTEX_ARRAY);
+			glVertexPointer(2, GL_FLOAT, sizeof(Vertex), reinterpret_cast<void*>(offsetof(Vertex, X)));
+			glEnableClientState(GL_COLOR_ARRAY);
+			glColorPointer(3, GL_FLOAT, sizeof(Vertex), reinterpret_cast<void*>(offsetof(Vertex, R)));
+
+			glDrawArrays(GL_LINES, 0, static_cast<GLsizei>(vertices.size()));
+
+			glPopClientAttrib();
+			glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+			// Drawing with a color array leaves the current color undefined
+			glColor3fv(color);
+
+			vertices.clear();
+		}
+
+	private:
+
+		std::vector<Vertex> vertices;
+		// The current color of OpenGL until something is drawn
+		float color[3] = { 1.f, 1.f, 1.f };
+		// The generation of the context the buffer was made in, 0 before the first flush
+		unsigned context = 0;
+		GLuint buffer = 0;
+		std::size_t capacity = 0;
+	};
+}
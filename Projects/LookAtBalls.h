@@ -1,13 +1,28 @@
+#pragma once
+///////////////////////////////////////////////////////////////////////////////////////
+// This program flies the camera past a row of balls
+//
+// Interaction:
+// Press space to start/stop animation.
+// Press +/- to multiply/divide the number of balls by ten.
+///////////////////////////////////////////////////////////////////////////////////////
+
+#include <vector>
 #include <iostream>
 #include <GL/glew.h>
 #include <GL/freeglut.h> 
+#include "SceneRegistry.h"
+#include "Primitives.h"
+#include "Instancing.h"
 
 namespace LookAtBalls
 {
 	static bool isAnimate;
 	float t;
 	float animatePeriod = 100.f;
-	const int ballsAmount = 10;
+	static int ballsAmount = 10;
+	// One wire sphere drawn at every ball
+	static Instancing::Batch balls;
 
 	template<typename T1, typename T2>
 	T1 lerp(T1 a, T1 b, T2 t)
@@ -27,13 +42,7 @@ namespace LookAtBalls
 		const auto X = lerp(-7.f, -7.f + 7.f * ballsAmount, (t >= 1.f ? 1.f : t));
 
 		gluLookAt(X, 3, 0, X + 1, 2.0, 0.0, 0.0, 1.0, 1.0);
-		for (int i = 0; i < ballsAmount; ++i)
-		{
-			if (i != 0)
-				glTranslatef(7.f, 0.f, 0.f);
-			glColor3f(1.f, 0.f, 0.f);
-			glutWireSphere(2.0, 20, 20);
-		}
+		balls.draw();
 
 		glutSwapBuffers();
 	}
@@ -47,9 +56,28 @@ namespace LookAtBalls
 		}
 	}
 
+	// The balls are 7 apart along X
+	void fillBalls()
+	{
+		std::vector<Instancing::Instance> instances(ballsAmount);
+
+		for (int i = 0; i < ballsAmount; ++i)
+			instances[i] = { SimdMath::Mat4::translation({ 7.f * i, 0.f, 0.f }) * SimdMath::Mat4::scaling({ 2.f, 2.f, 2.f }), { 1.f, 0.f, 0.f } };
+
+		balls.setInstances(instances);
+	}
+
 	void setup(void)
 	{
 		glClearColor(1.0, 1.0, 1.0, 0.0);
+
+		const auto sphere = Primitives::getSphere(20, 20, true);
+		std::vector<SimdMath::Vec3> positions;
+		for (const auto& vertex : sphere.vertices)
+			positions.push_back(vertex.position);
+
+		balls.setMesh(GL_LINES, positions, sphere.indices);
+		fillBalls();
 	}
 
 	void resize(int w, int h)
@@ -72,6 +100,23 @@ namespace LookAtBalls
 		case ' ':
 			isAnimate = !isAnimate;
 			animate(1);
+			break;
+		case '+':
+			if (ballsAmount < 100000)
+			{
+				ballsAmount *= 10;
+				fillBalls();
+				glutPostRedisplay();
+			}
+			break;
+		case '-':
+			if (ballsAmount > 10)
+			{
+				ballsAmount /= 10;
+				fillBalls();
+				glutPostRedisplay();
+			}
+			break;
 		default:
 			break;
 		}
@@ -81,6 +126,7 @@ namespace LookAtBalls
 	{
 		std::cout << "Interaction\n";
 		std::cout << "Press space to start/stop animation\n";
+		std::cout << "Press +/- to multiply/divide the number of balls by ten\n";
 	}
 
 	int main(int argc, char** argv)
@@ -108,5 +154,7 @@ namespace LookAtBalls
 
 		return 0;
 	}
+
+	static SceneRegistry::Registrar registrar{ { "LookAtBalls", main, setup, drawScene, resize, keyInput } };
 }
 
@@ -1,3 +1,4 @@
+#pragma once
 /////////////////////////////////////////////////////////////////////         
 // Interaction:
 // Click two points on Opengl window, first for center of the circle,
@@ -11,6 +12,8 @@
 #include <iostream>
 #include <GL/glew.h>
 #include <GL/freeglut.h> 
+#include "SceneRegistry.h"
+#include "ArcGenerator.h"
 #include <vector>
 
 namespace MakeCircleWithTwoClicks
@@ -202,7 +205,7 @@ namespace MakeCircleWithTwoClicks
 			case 'X':
 				if (!vertices.empty())
 				{
-					master.removeEverything();
+					removeEverything();
 					circles.clear();
 					glutPostRedisplay();
 				}
@@ -251,14 +254,11 @@ namespace MakeCircleWithTwoClicks
 
 			const auto R = sqrt(RX * RX + RY * RY);
 
-			float t;
-			for (int i = 0; i <= N; ++i)
-			{
-				t = 2 * M_PI * i / N;
-				vertices.push_back(center.X + R * cos(t));
-				vertices.push_back(center.Y + R * sin(t));
+			ArcGenerator::forEachPoint(0.f, 2 * M_PI, N, [&](float c, float s) {
+				vertices.push_back(center.X + R * c);
+				vertices.push_back(center.Y + R * s);
 				vertices.push_back(0.0);
-			}
+			});
 		}
 
 		void fillFirst(int i)
@@ -395,4 +395,6 @@ namespace MakeCircleWithTwoClicks
 
 		return 0;
 	}
+
+	static SceneRegistry::Registrar registrar{ { "MakeCircleWithTwoClicks", main, setup, drawScene, resize, keyInput } };
 }
\ No newline at end of file
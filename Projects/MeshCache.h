@@ -0,0 +1,309 @@
+#pragma once
+///////////////////////////////////////////////////////////////////////////////////////
+// Generated meshes kept in binary files between runs.
+//
+// A mesh file is a Header, a table of Blobs and the blobs themselves, every one
+// aligned to blobAlignment, so each blob is read straight into its vector
+// without any parsing. The scenes keep their meshes in client memory or merge
+// them before uploading, so there is nothing to gain from mapping the files.
+// The header has the format version and the key the mesh was generated with,
+// a file of another version or key is generated again and overwritten. Keys
+// cover generatorVersion, the version of the shared tessellation code, and the
+// arguments of getKey: the parameters of the mesh and the version of the
+// formula of its scene. Both versions are bumped by hand when the meshes they
+// make change. Files are written in the byte order of the machine, they are a
+// cache and not meant to be shared.
+//
+// getMesh looks for directory/name-key.mesh, loads it when it is valid and
+// otherwise generates the mesh and writes the file for the next run. Without a
+// directory, as in the headless launcher unless it is given --mesh-cache, every
+// mesh is generated and nothing is written.
+///////////////////////////////////////////////////////////////////////////////////////
+
+#include <cstdio>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <type_traits>
+#include <system_error>
+#include <filesystem>
+#include "ParametricSurface.h"
+
+namespace MeshCache
+{
+	constexpr char magic[4]{ 'O', 'G', 'S', 'M' };
+	constexpr std::uint32_t version = 3;
+	// ParametricSurface::tessellate and VertexCache::optimize, bumped when they make other meshes
+	constexpr std::uint32_t generatorVersion = 1;
+	constexpr std::size_t blobAlignment = 16;
+
+	struct Header
+	{
+		char magic[4];
+		std::uint32_t version;
+		std::uint64_t key;
+		std::uint32_t blobsN;
+		std::uint32_t reserved;
+	};
+
+	struct Blob
+	{
+		std::uint32_t id;
+		std::uint32_t elementSize;
+		std::uint64_t count;
+		// From the start of the file
+		std::uint64_t offset;
+	};
+
+	namespace Detail
+	{
+		// FNV-1a
+		inline void hash(std::uint64_t& r, const void* data, std::size_t size)
+		{
+			for(std::size_t i{}; i < size; ++i)
+				r = (r ^ static_cast<const unsigned char*>(data)[i]) * 1099511628211ull;
+		}
+
+		constexpr std::uint64_t hashBasis = 14695981039346656037ull;
+
+		inline std::string& getDirectory()
+		{
+			// Relative to the working directory
+			static std::string directory = "meshcache";
+			return directory;
+		}
+	}
+
+	// Where mesh files are kept, an empty directory turns the cache off
+	inline void setDirectory(const std::string& directory)
+	{
+		Detail::getDirectory() = directory;
+	}
+
+	// The key of a mesh, made of generatorVersion and the bytes of every argument. The
+	// arguments are the version of the formula of the mesh and the parameters it depends on
+	template<typename... Args>
+	std::uint64_t getKey(const Args&... args)
+	{
+		static_assert((std::is_arithmetic_v<Args> && ...), "keys are made of numbers");
+
+		auto r = Detail::hashBasis;
+		Detail::hash(r, &generatorVersion, sizeof(generatorVersion));
+		(Detail::hash(r, &args, sizeof(args)), ...);
+
+		return r;
+	}
+
+	inline std::string getPath(const std::string& name, std::uint64_t key)
+	{
+		char hex[17];
+		std::snprintf(hex, sizeof(hex), "%016llx", static_cast<unsigned long long>(key));
+
+		return Detail::getDirectory() + "/" + name + "-" + hex + ".mesh";
+	}
+
+	// The blobs of a mesh file, read straight into the vectors they are loaded into
+	class File
+	{
+	public:
+
+		// Checks the header and that every blob lies inside the file
+		File(const std::string& path, std::uint64_t key)
+			:
+			file{ path, std::ios::binary }
+		{
+			std::error_code error;
+			const auto size = std::filesystem::file_size(path, error);
+			if(error || size < sizeof(Header))
+				return;
+
+			file.read(reinterpret_cast<char*>(&header), sizeof(Header));
+
+			if(!file || std::memcmp(header.magic, magic, sizeof(magic)) != 0 || header.version != version
+				|| header.key != key || size < sizeof(Header) + header.blobsN * sizeof(Blob))
+				return;
+
+			blobs.resize(header.blobsN);
+			file.read(reinterpret_cast<char*>(blobs.data()), header.blobsN * sizeof(Blob));
+
+			for(const auto& blob : blobs)
+			{
+				if(blob.offset % blobAlignment != 0 || blob.offset > size || blob.count * blob.elementSize > size - blob.offset)
+					return;
+			}
+
+			isValid = static_cast<bool>(file);
+		}
+
+		explicit operator bool() const noexcept
+		{
+			return isValid;
+		}
+
+		// Reads the blob with the given id into v, false if there is none or its elements are not T sized
+		template<typename T>
+		bool read(std::uint32_t id, std::vector<T>& v)
+		{
+			static_assert(std::is_trivially_copyable_v<T>, "blobs are read as they are in memory");
+
+			for(const auto& blob : blobs)
+			{
+				if(blob.id != id || blob.elementSize != sizeof(T))
+					continue;
+
+				v.resize(static_cast<std::size_t>(blob.count));
+				file.seekg(static_cast<std::streamoff>(blob.offset));
+				file.read(reinterpret_cast<char*>(v.data()), v.size() * sizeof(T));
+
+				return static_cast<bool>(file);
+			}
+
+			return false;
+		}
+
+	private:
+
+		std::ifstream file;
+		Header header{};
+		std::vector<Blob> blobs;
+		bool isValid = false;
+	};
+
+	class Writer
+	{
+	public:
+
+		template<typename T>
+		void add(std::uint32_t id, const std::vector<T>& v)
+		{
+			static_assert(std::is_trivially_copyable_v<T>, "blobs are written as they are in memory");
+
+			blobs.push_back({ id, static_cast<std::uint32_t>(sizeof(T)), v.size(), 0 });
+			data.emplace_back(reinterpret_cast<const char*>(v.data()), reinterpret_cast<const char*>(v.data() + v.size()));
+		}
+
+		// Writes a temporary file and renames it, so a file of the given path is always complete
+		bool write(const std::string& path, std::uint64_t key)
+		{
+			Header header{};
+			std::memcpy(header.magic, magic, sizeof(magic));
+			header.version = version;
+			header.key = key;
+			header.blobsN = static_cast<std::uint32_t>(blobs.size());
+
+			auto offset = sizeof(Header) + blobs.size() * sizeof(Blob);
+			for(auto& blob : blobs)
+			{
+				offset = (offset + blobAlignment - 1) / blobAlignment * blobAlignment;
+				blob.offset = offset;
+				offset += blob.count * blob.elementSize;
+			}
+
+			std::error_code error;
+			std::filesystem::create_directories(std::filesystem::path(path).parent_path(), error);
+
+			const auto temporaryPath = path + ".tmp";
+			{
+				std::ofstream file(temporaryPath, std::ios::binary);
+				file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+				file.write(reinterpret_cast<const char*>(blobs.data()), blobs.size() * sizeof(Blob));
+
+				std::size_t position = sizeof(Header) + blobs.size() * sizeof(Blob);
+				for(std::size_t i{}; i < blobs.size(); ++i)
+				{
+					const std::vector<char> padding(blobs[i].offset - position);
+					file.write(padding.data(), padding.size());
+					file.write(data[i].data(), data[i].size());
+					position = blobs[i].offset + data[i].size();
+				}
+
+				if(!file)
+					return false;
+			}
+
+			std::filesystem::rename(temporaryPath, path, error);
+
+			return !error;
+		}
+
+	private:
+
+		std::vector<Blob> blobs;
+		std::vector<std::vector<char>> data;
+	};
+
+	// The blobs of a ParametricSurface::Mesh, the strip offsets follow from the counts
+	enum MeshBlobs : std::uint32_t
+	{
+		INFO,
+		POSITIONS,
+		NORMALS,
+		INDICES,
+		COUNTS
+	};
+
+	inline bool save(const std::string& path, std::uint64_t key, const ParametricSurface::Mesh& mesh)
+	{
+		Writer writer;
+		writer.add(INFO, std::vector<std::int32_t>{ mesh.uSlices, mesh.vSlices, static_cast<std::int32_t>(mesh.topology) });
+		writer.add(POSITIONS, mesh.positions);
+		writer.add(NORMALS, mesh.normals);
+		writer.add(INDICES, mesh.indices);
+		writer.add(COUNTS, mesh.counts);
+
+		return writer.write(path, key);
+	}
+
+	inline bool load(const std::string& path, std::uint64_t key, ParametricSurface::Mesh& mesh)
+	{
+		File file(path, key);
+		if(!file)
+			return false;
+
+		std::vector<std::int32_t> info;
+		if(!file.read(INFO, info) || info.size() != 3)
+			return false;
+
+		mesh.uSlices = info[0];
+		mesh.vSlices = info[1];
+		mesh.topology = static_cast<ParametricSurface::Topology>(info[2]);
+
+		if(!file.read(POSITIONS, mesh.positions) || !file.read(NORMALS, mesh.normals)
+			|| !file.read(INDICES, mesh.indices) || !file.read(COUNTS, mesh.counts))
+			return false;
+
+		mesh.offsets.clear();
+		std::size_t offset{};
+		for(const auto count : mesh.counts)
+		{
+			mesh.offsets.push_back(reinterpret_cast<const void*>(offset * sizeof(unsigned int)));
+			offset += count;
+		}
+
+		return true;
+	}
+
+	// The cached mesh of name made with the parameters of key, generate() makes it when there is none
+	template<typename Generate>
+	ParametricSurface::Mesh getMesh(const std::string& name, std::uint64_t key, Generate generate)
+	{
+		if(Detail::getDirectory().empty())
+			return generate();
+
+		const auto path = getPath(name, key);
+
+		ParametricSurface::Mesh r;
+		if(load(path, key, r))
+			return r;
+
+		r = generate();
+
+		if(!save(path, key, r))
+			std::cerr << "Cannot write the mesh cache " << path << '\n';
+
+		return r;
+	}
+}
@@ -15,6 +15,7 @@
 #include <iostream>
 #include <GL/glew.h>
 #include <GL/freeglut.h>
+#include "SceneRegistry.h"
 
 namespace MoonDrawings
 {
@@ -503,4 +504,6 @@ namespace MoonDrawings
 
 		return 0;
 	}
+
+	static SceneRegistry::Registrar registrar{ { "MoonDrawings", main, setup, drawScene, resize, keyInput } };
 }
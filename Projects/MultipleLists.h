@@ -1,3 +1,4 @@
+#pragma once
 /////////////////////////////////////////////////////////////////////////////////////         
 // This program using multiple  display lists.  
 /////////////////////////////////////////////////////////////////////////////////////
@@ -6,6 +7,7 @@
 
 #include <GL/glew.h>
 #include <GL/freeglut.h> 
+#include "SceneRegistry.h"
 #include <vector>
 
 namespace MultipleLists
@@ -124,4 +126,6 @@ namespace MultipleLists
 
 		return 0;
 	}
+
+	static SceneRegistry::Registrar registrar{ { "MultipleLists", main, setup, drawScene, resize, keyInput } };
 }
\ No newline at end of file
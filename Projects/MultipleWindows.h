@@ -1,3 +1,4 @@
+#pragma once
 #define _USE_MATH_DEFINES 
 
 #include <cmath>
@@ -5,6 +6,7 @@
 
 #include <GL/glew.h>
 #include <GL/freeglut.h> 
+#include "SceneRegistry.h"
 
 namespace MultipleWindows
 {
@@ -153,4 +155,6 @@ namespace MultipleWindows
 
 		return 0;
 	}
+
+	static SceneRegistry::Registrar registrar{ { "MultipleWindows", main, setup1, drawScene1, resize1, keyInput } };
 }
\ No newline at end of file
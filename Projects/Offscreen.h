@@ -0,0 +1,247 @@
+#pragma once
+///////////////////////////////////////////////////////////////////////////////////////
+// Offscreen rendering backend: an EGL context without any window (Mesa's
+// surfaceless platform, so llvmpipe works on hosts without GPU or display)
+// rendering into a framebuffer object, and a driver that runs a registered
+// scene's setup/resize/drawScene for N frames and measures every frame.
+//
+// Pulls in OffscreenGlut.h and FrameCounters.h, so the program must not link
+// libglut and this header has to be included before the scenes, from exactly
+// one .cpp file.
+///////////////////////////////////////////////////////////////////////////////////////
+
+#include <string>
+#include <vector>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <GL/glew.h>
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+#include "FrameCounters.h"
+#include "OffscreenGlut.h"
+#include "SceneRegistry.h"
+#include "FrameClock.h"
+#include "Benchmark.h"
+#include "GLContext.h"
+
+namespace Offscreen
+{
+	struct Context
+	{
+		Context() = default;
+		Context(const Context&) = delete;
+		Context& operator=(const Context&) = delete;
+
+		~Context()
+		{
+			destroy();
+		}
+
+		bool create(int pWidth, int pHeight)
+		{
+			width = pWidth;
+			height = pHeight;
+
+			display = getDisplay();
+			if(display == EGL_NO_DISPLAY || !eglInitialize(display, nullptr, nullptr))
+				return fail("cannot initialize EGL display");
+
+			// EGL_SURFACE_TYPE defaults to EGL_WINDOW_BIT which surfaceless displays never offer
+			const EGLint configAttribs[] = {
+				EGL_SURFACE_TYPE, EGL_PBUFFER_BIT,
+				EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT,
+				EGL_NONE
+			};
+
+			EGLConfig config;
+			EGLint configsN{};
+			if(!eglChooseConfig(display, configAttribs, &config, 1, &configsN) || configsN == 0)
+				return fail("no EGL config with desktop OpenGL support");
+
+			if(!eglBindAPI(EGL_OPENGL_API))
+				return fail("EGL cannot bind desktop OpenGL");
+
+			// The same 4.3 compatibility context every scene asks glut for
+			const EGLint contextAttribs[] = {
+				EGL_CONTEXT_MAJOR_VERSION, 4,
+				EGL_CONTEXT_MINOR_VERSION, 3,
+				EGL_CONTEXT_OPENGL_PROFILE_MASK, EGL_CONTEXT_OPENGL_COMPATIBILITY_PROFILE_BIT,
+				EGL_NONE
+			};
+
+			context = eglCreateContext(display, config, EGL_NO_CONTEXT, contextAttribs);
+			if(context == EGL_NO_CONTEXT)
+				context = eglCreateContext(display, config, EGL_NO_CONTEXT, nullptr);
+
+			if(context == EGL_NO_CONTEXT)
+				return fail("cannot create OpenGL context");
+
+			if(!eglMakeCurrent(display, EGL_NO_SURFACE, EGL_NO_SURFACE, context))
+				return fail("cannot make context current without surface");
+
+			GLContext::begin();
+
+			glewExperimental = GL_TRUE;
+			glewInit();
+
+			createFramebuffer();
+
+			if(glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+				return fail("offscreen framebuffer is incomplete");
+
+			return true;
+		}
+
+		const std::string& getError() const noexcept
+		{
+			return error;
+		}
+
+		int getWidth() const noexcept
+		{
+			return width;
+		}
+
+		int getHeight() const noexcept
+		{
+			return height;
+		}
+
+		std::string getRenderer() const
+		{
+			const auto renderer = glGetString(GL_RENDERER);
+			return renderer ? reinterpret_cast<const char*>(renderer) : "unknown";
+		}
+
+	private:
+
+		EGLDisplay display{ EGL_NO_DISPLAY };
+		EGLContext context{ EGL_NO_CONTEXT };
+		GLuint framebuffer{};
+		GLuint renderbuffers[2]{};
+		int width{};
+		int height{};
+		std::string error;
+
+		bool fail(const std::string& message)
+		{
+			error = message;
+			return false;
+		}
+
+		static EGLDisplay getDisplay()
+		{
+			const auto extensions = eglQueryString(EGL_NO_DISPLAY, EGL_EXTENSIONS);
+			const auto getPlatformDisplay = reinterpret_cast<PFNEGLGETPLATFORMDISPLAYEXTPROC>(
+				eglGetProcAddress("eglGetPlatformDisplayEXT"));
+
+			if(extensions && getPlatformDisplay && std::strstr(extensions, "EGL_MESA_platform_surfaceless"))
+				return getPlatformDisplay(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, nullptr);
+
+			return eglGetDisplay(EGL_DEFAULT_DISPLAY);
+		}
+
+		void createFramebuffer()
+		{
+			glGenRenderbuffers(2, renderbuffers);
+
+			glBindRenderbuffer(GL_RENDERBUFFER, renderbuffers[0]);
+			glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, width, height);
+
+			glBindRenderbuffer(GL_RENDERBUFFER, renderbuffers[1]);
+			glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH24_STENCIL8, width, height);
+
+			glGenFramebuffers(1, &framebuffer);
+			glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+			glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, renderbuffers[0]);
+			glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER, renderbuffers[1]);
+
+			glDrawBuffer(GL_COLOR_ATTACHMENT0);
+			glReadBuffer(GL_COLOR_ATTACHMENT0);
+		}
+
+		void destroy()
+		{
+			if(context != EGL_NO_CONTEXT)
+			{
+				glDeleteFramebuffers(1, &framebuffer);
+				glDeleteRenderbuffers(2, renderbuffers);
+				GLContext::end();
+				eglMakeCurrent(display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+				eglDestroyContext(display, context);
+			}
+
+			if(display != EGL_NO_DISPLAY)
+				eglTerminate(display);
+		}
+	};
+
+	struct RunSettings
+	{
+		int frames = 100;
+		// Frames rendered before measuring, they pay for lazy initialization
+		int warmupFrames = 5;
+		// Synthetic time between frames: every FrameClock::Stopwatch reports it
+		// and glutTimerFunc callbacks are fired on this virtual clock
+		double framePeriodMs = 1000.0 / 60.0;
+		// Keys pressed after setup, e.g. " " to start most animations
+		std::string keys;
+	};
+
+	// cpuMs is the time spent inside drawScene, i.e. the CPU cost of building and
+	// submitting the frame, totalMs adds waiting for the (software) GPU in glFinish
+	inline std::vector<Benchmark::Sample> run(const SceneRegistry::Scene& scene, const Context& context, const RunSettings& settings)
+	{
+		using namespace std::chrono;
+		using Milliseconds = duration<double, std::milli>;
+
+		OffscreenGlut::reset();
+		FrameClock::fixedTimestep() = static_cast<float>(settings.framePeriodMs / 1000.0);
+
+		if(scene.setup)
+			scene.setup();
+
+		if(scene.resize)
+			scene.resize(context.getWidth(), context.getHeight());
+
+		for(const auto key : settings.keys)
+		{
+			if(scene.keyInput)
+				scene.keyInput(static_cast<unsigned char>(key), 0, 0);
+		}
+
+		for(int i{}; i < settings.warmupFrames; ++i)
+		{
+			scene.drawScene();
+			OffscreenGlut::advanceTime(settings.framePeriodMs);
+		}
+
+		glFinish();
+
+		std::vector<Benchmark::Sample> r;
+		r.reserve(settings.frames);
+
+		for(int i{}; i < settings.frames; ++i)
+		{
+			const auto counters = FrameCounters::get();
+			const auto start = steady_clock::now();
+			scene.drawScene();
+			const auto submitted = steady_clock::now();
+			const auto countersAfter = FrameCounters::get();
+			glFinish();
+			const auto finished = steady_clock::now();
+
+			r.push_back({
+				Milliseconds(submitted - start).count(),
+				Milliseconds(finished - start).count(),
+				countersAfter.drawCalls - counters.drawCalls,
+				countersAfter.allocations - counters.allocations
+			});
+
+			OffscreenGlut::advanceTime(settings.framePeriodMs);
+		}
+
+		return r;
+	}
+}
@@ -0,0 +1,411 @@
+#pragma once
+///////////////////////////////////////////////////////////////////////////////////////
+// Window-system-free implementation of the part of the freeglut API the scenes use.
+//
+// Headless builds link this instead of libglut: freeglut refuses to do anything
+// (including glutSolidSphere and the fonts) before glutInit has opened a display,
+// which does not exist on the build hosts. Window and menu calls are no-ops,
+// callbacks are remembered so the driver can invoke them, glutTimerFunc runs on
+// a virtual clock advanced by the driver and the shapes are drawn in immediate
+// mode the same way freeglut tessellates them.
+//
+// Include it from exactly one .cpp file, the same way as Scenes.h.
+///////////////////////////////////////////////////////////////////////////////////////
+
+#define _USE_MATH_DEFINES
+
+#include <cmath>
+#include <vector>
+#include <algorithm>
+#include <GL/glew.h>
+#include <GL/freeglut.h>
+
+namespace OffscreenGlut
+{
+	struct Timer
+	{
+		double dueMs;
+		void (*callback)(int);
+		int value;
+	};
+
+	struct State
+	{
+		int windowWidth = 300;
+		int windowHeight = 300;
+
+		void (*display)() = nullptr;
+		void (*reshape)(int, int) = nullptr;
+		void (*keyboard)(unsigned char, int, int) = nullptr;
+
+		bool redisplayPosted = false;
+		double timeMs = 0.0;
+		std::vector<Timer> timers;
+	};
+
+	inline State& getState()
+	{
+		static State state;
+		return state;
+	}
+
+	// Moves the virtual clock forward and fires every timer that became due,
+	// including the ones re-registered by the callbacks themselves
+	inline void advanceTime(double ms)
+	{
+		auto& state = getState();
+		state.timeMs += ms;
+
+		for(;;)
+		{
+			auto& timers = state.timers;
+			const auto due = std::min_element(timers.begin(), timers.end(), [](const Timer& lhs, const Timer& rhs) {
+				return lhs.dueMs < rhs.dueMs;
+			});
+
+			if(due == timers.end() || due->dueMs > state.timeMs)
+				break;
+
+			const auto timer = *due;
+			timers.erase(due);
+			timer.callback(timer.value);
+		}
+	}
+
+	inline void reset()
+	{
+		getState() = State{};
+	}
+
+	inline void circleTable(std::vector<double>& sint, std::vector<double>& cost, int n)
+	{
+		const auto size = std::abs(n);
+		const auto angle = 2.0 * M_PI / (n == 0 ? 1 : n);
+
+		sint.resize(size + 1);
+		cost.resize(size + 1);
+
+		for(int i = 0; i <= size; ++i)
+		{
+			sint[i] = std::sin(angle * i);
+			cost[i] = std::cos(angle * i);
+		}
+	}
+
+	inline void sphere(double radius, int slices, int stacks, bool wire)
+	{
+		std::vector<double> sint1, cost1, sint2, cost2;
+		circleTable(sint1, cost1, -slices);
+		circleTable(sint2, cost2, stacks * 2);
+
+		if(wire)
+		{
+			for(int i = 1; i < stacks; ++i)
+			{
+				const auto z = cost2[i];
+				const auto r = sint2[i];
+
+				glBegin(GL_LINE_LOOP);
+				for(int j = 0; j < slices; ++j)
+				{
+					glNormal3d(cost1[j] * r, sint1[j] * r, z);
+					glVertex3d(cost1[j] * r * radius, sint1[j] * r * radius, z * radius);
+				}
+				glEnd();
+			}
+
+			for(int i = 0; i < slices; ++i)
+			{
+				glBegin(GL_LINE_STRIP);
+				for(int j = 0; j <= stacks; ++j)
+				{
+					const auto x = cost1[i] * sint2[j];
+					const auto y = sint1[i] * sint2[j];
+					const auto z = cost2[j];
+
+					glNormal3d(x, y, z);
+					glVertex3d(x * radius, y * radius, z * radius);
+				}
+				glEnd();
+			}
+
+			return;
+		}
+
+		for(int i = 0; i < stacks; ++i)
+		{
+			glBegin(GL_QUAD_STRIP);
+			for(int j = 0; j <= slices; ++j)
+			{
+				for(int k = i + 1; k >= i; --k)
+				{
+					const auto x = cost1[j] * sint2[k];
+					const auto y = sint1[j] * sint2[k];
+					const auto z = cost2[k];
+
+					glNormal3d(x, y, z);
+					glVertex3d(x * radius, y * radius, z * radius);
+				}
+			}
+			glEnd();
+		}
+	}
+
+	inline void cube(double size, bool wire)
+	{
+		static const GLfloat normals[6][3] = {
+			{ -1.f, 0.f, 0.f }, { 0.f, 1.f, 0.f }, { 1.f, 0.f, 0.f },
+			{ 0.f, -1.f, 0.f }, { 0.f, 0.f, 1.f }, { 0.f, 0.f, -1.f }
+		};
+
+		static const GLint faces[6][4] = {
+			{ 0, 1, 2, 3 }, { 3, 2, 6, 7 }, { 7, 6, 5, 4 },
+			{ 4, 5, 1, 0 }, { 5, 6, 2, 1 }, { 7, 4, 0, 3 }
+		};
+
+		const auto s = size / 2.0;
+		const GLdouble v[8][3] = {
+			{ -s, -s, -s }, { -s, -s, s }, { -s, s, s }, { -s, s, -s },
+			{ s, -s, -s }, { s, -s, s }, { s, s, s }, { s, s, -s }
+		};
+
+		for(int i = 0; i < 6; ++i)
+		{
+			glBegin(wire ? GL_LINE_LOOP : GL_QUADS);
+			glNormal3fv(normals[i]);
+			for(int j = 0; j < 4; ++j)
+				glVertex3dv(v[faces[i][j]]);
+			glEnd();
+		}
+	}
+
+	inline void cone(double base, double height, int slices, int stacks)
+	{
+		std::vector<double> sint, cost;
+		circleTable(sint, cost, -slices);
+
+		const auto zStep = height / std::max(stacks, 1);
+		const auto rStep = base / std::max(stacks, 1);
+
+		for(int i = 0; i < stacks; ++i)
+		{
+			glBegin(GL_LINE_LOOP);
+			for(int j = 0; j < slices; ++j)
+				glVertex3d(cost[j] * (base - rStep * i), sint[j] * (base - rStep * i), zStep * i);
+			glEnd();
+		}
+
+		glBegin(GL_LINES);
+		for(int j = 0; j < slices; ++j)
+		{
+			glVertex3d(cost[j] * base, sint[j] * base, 0.0);
+			glVertex3d(0.0, 0.0, height);
+		}
+		glEnd();
+	}
+
+	inline void cylinder(double radius, double height, int slices, int stacks)
+	{
+		std::vector<double> sint, cost;
+		circleTable(sint, cost, -slices);
+
+		const auto zStep = height / std::max(stacks, 1);
+
+		for(const auto cap : { 0.0, height })
+		{
+			glBegin(GL_TRIANGLE_FAN);
+			glNormal3d(0.0, 0.0, cap == 0.0 ? -1.0 : 1.0);
+			glVertex3d(0.0, 0.0, cap);
+			for(int j = 0; j <= slices; ++j)
+				glVertex3d(cost[j] * radius, sint[j] * radius, cap);
+			glEnd();
+		}
+
+		for(int i = 0; i < stacks; ++i)
+		{
+			glBegin(GL_QUAD_STRIP);
+			for(int j = 0; j <= slices; ++j)
+			{
+				glNormal3d(cost[j], sint[j], 0.0);
+				glVertex3d(cost[j] * radius, sint[j] * radius, zStep * i);
+				glVertex3d(cost[j] * radius, sint[j] * radius, zStep * (i + 1));
+			}
+			glEnd();
+		}
+	}
+
+	inline void torus(double innerRadius, double outerRadius, int sides, int rings)
+	{
+		std::vector<double> sint1, cost1, sint2, cost2;
+		circleTable(sint1, cost1, -rings);
+		circleTable(sint2, cost2, sides);
+
+		for(int i = 0; i < rings; ++i)
+		{
+			glBegin(GL_LINE_LOOP);
+			for(int j = 0; j < sides; ++j)
+			{
+				const auto r = outerRadius + innerRadius * cost2[j];
+				glNormal3d(cost1[i] * cost2[j], sint1[i] * cost2[j], sint2[j]);
+				glVertex3d(cost1[i] * r, sint1[i] * r, innerRadius * sint2[j]);
+			}
+			glEnd();
+		}
+
+		for(int j = 0; j < sides; ++j)
+		{
+			glBegin(GL_LINE_LOOP);
+			for(int i = 0; i < rings; ++i)
+			{
+				const auto r = outerRadius + innerRadius * cost2[j];
+				glNormal3d(cost1[i] * cost2[j], sint1[i] * cost2[j], sint2[j]);
+				glVertex3d(cost1[i] * r, sint1[i] * r, innerRadius * sint2[j]);
+			}
+			glEnd();
+		}
+	}
+
+	// Width of a glyph in GLUT_STROKE_MONO_ROMAN units; used for every stroke font
+	const float strokeAdvance = 104.76f;
+}
+
+extern "C"
+{
+	void* glutStrokeRoman;
+	void* glutStrokeMonoRoman;
+	void* glutBitmap9By15;
+	void* glutBitmap8By13;
+	void* glutBitmapTimesRoman10;
+	void* glutBitmapTimesRoman24;
+	void* glutBitmapHelvetica10;
+	void* glutBitmapHelvetica12;
+	void* glutBitmapHelvetica18;
+
+	void glutInit(int*, char**) {}
+	void glutInitContextVersion(int, int) {}
+	void glutInitContextProfile(int) {}
+	void glutInitDisplayMode(unsigned int) {}
+	void glutInitWindowPosition(int, int) {}
+
+	void glutInitWindowSize(int width, int height)
+	{
+		auto& state = OffscreenGlut::getState();
+		state.windowWidth = width;
+		state.windowHeight = height;
+	}
+
+	int glutCreateWindow(const char*)
+	{
+		return 1;
+	}
+
+	void glutMainLoop(void) {}
+	void glutSwapBuffers(void) {}
+
+	void glutPostRedisplay(void)
+	{
+		OffscreenGlut::getState().redisplayPosted = true;
+	}
+
+	void glutDisplayFunc(void (*callback)(void))
+	{
+		OffscreenGlut::getState().display = callback;
+	}
+
+	void glutReshapeFunc(void (*callback)(int, int))
+	{
+		OffscreenGlut::getState().reshape = callback;
+	}
+
+	void glutKeyboardFunc(void (*callback)(unsigned char, int, int))
+	{
+		OffscreenGlut::getState().keyboard = callback;
+	}
+
+	void glutSpecialFunc(void (*)(int, int, int)) {}
+	void glutMouseFunc(void (*)(int, int, int, int)) {}
+	void glutMouseWheelFunc(void (*)(int, int, int, int)) {}
+	void glutMotionFunc(void (*)(int, int)) {}
+	void glutPassiveMotionFunc(void (*)(int, int)) {}
+
+	void glutTimerFunc(unsigned int time, void (*callback)(int), int value)
+	{
+		auto& state = OffscreenGlut::getState();
+		state.timers.push_back({ state.timeMs + time, callback, value });
+	}
+
+	int glutCreateMenu(void (*)(int))
+	{
+		return 1;
+	}
+
+	void glutAddMenuEntry(const char*, int) {}
+	void glutAddSubMenu(const char*, int) {}
+	void glutAttachMenu(int) {}
+
+	void glutWireSphere(double radius, GLint slices, GLint stacks)
+	{
+		OffscreenGlut::sphere(radius, slices, stacks, true);
+	}
+
+	void glutSolidSphere(double radius, GLint slices, GLint stacks)
+	{
+		OffscreenGlut::sphere(radius, slices, stacks, false);
+	}
+
+	void glutWireCube(double size)
+	{
+		OffscreenGlut::cube(size, true);
+	}
+
+	void glutSolidCube(double size)
+	{
+		OffscreenGlut::cube(size, false);
+	}
+
+	void glutWireCone(double base, double height, GLint slices, GLint stacks)
+	{
+		OffscreenGlut::cone(base, height, slices, stacks);
+	}
+
+	void glutSolidCylinder(double radius, double height, GLint slices, GLint stacks)
+	{
+		OffscreenGlut::cylinder(radius, height, slices, stacks);
+	}
+
+	void glutWireTorus(double innerRadius, double outerRadius, GLint sides, GLint rings)
+	{
+		OffscreenGlut::torus(innerRadius, outerRadius, sides, rings);
+	}
+
+	// The Newell teapot patches are not carried here; a sphere of the same extent
+	// keeps the cost of the frame in the same range
+	void glutWireTeapot(double size)
+	{
+		OffscreenGlut::sphere(size, 10, 10, true);
+	}
+
+	// Glyph data is not carried either, text only moves the raster position or
+	// the stroke origin like the real fonts do
+	void glutBitmapCharacter(void*, int)
+	{
+		glBitmap(0, 0, 0.f, 0.f, 8.f, 0.f, nullptr);
+	}
+
+	void glutBitmapString(void* font, const unsigned char* string)
+	{
+		for(; *string; ++string)
+			glutBitmapCharacter(font, *string);
+	}
+
+	void glutStrokeCharacter(void*, int)
+	{
+		glTranslatef(OffscreenGlut::strokeAdvance, 0.f, 0.f);
+	}
+
+	void glutStrokeString(void* font, const unsigned char* string)
+	{
+		for(; *string; ++string)
+			glutStrokeCharacter(font, *string);
+	}
+}
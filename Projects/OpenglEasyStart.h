@@ -1,3 +1,4 @@
+#pragma once
 ///////////////////////////////////////////////////////////////////////////////////////          
 //Simple start up program
 /////////////////////////////////////////////////////////////////////////////////////// 
@@ -9,6 +10,7 @@
 #include <iostream>
 #include <GL/glew.h>
 #include <GL/freeglut.h>
+#include "SceneRegistry.h"
 
 namespace OpenglEasyStart
 {
@@ -82,4 +84,5 @@ namespace OpenglEasyStart
 		return 0;
 	}
 
+	static SceneRegistry::Registrar registrar{ { "OpenglEasyStart", main, setup, drawScene, resize, keyInput } };
 }
@@ -0,0 +1,252 @@
+#pragma once
+///////////////////////////////////////////////////////////////////////////////////////
+// Tessellation of parametric surfaces into shared-vertex indexed meshes.
+//
+// A surface is a function of the grid column i in [0, uSlices] and row j in
+// [0, vSlices] returning the vertex there, so scenes keep their own angle
+// formulas. The vertices are stored row after row and indexed either as one
+// triangle strip per row, in the order the scenes always drew them, as a
+// triangle list with the same triangles, or as the lines of the grid for
+// wireframes. Large grids are evaluated on several threads, one band of rows
+// each.
+///////////////////////////////////////////////////////////////////////////////////////
+
+#include <cmath>
+#include <thread>
+#include <vector>
+#include <cstddef>
+#include <algorithm>
+#include <GL/glew.h>
+#include "SimdMath.h"
+
+namespace ParametricSurface
+{
+	using SimdMath::Vec3;
+
+	// Grids with fewer vertices are not worth starting threads for
+	constexpr std::size_t parallelVertices = 1 << 15;
+
+	enum class Topology
+	{
+		strips,
+		triangles,
+		lines
+	};
+
+	struct Settings
+	{
+		int uSlices;
+		int vSlices;
+		Topology topology = Topology::strips;
+		bool normals = false;
+	};
+
+	// Vertex (i, j) is at j * (uSlices + 1) + i
+	struct Mesh
+	{
+		int uSlices;
+		int vSlices;
+		Topology topology;
+		std::vector<Vec3> positions;
+		// Empty unless the settings asked for them
+		std::vector<Vec3> normals;
+		std::vector<unsigned int> indices;
+		// Strips only, the index count and byte offset in an element buffer of every row
+		std::vector<GLsizei> counts;
+		std::vector<const void*> offsets;
+
+		int getStripLength() const noexcept
+		{
+			return 2 * (uSlices + 1);
+		}
+
+		// The strip between rows j and j + 1 in client memory
+		const unsigned int* getStrip(int j) const
+		{
+			return indices.data() + static_cast<std::size_t>(j) * getStripLength();
+		}
+	};
+
+	namespace Detail
+	{
+		// Calls row(j) for every j in [0, rows), on several threads for large grids
+		template<typename Row>
+		void forEachRow(int rows, std::size_t rowLength, Row row)
+		{
+			const auto threadsN = std::min<std::size_t>(std::thread::hardware_concurrency(), std::max(rows, 0));
+
+			if(threadsN < 2 || rows * rowLength < parallelVertices)
+			{
+				for(int j{}; j < rows; ++j)
+					row(j);
+
+				return;
+			}
+
+			const auto band = static_cast<int>((rows + threadsN - 1) / threadsN);
+			const auto forBand = [rows, band, &row](int first) {
+				for(int j = first; j < std::min(rows, first + band); ++j)
+					row(j);
+			};
+
+			std::vector<std::thread> threads;
+			threads.reserve(threadsN - 1);
+
+			for(auto first = band; first < rows; first += band)
+				threads.emplace_back(forBand, first);
+
+			forBand(0);
+
+			for(auto& thread : threads)
+				thread.join();
+		}
+	}
+
+	// surface(i, j) must be safe to call from several threads at once
+	template<typename Surface>
+	std::vector<Vec3> evaluate(int uSlices, int vSlices, Surface surface)
+	{
+		const auto rowLength = static_cast<std::size_t>(uSlices + 1);
+		std::vector<Vec3> r(rowLength * (vSlices + 1));
+
+		Detail::forEachRow(vSlices + 1, rowLength, [&](int j) {
+			auto* row = r.data() + j * rowLength;
+			for(int i{}; i <= uSlices; ++i)
+				row[i] = surface(i, j);
+		});
+
+		return r;
+	}
+
+	// Row j to j + 1 as a strip starting on row j + 1, the strips follow each other
+	inline std::vector<unsigned int> getStripIndices(int uSlices, int vSlices)
+	{
+		const auto rowLength = static_cast<unsigned int>(uSlices + 1);
+		std::vector<unsigned int> r;
+		r.reserve(2 * rowLength * vSlices);
+
+		for(unsigned int j{}; j < static_cast<unsigned int>(vSlices); ++j)
+		{
+			for(unsigned int i{}; i < rowLength; ++i)
+			{
+				r.push_back((j + 1) * rowLength + i);
+				r.push_back(j * rowLength + i);
+			}
+		}
+
+		return r;
+	}
+
+	// The triangles of the strips with the same winding, two per grid cell
+	inline std::vector<unsigned int> getTriangleIndices(int uSlices, int vSlices)
+	{
+		const auto rowLength = static_cast<unsigned int>(uSlices + 1);
+		std::vector<unsigned int> r;
+		r.reserve(6 * static_cast<std::size_t>(uSlices) * vSlices);
+
+		for(unsigned int j{}; j < static_cast<unsigned int>(vSlices); ++j)
+		{
+			for(unsigned int i{}; i < static_cast<unsigned int>(uSlices); ++i)
+			{
+				const auto top = (j + 1) * rowLength + i;
+				const auto bottom = j * rowLength + i;
+
+				r.insert(r.end(), { top, bottom, top + 1 });
+				r.insert(r.end(), { top + 1, bottom, bottom + 1 });
+			}
+		}
+
+		return r;
+	}
+
+	// Every edge of the grid once, the rows first and then the columns
+	inline std::vector<unsigned int> getLineIndices(int uSlices, int vSlices)
+	{
+		const auto rowLength = static_cast<unsigned int>(uSlices + 1);
+		std::vector<unsigned int> r;
+		r.reserve(2 * (static_cast<std::size_t>(uSlices) * (vSlices + 1) + static_cast<std::size_t>(rowLength) * vSlices));
+
+		for(unsigned int j{}; j <= static_cast<unsigned int>(vSlices); ++j)
+			for(unsigned int i{}; i < static_cast<unsigned int>(uSlices); ++i)
+				r.insert(r.end(), { j * rowLength + i, j * rowLength + i + 1 });
+
+		for(unsigned int i{}; i < rowLength; ++i)
+			for(unsigned int j{}; j < static_cast<unsigned int>(vSlices); ++j)
+				r.insert(r.end(), { j * rowLength + i, (j + 1) * rowLength + i });
+
+		return r;
+	}
+
+	// The area weighted normals of the cells around every vertex, along dP/du x dP/dv.
+	// When the first and last column meet the cells on both sides of the seam count
+	inline std::vector<Vec3> getNormals(const std::vector<Vec3>& positions, int uSlices, int vSlices)
+	{
+		const auto rowLength = uSlices + 1;
+		const auto at = [&](int i, int j) -> const Vec3& {
+			return positions[static_cast<std::size_t>(j) * rowLength + i];
+		};
+
+		bool closed = uSlices > 1;
+		for(int j{}; closed && j <= vSlices; ++j)
+			closed = at(0, j) == at(uSlices, j);
+
+		// Twice the vector area of the cell right of and above vertex (i, j)
+		const auto getCellNormal = [&](int i, int j) {
+			if(closed)
+				i = (i + uSlices) % uSlices;
+
+			if(i < 0 || i >= uSlices || j < 0 || j >= vSlices)
+				return Vec3{};
+
+			return SimdMath::cross(at(i + 1, j + 1) - at(i, j), at(i, j + 1) - at(i + 1, j));
+		};
+
+		std::vector<Vec3> r(positions.size());
+
+		Detail::forEachRow(vSlices + 1, rowLength, [&](int j) {
+			for(int i{}; i <= uSlices; ++i)
+			{
+				const auto n = getCellNormal(i, j) + getCellNormal(i - 1, j) + getCellNormal(i, j - 1) + getCellNormal(i - 1, j - 1);
+				const auto length = n.length();
+				r[static_cast<std::size_t>(j) * rowLength + i] = length > 0.f ? n / length : n;
+			}
+		});
+
+		return r;
+	}
+
+	template<typename Surface>
+	Mesh tessellate(const Settings& settings, Surface surface)
+	{
+		Mesh r;
+		r.uSlices = settings.uSlices;
+		r.vSlices = settings.vSlices;
+		r.topology = settings.topology;
+		r.positions = evaluate(settings.uSlices, settings.vSlices, surface);
+
+		if(settings.normals)
+			r.normals = getNormals(r.positions, settings.uSlices, settings.vSlices);
+
+		if(settings.topology == Topology::triangles)
+		{
+			r.indices = getTriangleIndices(settings.uSlices, settings.vSlices);
+			return r;
+		}
+
+		if(settings.topology == Topology::lines)
+		{
+			r.indices = getLineIndices(settings.uSlices, settings.vSlices);
+			return r;
+		}
+
+		r.indices = getStripIndices(settings.uSlices, settings.vSlices);
+
+		for(int j{}; j < settings.vSlices; ++j)
+		{
+			r.counts.push_back(r.getStripLength());
+			r.offsets.push_back(reinterpret_cast<const void*>(static_cast<std::size_t>(j) * r.getStripLength() * sizeof(unsigned int)));
+		}
+
+		return r;
+	}
+}
@@ -0,0 +1,516 @@
+#pragma once
+///////////////////////////////////////////////////////////////////////////////////////
+// Retained replacements for the glutWire*/glutSolid* shapes.
+//
+// freeglut tessellates a shape again and submits it in immediate mode on every
+// call. Here every shape and resolution is tessellated once, the way freeglut
+// does it, into a vertex and an element buffer, and every later call binds them
+// and draws with one glMultiDrawElements per primitive type. Shapes whose size
+// only scales them are kept at unit size and scaled by the modelview, so
+// animated sizes share one mesh; the torus depends on both its radii and is
+// kept per radii. Lighting of scaled shapes needs GL_NORMALIZE, as with glScale.
+// drawWireSphereOnScreen picks its resolution from the size of the sphere on
+// screen, among the halvings LevelOfDetail makes of a surface.
+///////////////////////////////////////////////////////////////////////////////////////
+
+#define _USE_MATH_DEFINES
+
+#include <map>
+#include <cmath>
+#include <tuple>
+#include <vector>
+#include <cstddef>
+#include <algorithm>
+#include <GL/glew.h>
+#include "SimdMath.h"
+#include "GLContext.h"
+#include "LevelOfDetail.h"
+
+namespace Primitives
+{
+	using SimdMath::Vec3;
+
+	enum class Shape
+	{
+		wireSphere,
+		solidSphere,
+		wireCube,
+		solidCube,
+		wireCone,
+		solidCylinder,
+		wireTorus
+	};
+
+	struct Vertex
+	{
+		Vec3 position;
+		Vec3 normal;
+	};
+
+	// Index runs of one primitive type, drawn with one glMultiDrawElements
+	struct Part
+	{
+		GLenum mode;
+		std::vector<GLsizei> counts;
+		std::vector<const void*> offsets;
+	};
+
+	struct Mesh
+	{
+		std::vector<Vertex> vertices;
+		std::vector<unsigned int> indices;
+		std::vector<Part> parts;
+		// freeglut sends no normals for some shapes, they keep the current one
+		bool hasNormals = true;
+
+		unsigned int addVertex(const Vec3& position, const Vec3& normal = {})
+		{
+			vertices.push_back({ position, normal });
+			return static_cast<unsigned int>(vertices.size() - 1);
+		}
+
+		// Starts a run of the given type, runs of the same type following each other share a part
+		void begin(GLenum mode)
+		{
+			if(parts.empty() || parts.back().mode != mode)
+				parts.push_back({ mode, {}, {} });
+
+			parts.back().counts.push_back(0);
+			parts.back().offsets.push_back(reinterpret_cast<const void*>(indices.size() * sizeof(unsigned int)));
+		}
+
+		void add(unsigned int index)
+		{
+			indices.push_back(index);
+			++parts.back().counts.back();
+		}
+
+		// A closed loop of vertices as segments of the current GL_LINES run
+		void addLoop(const std::vector<unsigned int>& loop)
+		{
+			for(std::size_t i{}; i < loop.size(); ++i)
+			{
+				add(loop[i]);
+				add(loop[(i + 1) % loop.size()]);
+			}
+		}
+
+		void addLineStrip(const std::vector<unsigned int>& strip)
+		{
+			for(std::size_t i = 1; i < strip.size(); ++i)
+			{
+				add(strip[i - 1]);
+				add(strip[i]);
+			}
+		}
+	};
+
+	// The sines and cosines of n + 1 angles around the circle, backwards for negative n, like freeglut's table
+	inline void circleTable(std::vector<double>& sint, std::vector<double>& cost, int n)
+	{
+		const auto size = std::abs(n);
+		const auto angle = 2.0 * M_PI / (n == 0 ? 1 : n);
+
+		sint.resize(size + 1);
+		cost.resize(size + 1);
+
+		for(int i = 0; i <= size; ++i)
+		{
+			sint[i] = std::sin(angle * i);
+			cost[i] = std::cos(angle * i);
+		}
+	}
+
+	// Unit radius around the origin with the poles on Z
+	inline Mesh getSphere(int slices, int stacks, bool wire)
+	{
+		std::vector<double> sint1, cost1, sint2, cost2;
+		circleTable(sint1, cost1, -slices);
+		circleTable(sint2, cost2, stacks * 2);
+
+		// Wireframes close the rings with loops, the solid strips repeat the first slice at the end
+		const auto columns = wire ? slices : slices + 1;
+
+		Mesh r;
+		for(int j = 0; j <= stacks; ++j)
+		{
+			for(int i = 0; i < columns; ++i)
+			{
+				const Vec3 v(cost1[i] * sint2[j], sint1[i] * sint2[j], cost2[j]);
+				r.addVertex(v, v);
+			}
+		}
+
+		const auto at = [columns](int i, int j) {
+			return static_cast<unsigned int>(j * columns + i);
+		};
+
+		if(wire)
+		{
+			r.begin(GL_LINES);
+
+			for(int j = 1; j < stacks; ++j)
+			{
+				std::vector<unsigned int> ring;
+				for(int i = 0; i < slices; ++i)
+					ring.push_back(at(i, j));
+
+				r.addLoop(ring);
+			}
+
+			for(int i = 0; i < slices; ++i)
+			{
+				std::vector<unsigned int> meridian;
+				for(int j = 0; j <= stacks; ++j)
+					meridian.push_back(at(i, j));
+
+				r.addLineStrip(meridian);
+			}
+
+			return r;
+		}
+
+		for(int j = 0; j < stacks; ++j)
+		{
+			r.begin(GL_QUAD_STRIP);
+			for(int i = 0; i <= slices; ++i)
+			{
+				r.add(at(i, j + 1));
+				r.add(at(i, j));
+			}
+		}
+
+		return r;
+	}
+
+	// Unit edge around the origin, every face with its own vertices for its normal
+	inline Mesh getCube(bool wire)
+	{
+		static const Vec3 normals[6] = {
+			{ -1.f, 0.f, 0.f }, { 0.f, 1.f, 0.f }, { 1.f, 0.f, 0.f },
+			{ 0.f, -1.f, 0.f }, { 0.f, 0.f, 1.f }, { 0.f, 0.f, -1.f }
+		};
+
+		static const int faces[6][4] = {
+			{ 0, 1, 2, 3 }, { 3, 2, 6, 7 }, { 7, 6, 5, 4 },
+			{ 4, 5, 1, 0 }, { 5, 6, 2, 1 }, { 7, 4, 0, 3 }
+		};
+
+		const auto s = 0.5f;
+		const Vec3 corners[8] = {
+			{ -s, -s, -s }, { -s, -s, s }, { -s, s, s }, { -s, s, -s },
+			{ s, -s, -s }, { s, -s, s }, { s, s, s }, { s, s, -s }
+		};
+
+		Mesh r;
+		r.begin(wire ? GL_LINES : GL_QUADS);
+
+		for(int i = 0; i < 6; ++i)
+		{
+			std::vector<unsigned int> face;
+			for(int j = 0; j < 4; ++j)
+				face.push_back(r.addVertex(corners[faces[i][j]], normals[i]));
+
+			if(wire)
+			{
+				r.addLoop(face);
+				continue;
+			}
+
+			for(const auto index : face)
+				r.add(index);
+		}
+
+		return r;
+	}
+
+	// Unit base radius and height, the base at the origin and the apex on Z
+	inline Mesh getWireCone(int slices, int stacks)
+	{
+		std::vector<double> sint, cost;
+		circleTable(sint, cost, -slices);
+
+		const auto zStep = 1.0 / std::max(stacks, 1);
+		const auto rStep = 1.0 / std::max(stacks, 1);
+
+		Mesh r;
+		r.hasNormals = false;
+		r.begin(GL_LINES);
+
+		std::vector<unsigned int> base;
+		for(int i = 0; i < stacks; ++i)
+		{
+			std::vector<unsigned int> ring;
+			for(int j = 0; j < slices; ++j)
+				ring.push_back(r.addVertex(Vec3(cost[j] * (1.0 - rStep * i), sint[j] * (1.0 - rStep * i), zStep * i)));
+
+			r.addLoop(ring);
+
+			if(i == 0)
+				base = ring;
+		}
+
+		const auto apex = r.addVertex({ 0.f, 0.f, 1.f });
+		for(int j = 0; j < slices; ++j)
+		{
+			// Without stacks freeglut still draws the lines from the base
+			const auto b = base.empty() ? r.addVertex(Vec3(cost[j], sint[j], 0.0)) : base[j];
+			r.add(b);
+			r.add(apex);
+		}
+
+		return r;
+	}
+
+	// Unit radius and height, the caps at z = 0 and z = 1
+	inline Mesh getSolidCylinder(int slices, int stacks)
+	{
+		std::vector<double> sint, cost;
+		circleTable(sint, cost, -slices);
+
+		const auto zStep = 1.0 / std::max(stacks, 1);
+
+		Mesh r;
+		for(const auto cap : { 0.0, 1.0 })
+		{
+			const Vec3 normal(0.f, 0.f, cap == 0.0 ? -1.f : 1.f);
+
+			r.begin(GL_TRIANGLE_FAN);
+			r.add(r.addVertex(Vec3(0.0, 0.0, cap), normal));
+			for(int j = 0; j <= slices; ++j)
+				r.add(r.addVertex(Vec3(cost[j], sint[j], cap), normal));
+		}
+
+		const auto first = static_cast<unsigned int>(r.vertices.size());
+		for(int i = 0; i <= stacks; ++i)
+			for(int j = 0; j <= slices; ++j)
+				r.addVertex(Vec3(cost[j], sint[j], zStep * i), Vec3(cost[j], sint[j], 0.0));
+
+		for(int i = 0; i < stacks; ++i)
+		{
+			r.begin(GL_QUAD_STRIP);
+			for(int j = 0; j <= slices; ++j)
+			{
+				r.add(first + i * (slices + 1) + j);
+				r.add(first + (i + 1) * (slices + 1) + j);
+			}
+		}
+
+		return r;
+	}
+
+	inline Mesh getWireTorus(double innerRadius, double outerRadius, int sides, int rings)
+	{
+		std::vector<double> sint1, cost1, sint2, cost2;
+		circleTable(sint1, cost1, -rings);
+		circleTable(sint2, cost2, sides);
+
+		Mesh r;
+		for(int i = 0; i < rings; ++i)
+		{
+			for(int j = 0; j < sides; ++j)
+			{
+				const auto radius = outerRadius + innerRadius * cost2[j];
+				r.addVertex(Vec3(cost1[i] * radius, sint1[i] * radius, innerRadius * sint2[j]),
+					Vec3(cost1[i] * cost2[j], sint1[i] * cost2[j], sint2[j]));
+			}
+		}
+
+		r.begin(GL_LINES);
+
+		for(int i = 0; i < rings; ++i)
+		{
+			std::vector<unsigned int> ring;
+			for(int j = 0; j < sides; ++j)
+				ring.push_back(i * sides + j);
+
+			r.addLoop(ring);
+		}
+
+		for(int j = 0; j < sides; ++j)
+		{
+			std::vector<unsigned int> side;
+			for(int i = 0; i < rings; ++i)
+				side.push_back(i * sides + j);
+
+			r.addLoop(side);
+		}
+
+		return r;
+	}
+
+	namespace Detail
+	{
+		// The parameters a shape is tessellated with, the unused ones are zero
+		using Key = std::tuple<Shape, int, int, double, double>;
+
+		struct Primitive
+		{
+			GLuint vertexBuffer;
+			GLuint elementBuffer;
+			std::vector<Part> parts;
+			bool hasNormals;
+		};
+
+		struct Cache
+		{
+			unsigned context = 0;
+			std::map<Key, Primitive> primitives;
+		};
+
+		// The buffers were made in the context of the cache, in another one it starts over
+		inline std::map<Key, Primitive>& getCache()
+		{
+			static Cache cache;
+
+			if(!GLContext::isCurrent(cache.context))
+			{
+				cache.primitives.clear();
+				cache.context = GLContext::getGeneration();
+			}
+
+			return cache.primitives;
+		}
+
+		inline Primitive upload(const Mesh& mesh)
+		{
+			Primitive r{ 0, 0, mesh.parts, mesh.hasNormals };
+
+			glGenBuffers(1, &r.vertexBuffer);
+			glGenBuffers(1, &r.elementBuffer);
+
+			glBindBuffer(GL_ARRAY_BUFFER, r.vertexBuffer);
+			glBufferData(GL_ARRAY_BUFFER, mesh.vertices.size() * sizeof(Vertex), mesh.vertices.data(), GL_STATIC_DRAW);
+			glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+			// Bound to no vertex array object, so the scene's one keeps its element buffer
+			GLint vertexArray;
+			glGetIntegerv(GL_VERTEX_ARRAY_BINDING, &vertexArray);
+			glBindVertexArray(0);
+			glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, r.elementBuffer);
+			glBufferData(GL_ELEMENT_ARRAY_BUFFER, mesh.indices.size() * sizeof(unsigned int), mesh.indices.data(), GL_STATIC_DRAW);
+			glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+			glBindVertexArray(vertexArray);
+
+			return r;
+		}
+
+		template<typename Tessellate>
+		const Primitive& get(const Key& key, Tessellate tessellate)
+		{
+			auto& cache = getCache();
+			auto it = cache.find(key);
+
+			if(it == cache.end())
+				it = cache.emplace(key, upload(tessellate())).first;
+
+			return it->second;
+		}
+
+		// Draws outside of any vertex array object and restores the client arrays afterwards
+		inline void draw(const Primitive& primitive)
+		{
+			GLint vertexArray;
+			glGetIntegerv(GL_VERTEX_ARRAY_BINDING, &vertexArray);
+			glBindVertexArray(0);
+
+			glPushClientAttrib(GL_CLIENT_VERTEX_ARRAY_BIT);
+
+			glBindBuffer(GL_ARRAY_BUFFER, primitive.vertexBuffer);
+			glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, primitive.elementBuffer);
+
+			glEnableClientState(GL_VERTEX_ARRAY);
+			glVertexPointer(3, GL_FLOAT, sizeof(Vertex), reinterpret_cast<void*>(offsetof(Vertex, position)));
+
+			if(primitive.hasNormals)
+			{
+				glEnableClientState(GL_NORMAL_ARRAY);
+				glNormalPointer(GL_FLOAT, sizeof(Vertex), reinterpret_cast<void*>(offsetof(Vertex, normal)));
+			}
+
+			for(const auto& part : primitive.parts)
+				glMultiDrawElements(part.mode, part.counts.data(), GL_UNSIGNED_INT, part.offsets.data(), part.counts.size());
+
+			glPopClientAttrib();
+			glBindVertexArray(vertexArray);
+		}
+
+		template<typename Tessellate>
+		void drawScaled(const Key& key, const Vec3& scale, Tessellate tessellate)
+		{
+			const auto& primitive = get(key, tessellate);
+
+			glPushMatrix();
+			glScalef(scale.X, scale.Y, scale.Z);
+			draw(primitive);
+			glPopMatrix();
+		}
+	}
+
+	inline void drawWireSphere(double radius, int slices, int stacks)
+	{
+		const auto r = static_cast<float>(radius);
+		Detail::drawScaled({ Shape::wireSphere, slices, stacks, 0.0, 0.0 }, { r, r, r }, [=] { return getSphere(slices, stacks, true); });
+	}
+
+	// drawWireSphere at the coarsest halving of slices and stacks, as LevelOfDetail::Levels makes
+	// them, whose silhouette stays within LevelOfDetail::maxError pixels of the sphere
+	inline void drawWireSphereOnScreen(double radius, int slices, int stacks, int minSlices = 4)
+	{
+		const auto maxStep = LevelOfDetail::getMaxStep(LevelOfDetail::getProjectedRadius(static_cast<float>(radius)));
+
+		auto u = slices;
+		auto v = stacks;
+
+		while(u > minSlices)
+		{
+			const auto nextU = std::max(minSlices, u / 2);
+			const auto nextV = std::max(1, (stacks * nextU + slices - 1) / slices);
+
+			if(std::max(2.f * static_cast<float>(M_PI) / nextU, static_cast<float>(M_PI) / nextV) > maxStep)
+				break;
+
+			u = nextU;
+			v = nextV;
+		}
+
+		drawWireSphere(radius, u, v);
+	}
+
+	inline void drawSolidSphere(double radius, int slices, int stacks)
+	{
+		const auto r = static_cast<float>(radius);
+		Detail::drawScaled({ Shape::solidSphere, slices, stacks, 0.0, 0.0 }, { r, r, r }, [=] { return getSphere(slices, stacks, false); });
+	}
+
+	inline void drawWireCube(double size)
+	{
+		const auto s = static_cast<float>(size);
+		Detail::drawScaled({ Shape::wireCube, 0, 0, 0.0, 0.0 }, { s, s, s }, [] { return getCube(true); });
+	}
+
+	inline void drawSolidCube(double size)
+	{
+		const auto s = static_cast<float>(size);
+		Detail::drawScaled({ Shape::solidCube, 0, 0, 0.0, 0.0 }, { s, s, s }, [] { return getCube(false); });
+	}
+
+	inline void drawWireCone(double base, double height, int slices, int stacks)
+	{
+		const auto b = static_cast<float>(base);
+		Detail::drawScaled({ Shape::wireCone, slices, stacks, 0.0, 0.0 }, { b, b, static_cast<float>(height) }, [=] { return getWireCone(slices, stacks); });
+	}
+
+	inline void drawSolidCylinder(double radius, double height, int slices, int stacks)
+	{
+		const auto r = static_cast<float>(radius);
+		Detail::drawScaled({ Shape::solidCylinder, slices, stacks, 0.0, 0.0 }, { r, r, static_cast<float>(height) }, [=] { return getSolidCylinder(slices, stacks); });
+	}
+
+	inline void drawWireTorus(double innerRadius, double outerRadius, int sides, int rings)
+	{
+		Detail::draw(Detail::get({ Shape::wireTorus, sides, rings, innerRadius, outerRadius }, [=] {
+			return getWireTorus(innerRadius, outerRadius, sides, rings);
+		}));
+	}
+}
@@ -0,0 +1,188 @@
+#pragma once
+///////////////////////////////////////////////////////////////////////////////////////
+// Rosettes, the complete graphs of the vertices of a regular polygon.
+//
+// A rosette of N vertices has N(N - 1)/2 chords. A Batch keeps the N vertices
+// in a vertex buffer and the two indices of every chord in an element buffer,
+// which is written through a mapping and only when N changes, and draws all
+// the chords with one glDrawElements(GL_LINES). Indices are unsigned shorts up
+// to 65536 vertices. The buffers belong to the context of the first set(), in
+// another context set() makes them again.
+///////////////////////////////////////////////////////////////////////////////////////
+
+#define _USE_MATH_DEFINES
+
+#include <cmath>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <GL/glew.h>
+#include "GLContext.h"
+
+namespace Rosette
+{
+	inline std::size_t getChordsN(int N)
+	{
+		return N < 2 ? 0 : static_cast<std::size_t>(N) * (N - 1) / 2;
+	}
+
+	// The vertices as x, y pairs, the first is one step past angle 0
+	inline std::vector<float> getVertices(int N, float R, float cx, float cy)
+	{
+		std::vector<float> r;
+		r.reserve(2 * static_cast<std::size_t>(N));
+
+		const auto angle = 2 * M_PI / N;
+
+		for(int i = 0; i < N; ++i)
+		{
+			const auto angleInc = angle + angle * i;
+			r.push_back(static_cast<float>(R * std::cos(angleInc) + cx));
+			r.push_back(static_cast<float>(R * std::sin(angleInc) + cy));
+		}
+
+		return r;
+	}
+
+	// Writes the chords from every vertex to the ones after it, out must have room for 2 getChordsN(N) indices
+	template<typename Index>
+	void writeChords(Index* out, int N)
+	{
+		for(int i = 0; i < N - 1; ++i)
+		{
+			for(int j = i + 1; j < N; ++j)
+			{
+				*out++ = static_cast<Index>(i);
+				*out++ = static_cast<Index>(j);
+			}
+		}
+	}
+
+	class Batch
+	{
+	public:
+
+		Batch() = default;
+		Batch(const Batch&) = delete;
+		Batch& operator=(const Batch&) = delete;
+
+		~Batch()
+		{
+			if(GLContext::isCurrent(context))
+				glDeleteBuffers(2, buffers);
+		}
+
+		// The buffers are written again only when the rosette changes, the element buffer only when N does
+		void set(int N, float pR, float pCx, float pCy)
+		{
+			if(N < 3)
+			{
+				verticesN = 0;
+				chordsN = 0;
+				return;
+			}
+
+			// The names of another context went with it and are only forgotten
+			if(!GLContext::isCurrent(context))
+			{
+				context = GLContext::getGeneration();
+				glGenBuffers(2, buffers);
+				verticesN = 0;
+				chordsN = 0;
+			}
+
+			if(N == verticesN && pR == R && pCx == cx && pCy == cy)
+				return;
+
+			const auto vertices = getVertices(N, pR, pCx, pCy);
+			glBindBuffer(GL_ARRAY_BUFFER, buffers[VERTICES]);
+			glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(float), vertices.data(), GL_STATIC_DRAW);
+			glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+			R = pR;
+			cx = pCx;
+			cy = pCy;
+
+			if(N != verticesN)
+				writeIndices(N);
+		}
+
+		std::size_t getChordsN() const noexcept
+		{
+			return chordsN;
+		}
+
+		// Draws the chords in the current color
+		void draw() const
+		{
+			if(!GLContext::isCurrent(context) || !chordsN)
+				return;
+
+			glBindVertexArray(0);
+			glBindBuffer(GL_ARRAY_BUFFER, buffers[VERTICES]);
+			glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, buffers[INDICES]);
+
+			glPushClientAttrib(GL_CLIENT_VERTEX_ARRAY_BIT);
+			glEnableClientState(GL_VERTEX_ARRAY);
+			glVertexPointer(2, GL_FLOAT, 0, nullptr);
+
+			glDrawElements(GL_LINES, static_cast<GLsizei>(2 * chordsN), indexType, nullptr);
+
+			glPopClientAttrib();
+			glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+			glBindBuffer(GL_ARRAY_BUFFER, 0);
+		}
+
+	private:
+
+		enum Buffers
+		{
+			VERTICES,
+			INDICES
+		};
+
+		void writeIndices(int N)
+		{
+			const auto isShort = N <= 65536;
+			const auto indicesN = 2 * Rosette::getChordsN(N);
+			const auto size = indicesN * (isShort ? sizeof(GLushort) : sizeof(GLuint));
+
+			glBindVertexArray(0);
+			glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, buffers[INDICES]);
+			glBufferData(GL_ELEMENT_ARRAY_BUFFER, size, nullptr, GL_STATIC_DRAW);
+
+			auto* mapped = glMapBufferRange(GL_ELEMENT_ARRAY_BUFFER, 0, size, GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT);
+			if(!mapped)
+			{
+				std::cerr << "Cannot map the indices of a rosette of " << N << " vertices" << std::endl;
+				glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+				verticesN = 0;
+				chordsN = 0;
+				return;
+			}
+
+			if(isShort)
+				writeChords(static_cast<GLushort*>(mapped), N);
+			else
+				writeChords(static_cast<GLuint*>(mapped), N);
+
+			glUnmapBuffer(GL_ELEMENT_ARRAY_BUFFER);
+			glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+
+			verticesN = N;
+			chordsN = Rosette::getChordsN(N);
+			indexType = isShort ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT;
+		}
+
+		// The generation of the context the buffers were made in, 0 before the first set()
+		unsigned context = 0;
+		GLuint buffers[2] = {};
+		int verticesN = 0;
+		float R = 0.f;
+		float cx = 0.f;
+		float cy = 0.f;
+		std::size_t chordsN = 0;
+		GLenum indexType = GL_UNSIGNED_SHORT;
+	};
+}
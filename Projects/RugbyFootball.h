@@ -1,8 +1,10 @@
+#pragma once
 ///////////////////////////////////////////////////////////////////////////////////////          
 // This program draws RugbyFootball
 //
 // Interaction:
 // Press x, X, y, Y, z, Z to turn the lampshade.
+// Press o to toggle between the strips and a vertex cache optimized triangle list.
 /////////////////////////////////////////////////////////////////////////////////////// 
 
 #define _USE_MATH_DEFINES 
@@ -11,6 +13,12 @@
 #include <iostream>
 #include <GL/glew.h>
 #include <GL/freeglut.h>
+#include "SceneRegistry.h"
+#include "SimdMath.h"
+#include "ParametricSurface.h"
+#include "LevelOfDetail.h"
+#include "VertexCache.h"
+#include "MeshCache.h"
 #include <vector>
 #include <memory>
 
@@ -23,104 +31,39 @@ namespace RugbyFootball
 	static int N = 15;
 	static int p = 12;
 	static int q = 10;
-	static std::vector<float> vertices;
-	static std::vector<unsigned int*> indices;
-	static std::vector<int> countIndices;
+	// The football at p x 2q and its coarser levels, the one drawn depends on its size on screen
+	static LevelOfDetail::Levels levels;
+	static bool isVertexCacheOptimized;
 
-	void fillVertices()
-	{
-		vertices.reserve(3 * (2 * q + 1) * (p + 1));
-
-		int j, i;
-		for (j = -q; j <= q; j++)
-		{
-			//This way pushes vertices just in so later we can define their order with indices in fillIndecies procedure for example
-			for (i = 0; i <= p; ++i)
-			{
-				auto fi = M_PI_2 * j / q;
-				const auto th = 2.0 * i / p * M_PI;
-
-				vertices.push_back(R0 * cos(fi) * cos(th));
-				vertices.push_back(R1 * sin(fi));
-				vertices.push_back(-R2 * cos(fi) * sin(th));
-			}
-
-			/* Push vertices as they go, so indices have to be just in 0,1,2,..., 4q(p + 1) order
-			for (i = 0; i <= p; i++)
-			{
-				auto fi = M_PI_2 * (j + 1) / q;
-				const auto th = 2.0 * i / p * M_PI;
-
-				vertices.push_back(R0 * cos(fi) * cos(th));
-				vertices.push_back(R1 * sin(fi));
-				vertices.push_back(-R2 * cos(fi) * sin(th));
-
-				fi = M_PI_2 * j / q;
-
-				vertices.push_back(R0 * cos(fi) * cos(th));
-				vertices.push_back(R1 * sin(fi));
-				vertices.push_back(-R2 * cos(fi) * sin(th));
-			}
-			*/
-		}
-	}
+	// Part of the mesh cache key, bumped when the formula below changes
+	constexpr int meshVersion = 1;
 
-	void fillIndices()
+	void fillLevels()
 	{
-		int j, i;
-		indices.resize(2 * q);
+		levels = LevelOfDetail::Levels(p, 2 * q, [](int slices, int stacks) {
+			const auto key = MeshCache::getKey(meshVersion, slices, stacks, R0, R1, R2, isVertexCacheOptimized);
 
-		for (j = 0; j < indices.size(); j++)
-		{
-			indices[j] = new unsigned int[2 * (p + 1)];
-			
-			for (i = 0; i <= p; i++)
-			{
-				indices[j][2 * i] = ((j + 1) * (p + 1) + i);
-				indices[j][2 * i + 1] = (j * (p + 1) + i);
-			}
-			
-			//int k = 0;
-			/*
-			for (i = 0; i <= p; ++i)
-			{
-				indices[j][2 * i] = k;
-				++k;
-				indices[j][2 * i + 1] = k;
-				++k;
-			}
-			*/
-		}
-	}
+			return MeshCache::getMesh("RugbyFootball", key, [=] {
+				auto mesh = ParametricSurface::tessellate({ slices, stacks }, [=](int i, int j) {
+					const auto fi = M_PI_2 * (2 * j - stacks) / stacks;
+					const auto th = 2.0 * i / slices * M_PI;
 
-	void freeIndices()
-	{
-		for (auto i : indices)
-		{
-			if (i != nullptr)
-			{
-				delete[] i;
-				i = nullptr;
-			}
-		}
+					return SimdMath::Vec3(R0 * cos(fi) * cos(th), R1 * sin(fi), -R2 * cos(fi) * sin(th));
+				});
+
+				return isVertexCacheOptimized ? VertexCache::optimize(std::move(mesh)) : mesh;
+			});
+		});
 	}
 
-	void fillCountIndices()
+	void printVertexCacheStats()
 	{
-		countIndices.resize(indices.size());
-
-		for (int i = 0; i < indices.size(); ++i)
-		{
-			countIndices[i] = 2 * (p + 1);
-		}
+		std::cout << (isVertexCacheOptimized ? "Optimized triangle list: " : "Strips: ") << VertexCache::getStats(levels.getMesh(0)) << std::endl;
 	}
 
 	void setup(void)
 	{
-		glEnableClientState(GL_VERTEX_ARRAY);
-		fillVertices();
-		fillIndices();
-		fillCountIndices();
+		fillLevels();
 		glClearColor(1.0, 1.0, 1.0, 0.0);
 	}
 
@@ -140,10 +83,8 @@ namespace RugbyFootball
 		glPolygonMode(GL_FRONT_AND_BACK, GL_LINE);
 		glColor3f(0.0, 0.0, 0.0);
 
-		glVertexPointer(3, GL_FLOAT, 0, vertices.data());
-
-		glMultiDrawElements(GL_TRIANGLE_STRIP, countIndices.data(), GL_UNSIGNED_INT, (const void**)indices.data(), indices.size());
-		//glDrawArrays(GL_TRIANGLE_STRIP, 0, vertices.size() / 3); easier
+		// R0 is the longest semi-axis
+		levels.draw(levels.getLevelFor(R0));
 
 		glFlush();
 	}
@@ -162,9 +103,14 @@ namespace RugbyFootball
 		switch (key)
 		{
 		case 27:
-			freeIndices();
 			exit(0);
 			break;
+		case 'o':
+			isVertexCacheOptimized = !isVertexCacheOptimized;
+			fillLevels();
+			printVertexCacheStats();
+			glutPostRedisplay();
+			break;
 		case 'x':
 			Xangle += 5.0;
 			if (Xangle > 360.0) Xangle -= 360.0;
@@ -204,6 +150,7 @@ namespace RugbyFootball
 	{
 		std::cout << "Interaction:\n";
 		std::cout << "Press x, X, y, Y, z, Z to turn the lampshade" << std::endl;
+		std::cout << "Press o to toggle between the strips and a vertex cache optimized triangle list" << std::endl;
 	}
 
 	int main(int argc, char** argv)
@@ -231,5 +178,7 @@ namespace RugbyFootball
 
 		return 0;
 	}
+
+	static SceneRegistry::Registrar registrar{ { "RugbyFootball", main, setup, drawScene, resize, keyInput } };
 }
 
@@ -0,0 +1,56 @@
+#pragma once
+///////////////////////////////////////////////////////////////////////////////////////
+// Registry of every scene in the sandbox.
+//
+// Each scene namespace registers its entry points at the end of its header:
+//
+//     static SceneRegistry::Registrar registrar{ { "Name", main, setup, drawScene, resize, keyInput } };
+//
+// so the launcher (and any other driver) can pick a scene by name at runtime
+// instead of recompiling with another hard-coded main.
+///////////////////////////////////////////////////////////////////////////////////////
+
+#include <map>
+#include <string>
+#include <iostream>
+
+namespace SceneRegistry
+{
+	struct Scene
+	{
+		std::string name;
+		int (*main)(int argc, char** argv);
+		void (*setup)();
+		void (*drawScene)();
+		void (*resize)(int w, int h);
+		void (*keyInput)(unsigned char key, int x, int y);
+	};
+
+	inline std::map<std::string, Scene>& getScenes()
+	{
+		static std::map<std::string, Scene> scenes;
+		return scenes;
+	}
+
+	inline const Scene* findScene(const std::string& name)
+	{
+		const auto& scenes = getScenes();
+		const auto it = scenes.find(name);
+
+		return it == scenes.end() ? nullptr : &it->second;
+	}
+
+	inline void printScenes(std::ostream& os)
+	{
+		for(const auto& scene : getScenes())
+			os << "  " << scene.first << '\n';
+	}
+
+	struct Registrar
+	{
+		explicit Registrar(const Scene& scene)
+		{
+			getScenes().emplace(scene.name, scene);
+		}
+	};
+}
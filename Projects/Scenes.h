@@ -0,0 +1,60 @@
+#pragma once
+///////////////////////////////////////////////////////////////////////////////////////
+// Pulls every scene into one translation unit so that all of them register
+// themselves in SceneRegistry. Include it from exactly one .cpp file.
+///////////////////////////////////////////////////////////////////////////////////////
+
+#include "AnimatedGarden.h"
+#include "BallBouncingUp.h"
+#include "BallRollChildrenSlide.h"
+#include "BallRollOnPoolTable.h"
+#include "BallRollingDown.h"
+#include "BallRollingHelix.h"
+#include "BouncingBall.h"
+#include "BullSEye.h"
+#include "Canvas.h"
+#include "Car3D.h"
+#include "ChildrenSlide.h"
+#include "Circle.h"
+#include "Clown.h"
+#include "ColoredDisc.h"
+#include "ConcentricCirclesRing.h"
+#include "Cone.h"
+#include "CrossSectionRing.h"
+#include "DrawSincFunc.h"
+#include "FallingBallAndWater.h"
+#include "FibonacciGoldenSin.h"
+#include "FibonacciGoldenSinWithMarker.h"
+#include "FlyingCameraOnSphere.h"
+#include "GlutMenuTest.h"
+#include "GoldenRectanglesRegression.h"
+#include "HalfStarCircle.h"
+#include "Lampshade1.h"
+#include "Lampshade2.h"
+#include "LookAtBalls.h"
+#include "MakeCircleWithTwoClicks.h"
+#include "MoonDrawings.h"
+#include "MultipleLists.h"
+#include "MultipleWindows.h"
+#include "OpenglEasyStart.h"
+#include "RugbyFootball.h"
+#include "SentenceOfFonts.h"
+#include "SierpinskiGasket.h"
+#include "SolarySystem.h"
+#include "Sphere.h"
+#include "SpinningCube.h"
+#include "SpiralBand.h"
+#include "SquareToLine.h"
+#include "TestAffineCombinations.h"
+#include "TestCohenSazerland.h"
+#include "ThreeLeggedStool.h"
+#include "TorusSatellites.h"
+#include "TriangulateMask.h"
+#include "TriangulatePolygon.h"
+#include "TurtleCanvas.h"
+#include "TurtleCanvasNgons.h"
+#include "TwinTry.h"
+#include "VAOCircle.h"
+#include "VAOSphere.h"
+#include "VBOBullSEye.h"
+#include "ViewportsTest.h"
@@ -0,0 +1,293 @@
+#pragma once
+///////////////////////////////////////////////////////////////////////////////////////
+// Clipping of many line segments against a rectangle at once.
+//
+// Segments come as a structure of arrays, so four of them fill the lanes of an
+// SSE register. The Cohen-Sutherland kernel finds the outcodes of four segments
+// with a few compares and only chops the ones that are neither trivially
+// accepted nor trivially rejected, one by one as TestCohenSazerland always did.
+// The Liang-Barsky kernel has no branches and clips all four lanes together.
+// Without SSE (or with SIMDMATH_SCALAR) both kernels run one segment at a time.
+///////////////////////////////////////////////////////////////////////////////////////
+
+#include <cstddef>
+#include <cstdint>
+#include <algorithm>
+#include "SimdMath.h"
+
+namespace SegmentClip
+{
+	struct Rect
+	{
+		float l;
+		float r;
+		float b;
+		float t;
+	};
+
+	// The i-th segment goes from (x0[i], y0[i]) to (x1[i], y1[i])
+	struct Segments
+	{
+		float* x0;
+		float* y0;
+		float* x1;
+		float* y1;
+	};
+
+	enum class Kernel
+	{
+		cohenSutherland,
+		liangBarsky
+	};
+
+	// Clips one segment in place, false when no part of it is inside
+	inline bool clipCohenSutherland(float& x0, float& y0, float& x1, float& y1, const Rect& rect)
+	{
+		enum LOCATIONS{LEFT = 8, TOP = 4, RIGHT = 2, BOTTOM = 1};
+
+		const auto getCode = [&rect](float x, float y) {
+			unsigned char code{};
+
+			if(x < rect.l) code |= LEFT;
+			if(y > rect.t) code |= TOP;
+			if(x > rect.r) code |= RIGHT;
+			if(y < rect.b) code |= BOTTOM;
+
+			return code;
+		};
+
+		const auto chop = [&rect](float& x, float& y, unsigned char code, float delx, float dely) {
+			if(code & LEFT)
+			{
+				y += (rect.l - x) * dely / delx;
+				x = rect.l;
+			}
+			else if(code & RIGHT)
+			{
+				y += (rect.r - x) * dely / delx;
+				x = rect.r;
+			}
+			else if(code & BOTTOM)
+			{
+				x += (rect.b - y) * delx / dely;
+				y = rect.b;
+			}
+			else if(code & TOP)
+			{
+				x += (rect.t - y) * delx / dely;
+				y = rect.t;
+			}
+		};
+
+		for(int i = 0; i < 4; ++i)
+		{
+			const auto code0 = getCode(x0, y0);
+			const auto code1 = getCode(x1, y1);
+
+			if(!(code0 | code1)) return true;
+			if(code0 & code1) return false;
+
+			const auto delx = x1 - x0;
+			const auto dely = y1 - y0;
+
+			chop(x0, y0, code0, delx, dely);
+			chop(x1, y1, code1, delx, dely);
+		}
+
+		const auto isInBounds = [&rect](float x, float y) {
+			return x >= rect.l && x <= rect.r && y >= rect.b && y <= rect.t;
+		};
+
+		return isInBounds(x0, y0) && isInBounds(x1, y1);
+	}
+
+	// Clips one segment in place, the entering and leaving parameters are found without branches on the edges
+	inline bool clipLiangBarsky(float& x0, float& y0, float& x1, float& y1, const Rect& rect)
+	{
+		const auto dx = x1 - x0;
+		const auto dy = y1 - y0;
+
+		// The segment leaves the half plane of edge i where p[i] t > q[i]
+		const float p[4]{ -dx, dx, -dy, dy };
+		const float q[4]{ x0 - rect.l, rect.r - x0, y0 - rect.b, rect.t - y0 };
+
+		auto tIn = 0.f;
+		auto tOut = 1.f;
+		auto isParallelOutside = false;
+
+		for(int i = 0; i < 4; ++i)
+		{
+			const auto ratio = q[i] / p[i];
+
+			if(p[i] < 0.f)
+				tIn = std::max(tIn, ratio);
+			else if(p[i] > 0.f)
+				tOut = std::min(tOut, ratio);
+			else if(q[i] < 0.f)
+				isParallelOutside = true;
+		}
+
+		if(isParallelOutside || tIn > tOut)
+			return false;
+
+		x1 = x0 + tOut * dx;
+		y1 = y0 + tOut * dy;
+		x0 = x0 + tIn * dx;
+		y0 = y0 + tIn * dy;
+
+		return true;
+	}
+
+	// Clips segments [first, last) of in one at a time into out
+	inline std::size_t clipScalar(const Segments& in, const Segments& out, std::size_t first, std::size_t last, const Rect& rect, Kernel kernel, std::uint8_t* accepted)
+	{
+		std::size_t r{};
+
+		for(auto i = first; i < last; ++i)
+		{
+			out.x0[i] = in.x0[i];
+			out.y0[i] = in.y0[i];
+			out.x1[i] = in.x1[i];
+			out.y1[i] = in.y1[i];
+
+			const auto isAccepted = kernel == Kernel::cohenSutherland
+				? clipCohenSutherland(out.x0[i], out.y0[i], out.x1[i], out.y1[i], rect)
+				: clipLiangBarsky(out.x0[i], out.y0[i], out.x1[i], out.y1[i], rect);
+
+			accepted[i] = isAccepted;
+			r += isAccepted;
+		}
+
+		return r;
+	}
+
+	namespace Detail
+	{
+#if SIMDMATH_SSE
+		inline __m128 select(__m128 mask, __m128 a, __m128 b)
+		{
+			return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b));
+		}
+
+		inline std::size_t storeAccepted(int mask, std::uint8_t* accepted)
+		{
+			for(int lane{}; lane < 4; ++lane)
+				accepted[lane] = (mask >> lane) & 1;
+
+			return ((mask & 1) + ((mask >> 1) & 1)) + (((mask >> 2) & 1) + ((mask >> 3) & 1));
+		}
+
+		// Four segments from i on, the ones the outcodes do not decide are chopped one by one
+		inline std::size_t clipCohenSutherland4(const Segments& in, const Segments& out, std::size_t i, const Rect& rect, std::uint8_t* accepted)
+		{
+			const auto x0 = _mm_loadu_ps(in.x0 + i);
+			const auto y0 = _mm_loadu_ps(in.y0 + i);
+			const auto x1 = _mm_loadu_ps(in.x1 + i);
+			const auto y1 = _mm_loadu_ps(in.y1 + i);
+
+			_mm_storeu_ps(out.x0 + i, x0);
+			_mm_storeu_ps(out.y0 + i, y0);
+			_mm_storeu_ps(out.x1 + i, x1);
+			_mm_storeu_ps(out.y1 + i, y1);
+
+			const auto l = _mm_set1_ps(rect.l);
+			const auto r = _mm_set1_ps(rect.r);
+			const auto b = _mm_set1_ps(rect.b);
+			const auto t = _mm_set1_ps(rect.t);
+
+			const auto left0 = _mm_cmplt_ps(x0, l);
+			const auto left1 = _mm_cmplt_ps(x1, l);
+			const auto right0 = _mm_cmpgt_ps(x0, r);
+			const auto right1 = _mm_cmpgt_ps(x1, r);
+			const auto bottom0 = _mm_cmplt_ps(y0, b);
+			const auto bottom1 = _mm_cmplt_ps(y1, b);
+			const auto top0 = _mm_cmpgt_ps(y0, t);
+			const auto top1 = _mm_cmpgt_ps(y1, t);
+
+			const auto outside = _mm_or_ps(_mm_or_ps(_mm_or_ps(left0, left1), _mm_or_ps(right0, right1)),
+				_mm_or_ps(_mm_or_ps(bottom0, bottom1), _mm_or_ps(top0, top1)));
+			const auto sameSide = _mm_or_ps(_mm_or_ps(_mm_and_ps(left0, left1), _mm_and_ps(right0, right1)),
+				_mm_or_ps(_mm_and_ps(bottom0, bottom1), _mm_and_ps(top0, top1)));
+
+			const auto isInside = ~_mm_movemask_ps(outside) & 0xF;
+			const auto isRejected = _mm_movemask_ps(sameSide);
+			auto mask = isInside;
+
+			for(int lane{}; lane < 4; ++lane)
+			{
+				const auto bit = 1 << lane;
+				if((isInside | isRejected) & bit)
+					continue;
+
+				const auto j = i + lane;
+				if(clipCohenSutherland(out.x0[j], out.y0[j], out.x1[j], out.y1[j], rect))
+					mask |= bit;
+			}
+
+			return storeAccepted(mask, accepted + i);
+		}
+
+		// The same steps as clipLiangBarsky in every lane
+		inline std::size_t clipLiangBarsky4(const Segments& in, const Segments& out, std::size_t i, const Rect& rect, std::uint8_t* accepted)
+		{
+			const auto x0 = _mm_loadu_ps(in.x0 + i);
+			const auto y0 = _mm_loadu_ps(in.y0 + i);
+			const auto dx = _mm_sub_ps(_mm_loadu_ps(in.x1 + i), x0);
+			const auto dy = _mm_sub_ps(_mm_loadu_ps(in.y1 + i), y0);
+
+			const auto zero = _mm_setzero_ps();
+			const __m128 p[4]{ _mm_sub_ps(zero, dx), dx, _mm_sub_ps(zero, dy), dy };
+			const __m128 q[4]{
+				_mm_sub_ps(x0, _mm_set1_ps(rect.l)), _mm_sub_ps(_mm_set1_ps(rect.r), x0),
+				_mm_sub_ps(y0, _mm_set1_ps(rect.b)), _mm_sub_ps(_mm_set1_ps(rect.t), y0)
+			};
+
+			auto tIn = zero;
+			auto tOut = _mm_set1_ps(1.f);
+			auto isParallelOutside = zero;
+
+			for(int edge{}; edge < 4; ++edge)
+			{
+				const auto ratio = _mm_div_ps(q[edge], p[edge]);
+				const auto isEntering = _mm_cmplt_ps(p[edge], zero);
+				const auto isLeaving = _mm_cmpgt_ps(p[edge], zero);
+
+				tIn = select(isEntering, _mm_max_ps(tIn, ratio), tIn);
+				tOut = select(isLeaving, _mm_min_ps(tOut, ratio), tOut);
+
+				const auto isParallel = _mm_andnot_ps(_mm_or_ps(isEntering, isLeaving), _mm_cmplt_ps(q[edge], zero));
+				isParallelOutside = _mm_or_ps(isParallelOutside, isParallel);
+			}
+
+			const auto isAccepted = _mm_andnot_ps(_mm_or_ps(isParallelOutside, _mm_cmpgt_ps(tIn, tOut)), _mm_cmpeq_ps(zero, zero));
+
+			// Rejected segments are left as they came in
+			_mm_storeu_ps(out.x1 + i, _mm_add_ps(x0, _mm_mul_ps(select(isAccepted, tOut, _mm_set1_ps(1.f)), dx)));
+			_mm_storeu_ps(out.y1 + i, _mm_add_ps(y0, _mm_mul_ps(select(isAccepted, tOut, _mm_set1_ps(1.f)), dy)));
+			_mm_storeu_ps(out.x0 + i, _mm_add_ps(x0, _mm_mul_ps(select(isAccepted, tIn, zero), dx)));
+			_mm_storeu_ps(out.y0 + i, _mm_add_ps(y0, _mm_mul_ps(select(isAccepted, tIn, zero), dy)));
+
+			return storeAccepted(_mm_movemask_ps(isAccepted), accepted + i);
+		}
+#endif
+	}
+
+	// Clips the first n segments of in into out, which may be in itself, and sets accepted[i] to 1 for the
+	// segments with a part inside rect. Returns how many those are. The ends of rejected segments are unspecified.
+	inline std::size_t clip(const Segments& in, const Segments& out, std::size_t n, const Rect& rect, Kernel kernel, std::uint8_t* accepted)
+	{
+		std::size_t r{};
+		std::size_t i{};
+
+#if SIMDMATH_SSE
+		for(; i + 4 <= n; i += 4)
+		{
+			r += kernel == Kernel::cohenSutherland
+				? Detail::clipCohenSutherland4(in, out, i, rect, accepted)
+				: Detail::clipLiangBarsky4(in, out, i, rect, accepted);
+		}
+#endif
+
+		return r + clipScalar(in, out, i, n, rect, kernel, accepted);
+	}
+}
@@ -1,3 +1,4 @@
+#pragma once
 //////////////////////////////////////////////////////////////////////////    
 // This program displays all fonts available through the GLUT library.
 //////////////////////////////////////////////////////////////////////////
@@ -7,6 +8,7 @@
 #include <iostream>
 #include <GL/glew.h>
 #include <GL/freeglut.h> 
+#include "SceneRegistry.h"
 #include <vector>
 
 namespace SentenceOfFonts
@@ -255,4 +257,6 @@ namespace SentenceOfFonts
 
 		return 0;
 	}
+
+	static SceneRegistry::Registrar registrar{ { "SentenceOfFonts", main, setup, drawScene, resize, keyInput } };
 }
@@ -0,0 +1,78 @@
+#pragma once
+///////////////////////////////////////////////////////////////////////////////////////
+// Compiling and linking the small GLSL programs used next to the fixed-function
+// pipeline. Errors are printed to std::cerr and give a program of 0.
+///////////////////////////////////////////////////////////////////////////////////////
+
+#include <string>
+#include <algorithm>
+#include <iostream>
+#include <GL/glew.h>
+
+namespace Shader
+{
+	inline GLuint compile(GLenum type, const char* source)
+	{
+		const auto shader = glCreateShader(type);
+		glShaderSource(shader, 1, &source, nullptr);
+		glCompileShader(shader);
+
+		GLint compiled{};
+		glGetShaderiv(shader, GL_COMPILE_STATUS, &compiled);
+
+		if(!compiled)
+		{
+			GLint logLength{};
+			glGetShaderiv(shader, GL_INFO_LOG_LENGTH, &logLength);
+
+			std::string log(std::max(logLength, 1), '\0');
+			glGetShaderInfoLog(shader, logLength, nullptr, &log[0]);
+			std::cerr << "Cannot compile shader: " << log << '\n';
+
+			glDeleteShader(shader);
+			return 0;
+		}
+
+		return shader;
+	}
+
+	inline GLuint createProgram(const char* vertexSource, const char* fragmentSource)
+	{
+		const auto vertexShader = compile(GL_VERTEX_SHADER, vertexSource);
+		const auto fragmentShader = compile(GL_FRAGMENT_SHADER, fragmentSource);
+
+		if(!vertexShader || !fragmentShader)
+		{
+			glDeleteShader(vertexShader);
+			glDeleteShader(fragmentShader);
+			return 0;
+		}
+
+		const auto program = glCreateProgram();
+		glAttachShader(program, vertexShader);
+		glAttachShader(program, fragmentShader);
+		glLinkProgram(program);
+
+		// The program keeps the shaders alive as long as it needs them
+		glDeleteShader(vertexShader);
+		glDeleteShader(fragmentShader);
+
+		GLint linked{};
+		glGetProgramiv(program, GL_LINK_STATUS, &linked);
+
+		if(!linked)
+		{
+			GLint logLength{};
+			glGetProgramiv(program, GL_INFO_LOG_LENGTH, &logLength);
+
+			std::string log(std::max(logLength, 1), '\0');
+			glGetProgramInfoLog(program, logLength, nullptr, &log[0]);
+			std::cerr << "Cannot link program: " << log << '\n';
+
+			glDeleteProgram(program);
+			return 0;
+		}
+
+		return program;
+	}
+}
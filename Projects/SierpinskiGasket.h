@@ -1,3 +1,4 @@
+#pragma once
 ///////////////////////////////////////////////////////////////////////////////////////          
 //Simple start up program
 /////////////////////////////////////////////////////////////////////////////////////// 
@@ -9,6 +10,7 @@
 #include <iostream>
 #include <GL/glew.h>
 #include <GL/freeglut.h>
+#include "SceneRegistry.h"
 
 namespace SierpinskiGasket
 {
@@ -114,4 +116,5 @@ namespace SierpinskiGasket
 		return 0;
 	}
 
+	static SceneRegistry::Registrar registrar{ { "SierpinskiGasket", main, setup, drawScene, resize, keyInput } };
 }
@@ -0,0 +1,589 @@
+#pragma once
+///////////////////////////////////////////////////////////////////////////////////////
+// Vec3/Vec4/Mat4/Quat shared by the scenes, with SSE and AVX kernels for
+// normalizing spans of vectors and a scalar fallback.
+//
+// Vec3 keeps the X, Y, Z members the scenes always used and stays three packed
+// floats, so std::vector<Vec3> can still be handed to glVertexPointer. Mat4 is
+// column-major like OpenGL, data() goes straight to glLoadMatrixf/glMultMatrixf.
+//
+// SSE is used on every x86-64 build, AVX when the compiler targets it (-mavx,
+// -march=native). Define SIMDMATH_SCALAR to force the scalar code.
+///////////////////////////////////////////////////////////////////////////////////////
+
+#define _USE_MATH_DEFINES
+
+#include <cmath>
+#include <vector>
+#include <cstddef>
+#include <ostream>
+
+#if !defined(SIMDMATH_SCALAR) && (defined(__SSE2__) || defined(_M_X64))
+#define SIMDMATH_SSE 1
+#include <immintrin.h>
+#if defined(__AVX__)
+#define SIMDMATH_AVX 1
+#endif
+#endif
+
+namespace SimdMath
+{
+	struct Vec3
+	{
+		Vec3(float pX = 0.f, float pY = 0.f, float pZ = 0.f)
+			:
+			X{ pX },
+			Y{ pY },
+			Z{ pZ }
+		{
+
+		}
+
+		float lengthSquared() const noexcept
+		{
+			return X * X + Y * Y + Z * Z;
+		}
+
+		float length() const noexcept
+		{
+			return std::sqrt(lengthSquared());
+		}
+
+		Vec3& operator+=(const Vec3& rhs) noexcept
+		{
+			return *this = *this + rhs;
+		}
+
+		Vec3& operator-=(const Vec3& rhs) noexcept
+		{
+			return *this = *this - rhs;
+		}
+
+		Vec3& operator*=(float v) noexcept
+		{
+			return *this = *this * v;
+		}
+
+		Vec3 operator+(const Vec3& rhs) const noexcept
+		{
+			return { X + rhs.X, Y + rhs.Y, Z + rhs.Z };
+		}
+
+		Vec3 operator-(const Vec3& rhs) const noexcept
+		{
+			return { X - rhs.X, Y - rhs.Y, Z - rhs.Z };
+		}
+
+		Vec3 operator-() const noexcept
+		{
+			return { -X, -Y, -Z };
+		}
+
+		Vec3 operator*(float v) const noexcept
+		{
+			return { X * v, Y * v, Z * v };
+		}
+
+		Vec3 operator/(float v) const noexcept
+		{
+			return *this * (1.f / v);
+		}
+
+		bool operator==(const Vec3& rhs) const noexcept
+		{
+			return (X == rhs.X) && (Y == rhs.Y) && (Z == rhs.Z);
+		}
+
+		bool operator!=(const Vec3& rhs) const noexcept
+		{
+			return !(*this == rhs);
+		}
+
+		float X;
+		float Y;
+		float Z;
+	};
+
+	static_assert(sizeof(Vec3) == 3 * sizeof(float), "Vec3 arrays are used as GL vertex arrays");
+
+	struct Vec4
+	{
+		Vec4(float pX = 0.f, float pY = 0.f, float pZ = 0.f, float pW = 0.f)
+			:
+			X{ pX },
+			Y{ pY },
+			Z{ pZ },
+			W{ pW }
+		{
+
+		}
+
+		Vec4(const Vec3& v, float pW)
+			:
+			Vec4{ v.X, v.Y, v.Z, pW }
+		{
+
+		}
+
+		Vec3 xyz() const noexcept
+		{
+			return { X, Y, Z };
+		}
+
+		Vec4 operator+(const Vec4& rhs) const noexcept
+		{
+			return { X + rhs.X, Y + rhs.Y, Z + rhs.Z, W + rhs.W };
+		}
+
+		Vec4 operator-(const Vec4& rhs) const noexcept
+		{
+			return { X - rhs.X, Y - rhs.Y, Z - rhs.Z, W - rhs.W };
+		}
+
+		Vec4 operator*(float v) const noexcept
+		{
+			return { X * v, Y * v, Z * v, W * v };
+		}
+
+		bool operator==(const Vec4& rhs) const noexcept
+		{
+			return (X == rhs.X) && (Y == rhs.Y) && (Z == rhs.Z) && (W == rhs.W);
+		}
+
+		bool operator!=(const Vec4& rhs) const noexcept
+		{
+			return !(*this == rhs);
+		}
+
+		float X;
+		float Y;
+		float Z;
+		float W;
+	};
+
+	inline Vec3 operator*(float lhs, const Vec3& rhs) noexcept
+	{
+		return rhs * lhs;
+	}
+
+	inline std::ostream& operator<<(std::ostream& os, const Vec3& v)
+	{
+		os << "X: " << v.X << " Y: " << v.Y << " Z: " << v.Z;
+		return os;
+	}
+
+	inline float dot(const Vec3& lhs, const Vec3& rhs) noexcept
+	{
+		return lhs.X * rhs.X + lhs.Y * rhs.Y + lhs.Z * rhs.Z;
+	}
+
+	inline Vec3 cross(const Vec3& lhs, const Vec3& rhs) noexcept
+	{
+		return {
+			lhs.Y * rhs.Z - lhs.Z * rhs.Y,
+			lhs.Z * rhs.X - lhs.X * rhs.Z,
+			lhs.X * rhs.Y - lhs.Y * rhs.X
+		};
+	}
+
+	// One reciprocal square root instead of dividing every component by length()
+	inline Vec3 normalize(const Vec3& v) noexcept
+	{
+		return v * (1.f / std::sqrt(v.lengthSquared()));
+	}
+
+	inline Vec3 lerp(const Vec3& from, const Vec3& to, float t) noexcept
+	{
+		return from + (to - from) * t;
+	}
+
+	// Column-major, m[column * 4 + row], the layout glLoadMatrixf expects
+	struct alignas(16) Mat4
+	{
+		float m[16];
+
+		static Mat4 identity() noexcept
+		{
+			return { {
+				1.f, 0.f, 0.f, 0.f,
+				0.f, 1.f, 0.f, 0.f,
+				0.f, 0.f, 1.f, 0.f,
+				0.f, 0.f, 0.f, 1.f
+			} };
+		}
+
+		static Mat4 translation(const Vec3& v) noexcept
+		{
+			auto r = identity();
+			r.m[12] = v.X;
+			r.m[13] = v.Y;
+			r.m[14] = v.Z;
+			return r;
+		}
+
+		static Mat4 scaling(const Vec3& v) noexcept
+		{
+			auto r = identity();
+			r.m[0] = v.X;
+			r.m[5] = v.Y;
+			r.m[10] = v.Z;
+			return r;
+		}
+
+		// The same matrix glRotatef(angle, x, y, z) multiplies by
+		static Mat4 rotation(float angleDegrees, const Vec3& axis) noexcept
+		{
+			// glRotate ignores a zero axis too
+			if(axis.lengthSquared() == 0.f)
+				return identity();
+
+			const auto a = normalize(axis);
+			const auto rad = angleDegrees * static_cast<float>(M_PI) / 180.f;
+			const auto c = std::cos(rad);
+			const auto s = std::sin(rad);
+			const auto t = 1.f - c;
+
+			return { {
+				t * a.X * a.X + c,       t * a.X * a.Y + s * a.Z, t * a.X * a.Z - s * a.Y, 0.f,
+				t * a.X * a.Y - s * a.Z, t * a.Y * a.Y + c,       t * a.Y * a.Z + s * a.X, 0.f,
+				t * a.X * a.Z + s * a.Y, t * a.Y * a.Z - s * a.X, t * a.Z * a.Z + c,       0.f,
+				0.f,                     0.f,                     0.f,                     1.f
+			} };
+		}
+
+		const float* data() const noexcept
+		{
+			return m;
+		}
+
+		Vec4 operator*(const Vec4& v) const noexcept
+		{
+#if SIMDMATH_SSE
+			const auto r = _mm_add_ps(
+				_mm_add_ps(_mm_mul_ps(_mm_load_ps(m), _mm_set1_ps(v.X)), _mm_mul_ps(_mm_load_ps(m + 4), _mm_set1_ps(v.Y))),
+				_mm_add_ps(_mm_mul_ps(_mm_load_ps(m + 8), _mm_set1_ps(v.Z)), _mm_mul_ps(_mm_load_ps(m + 12), _mm_set1_ps(v.W))));
+
+			alignas(16) float out[4];
+			_mm_store_ps(out, r);
+			return { out[0], out[1], out[2], out[3] };
+#else
+			return {
+				m[0] * v.X + m[4] * v.Y + m[8] * v.Z + m[12] * v.W,
+				m[1] * v.X + m[5] * v.Y + m[9] * v.Z + m[13] * v.W,
+				m[2] * v.X + m[6] * v.Y + m[10] * v.Z + m[14] * v.W,
+				m[3] * v.X + m[7] * v.Y + m[11] * v.Z + m[15] * v.W
+			};
+#endif
+		}
+
+		Mat4 operator*(const Mat4& rhs) const noexcept
+		{
+			Mat4 r;
+
+#if SIMDMATH_SSE
+			const auto c0 = _mm_load_ps(m);
+			const auto c1 = _mm_load_ps(m + 4);
+			const auto c2 = _mm_load_ps(m + 8);
+			const auto c3 = _mm_load_ps(m + 12);
+
+			for(int i{}; i < 4; ++i)
+			{
+				const auto b = rhs.m + i * 4;
+				_mm_store_ps(r.m + i * 4, _mm_add_ps(
+					_mm_add_ps(_mm_mul_ps(c0, _mm_set1_ps(b[0])), _mm_mul_ps(c1, _mm_set1_ps(b[1]))),
+					_mm_add_ps(_mm_mul_ps(c2, _mm_set1_ps(b[2])), _mm_mul_ps(c3, _mm_set1_ps(b[3])))));
+			}
+#else
+			for(int column{}; column < 4; ++column)
+			{
+				for(int row{}; row < 4; ++row)
+				{
+					r.m[column * 4 + row] = m[row] * rhs.m[column * 4] + m[4 + row] * rhs.m[column * 4 + 1]
+						+ m[8 + row] * rhs.m[column * 4 + 2] + m[12 + row] * rhs.m[column * 4 + 3];
+				}
+			}
+#endif
+
+			return r;
+		}
+
+		Vec3 transformPoint(const Vec3& v) const noexcept
+		{
+			return (*this * Vec4{ v, 1.f }).xyz();
+		}
+
+		Vec3 transformVector(const Vec3& v) const noexcept
+		{
+			return (*this * Vec4{ v, 0.f }).xyz();
+		}
+	};
+
+	struct Quat
+	{
+		Quat(float pX = 0.f, float pY = 0.f, float pZ = 0.f, float pW = 1.f)
+			:
+			X{ pX },
+			Y{ pY },
+			Z{ pZ },
+			W{ pW }
+		{
+
+		}
+
+		// Degrees around axis, like glRotatef
+		static Quat fromAxisAngle(float angleDegrees, const Vec3& axis) noexcept
+		{
+			const auto halfRad = angleDegrees * static_cast<float>(M_PI) / 360.f;
+			const auto v = normalize(axis) * std::sin(halfRad);
+			return { v.X, v.Y, v.Z, std::cos(halfRad) };
+		}
+
+		Quat operator*(const Quat& rhs) const noexcept
+		{
+			return {
+				W * rhs.X + X * rhs.W + Y * rhs.Z - Z * rhs.Y,
+				W * rhs.Y - X * rhs.Z + Y * rhs.W + Z * rhs.X,
+				W * rhs.Z + X * rhs.Y - Y * rhs.X + Z * rhs.W,
+				W * rhs.W - X * rhs.X - Y * rhs.Y - Z * rhs.Z
+			};
+		}
+
+		Quat conjugate() const noexcept
+		{
+			return { -X, -Y, -Z, W };
+		}
+
+		Vec3 rotate(const Vec3& v) const noexcept
+		{
+			const auto u = Vec3{ X, Y, Z };
+			const auto t = cross(u, v) * 2.f;
+			return v + t * W + cross(u, t);
+		}
+
+		Mat4 toMat4() const noexcept
+		{
+			return { {
+				1.f - 2.f * (Y * Y + Z * Z), 2.f * (X * Y + Z * W),       2.f * (X * Z - Y * W),       0.f,
+				2.f * (X * Y - Z * W),       1.f - 2.f * (X * X + Z * Z), 2.f * (Y * Z + X * W),       0.f,
+				2.f * (X * Z + Y * W),       2.f * (Y * Z - X * W),       1.f - 2.f * (X * X + Y * Y), 0.f,
+				0.f,                         0.f,                         0.f,                         1.f
+			} };
+		}
+
+		float X;
+		float Y;
+		float Z;
+		float W;
+	};
+
+	inline Quat normalize(const Quat& q) noexcept
+	{
+		const auto s = 1.f / std::sqrt(q.X * q.X + q.Y * q.Y + q.Z * q.Z + q.W * q.W);
+		return { q.X * s, q.Y * s, q.Z * s, q.W * s };
+	}
+
+	inline Quat slerp(const Quat& from, Quat to, float t) noexcept
+	{
+		auto cosTheta = from.X * to.X + from.Y * to.Y + from.Z * to.Z + from.W * to.W;
+
+		// Takes the short way around
+		if(cosTheta < 0.f)
+		{
+			to = { -to.X, -to.Y, -to.Z, -to.W };
+			cosTheta = -cosTheta;
+		}
+
+		if(cosTheta > 0.9995f)
+		{
+			return normalize(Quat{
+				from.X + (to.X - from.X) * t, from.Y + (to.Y - from.Y) * t,
+				from.Z + (to.Z - from.Z) * t, from.W + (to.W - from.W) * t
+			});
+		}
+
+		const auto theta = std::acos(cosTheta);
+		const auto a = std::sin((1.f - t) * theta) / std::sin(theta);
+		const auto b = std::sin(t * theta) / std::sin(theta);
+
+		return { from.X * a + to.X * b, from.Y * a + to.Y * b, from.Z * a + to.Z * b, from.W * a + to.W * b };
+	}
+
+	// A pointer and a size, made from a std::vector, a C array or a pointer and a count
+	template<typename T>
+	struct Span
+	{
+		Span(T* pData, std::size_t pSize)
+			:
+			data{ pData },
+			size{ pSize }
+		{
+
+		}
+
+		template<typename U>
+		Span(std::vector<U>& v)
+			:
+			Span{ v.data(), v.size() }
+		{
+
+		}
+
+		template<typename U>
+		Span(const std::vector<U>& v)
+			:
+			Span{ v.data(), v.size() }
+		{
+
+		}
+
+		template<typename U>
+		Span(const Span<U>& other)
+			:
+			Span{ other.data, other.size }
+		{
+
+		}
+
+		template<std::size_t N>
+		Span(T (&array)[N])
+			:
+			Span{ array, N }
+		{
+
+		}
+
+		T* begin() const noexcept
+		{
+			return data;
+		}
+
+		T* end() const noexcept
+		{
+			return data + size;
+		}
+
+		T* data;
+		std::size_t size;
+	};
+
+	namespace Detail
+	{
+#if SIMDMATH_SSE
+		struct Sse
+		{
+			using Reg = __m128;
+			static constexpr std::size_t width = 4;
+
+			static Reg load(const float* p) { return _mm_loadu_ps(p); }
+			static void store(float* p, Reg r) { _mm_storeu_ps(p, r); }
+			static Reg set1(float v) { return _mm_set1_ps(v); }
+			static Reg add(Reg a, Reg b) { return _mm_add_ps(a, b); }
+			static Reg mul(Reg a, Reg b) { return _mm_mul_ps(a, b); }
+			static Reg rsqrtEstimate(Reg a) { return _mm_rsqrt_ps(a); }
+
+			template<int imm>
+			static Reg shuffle(Reg a, Reg b) { return _mm_shuffle_ps(a, b, imm); }
+		};
+#endif
+
+#if SIMDMATH_AVX
+		// The lower lane works on four vectors and the upper lane on the next four,
+		// so all the shuffles stay inside a lane like in the SSE kernel
+		struct Avx
+		{
+			using Reg = __m256;
+			static constexpr std::size_t width = 8;
+
+			static Reg load(const float* p) { return _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_loadu_ps(p)), _mm_loadu_ps(p + 12), 1); }
+			static void store(float* p, Reg r) { _mm_storeu_ps(p, _mm256_castps256_ps128(r)); _mm_storeu_ps(p + 12, _mm256_extractf128_ps(r, 1)); }
+			static Reg set1(float v) { return _mm256_set1_ps(v); }
+			static Reg add(Reg a, Reg b) { return _mm256_add_ps(a, b); }
+			static Reg mul(Reg a, Reg b) { return _mm256_mul_ps(a, b); }
+			static Reg rsqrtEstimate(Reg a) { return _mm256_rsqrt_ps(a); }
+
+			template<int imm>
+			static Reg shuffle(Reg a, Reg b) { return _mm256_shuffle_ps(a, b, imm); }
+		};
+
+		using Wide = Avx;
+#elif SIMDMATH_SSE
+		using Wide = Sse;
+#endif
+
+#if SIMDMATH_SSE
+		// Four packed Vec3 are three registers:
+		// a = x0 y0 z0 x1, b = y1 z1 x2 y2, c = z2 x3 y3 z3
+		template<typename Simd>
+		void loadVec3s(const float* p, typename Simd::Reg& x, typename Simd::Reg& y, typename Simd::Reg& z)
+		{
+			const auto a = Simd::load(p);
+			const auto b = Simd::load(p + 4);
+			const auto c = Simd::load(p + 8);
+
+			x = Simd::template shuffle<_MM_SHUFFLE(3, 0, 3, 0)>(a, Simd::template shuffle<_MM_SHUFFLE(1, 0, 3, 2)>(b, c));
+			y = Simd::template shuffle<_MM_SHUFFLE(2, 0, 2, 0)>(
+				Simd::template shuffle<_MM_SHUFFLE(0, 0, 1, 1)>(a, b), Simd::template shuffle<_MM_SHUFFLE(2, 2, 3, 3)>(b, c));
+			z = Simd::template shuffle<_MM_SHUFFLE(2, 0, 2, 0)>(
+				Simd::template shuffle<_MM_SHUFFLE(1, 1, 2, 2)>(a, b), Simd::template shuffle<_MM_SHUFFLE(3, 3, 0, 0)>(c, c));
+		}
+
+		template<typename Simd>
+		void storeVec3s(float* p, typename Simd::Reg x, typename Simd::Reg y, typename Simd::Reg z)
+		{
+			const auto a = Simd::template shuffle<_MM_SHUFFLE(2, 0, 2, 0)>(
+				Simd::template shuffle<_MM_SHUFFLE(0, 0, 0, 0)>(x, y), Simd::template shuffle<_MM_SHUFFLE(1, 1, 0, 0)>(z, x));
+			const auto b = Simd::template shuffle<_MM_SHUFFLE(2, 0, 2, 0)>(
+				Simd::template shuffle<_MM_SHUFFLE(1, 1, 1, 1)>(y, z), Simd::template shuffle<_MM_SHUFFLE(2, 2, 2, 2)>(x, y));
+			const auto c = Simd::template shuffle<_MM_SHUFFLE(2, 0, 2, 0)>(
+				Simd::template shuffle<_MM_SHUFFLE(3, 3, 2, 2)>(z, x), Simd::template shuffle<_MM_SHUFFLE(3, 3, 3, 3)>(y, z));
+
+			Simd::store(p, a);
+			Simd::store(p + 4, b);
+			Simd::store(p + 8, c);
+		}
+
+		// The hardware estimate refined with one Newton-Raphson step, ~1e-7 relative error
+		template<typename Simd>
+		typename Simd::Reg rsqrt(typename Simd::Reg v)
+		{
+			const auto y = Simd::rsqrtEstimate(v);
+			const auto yyv = Simd::mul(Simd::mul(y, y), v);
+			return Simd::mul(Simd::mul(Simd::set1(0.5f), y), Simd::add(Simd::set1(3.f), Simd::mul(yyv, Simd::set1(-1.f))));
+		}
+
+		// Works on whole groups of Simd::width vectors and returns how many it did,
+		// the rest is left for the scalar loop
+		template<typename Simd>
+		std::size_t normalizeKernel(Vec3* v, std::size_t n)
+		{
+			const auto groups = n / Simd::width * Simd::width;
+
+			for(std::size_t i{}; i < groups; i += Simd::width)
+			{
+				const auto p = reinterpret_cast<float*>(v + i);
+
+				typename Simd::Reg x, y, z;
+				loadVec3s<Simd>(p, x, y, z);
+
+				const auto s = rsqrt<Simd>(Simd::add(Simd::add(Simd::mul(x, x), Simd::mul(y, y)), Simd::mul(z, z)));
+				storeVec3s<Simd>(p, Simd::mul(x, s), Simd::mul(y, s), Simd::mul(z, s));
+			}
+
+			return groups;
+		}
+#endif
+	}
+
+	// Normalizes every vector of the span in place
+	inline void normalize(Span<Vec3> v)
+	{
+		std::size_t i{};
+
+#if SIMDMATH_SSE
+		i = Detail::normalizeKernel<Detail::Wide>(v.data, v.size);
+#endif
+
+		for(; i < v.size; ++i)
+			v.data[i] = normalize(v.data[i]);
+	}
+}
@@ -1,11 +1,17 @@
+#pragma once
 
 #define _USE_MATH_DEFINES
 
 #include <GL/glew.h>
 #include <GL/freeglut.h> 
+#include "SceneRegistry.h"
+#include "SimdMath.h"
+#include "TransformHierarchy.h"
+#include "FrameClock.h"
+#include "Primitives.h"
 #include <iostream>
+#include <cmath>
 #include <vector>
-#include <chrono>
 #include <memory>
 
 namespace SolarySystem
@@ -13,53 +19,14 @@ namespace SolarySystem
 	static bool isAnimate;
 	static int animationPeriod = 25;
 
-	std::chrono::system_clock::time_point tp;
+	FrameClock::Stopwatch stopwatch;
 
-	struct Vector
-	{
-		Vector(float pX = 0.f, float pY = 0.f, float pZ = 0.f)
-			:
-			X{ pX },
-			Y{ pY },
-			Z{ pZ }
-		{
-
-		}
-
-		float length() const noexcept
-		{
-			return std::sqrt(X * X + Y * Y + Z * Z);
-		}
-
-		Vector& operator+=(const Vector& rhs) noexcept
-		{
-			return *this = *this + rhs;;
-		}
-
-		Vector& operator-=(const Vector& rhs) noexcept
-		{
-			return *this = *this - rhs;;
-		}
-
-		Vector operator+(const Vector& rhs) const noexcept
-		{
-			return { X + rhs.X, Y + rhs.Y, Z + rhs.Z };
-		}
-
-		Vector operator-(const Vector& rhs) const noexcept
-		{
-			return { X - rhs.X, Y - rhs.Y, Z - rhs.Z };
-		}
-
-		Vector operator*(float v) const noexcept
-		{
-			return { X * v, Y * v, Z * v };
-		}
+	using Vector = SimdMath::Vec3;
+	using SimdMath::Mat4;
+	using TransformHierarchy::Node;
 
-		float X;
-		float Y;
-		float Z;
-	};
+	// Every actor owns nodes here, the world matrices of all of them are evaluated once per frame
+	TransformHierarchy::Hierarchy hierarchy;
 
 	struct Color
 	{
@@ -82,22 +49,6 @@ namespace SolarySystem
 		return (a - b) < e;
 	}
 
-	Vector normalize(const Vector& v)
-	{
-		return { v.X / v.length(), v.Y / v.length(), v.Z / v.length() };
-	}
-
-	Vector operator* (float lhs, const Vector& rhs)
-	{
-		return rhs * lhs;
-	}
-
-	std::ostream& operator<<(std::ostream& os, const Vector& v)
-	{
-		os << "X: " << v.X << " Y: " << v.Y << " Z: " << v.Z;
-		return os;
-	}
-
 	struct Rotation
 	{
 		Rotation(float pAngle = 0, const Vector& pDirs = Vector{})
@@ -112,6 +63,17 @@ namespace SolarySystem
 		Vector dirs;
 	};
 
+	Mat4 getRotationMatrix(const Rotation& rotation)
+	{
+		return Mat4::rotation(rotation.angle, rotation.dirs);
+	}
+
+	// Rotation around dirs, translation, and then the spin of the body around its own Y axis
+	Mat4 getOrbitMatrix(const Rotation& rotation, const Vector& location)
+	{
+		return getRotationMatrix(rotation) * Mat4::translation(location) * Mat4::rotation(rotation.angle, { 0.f, 1.f, 0.f });
+	}
+
 	struct Transform
 	{
 		Transform(const Vector& pTranslation,
@@ -135,6 +97,7 @@ namespace SolarySystem
 	{
 		virtual ~Actor() = default;
 		virtual void tick(float deltaTime) = 0;
+		virtual void draw() const = 0;
 		virtual void setTransform(const Transform& newTransform) = 0;
 		virtual Transform getTransform() const = 0;
 
@@ -147,7 +110,8 @@ namespace SolarySystem
 	{
 		explicit Sun(const Transform& pTransform)
 			:
-			transform{ pTransform }
+			transform{ pTransform },
+			node{ hierarchy.add() }
 		{
 
 		}
@@ -158,7 +122,14 @@ namespace SolarySystem
 			if (transform.rotation.angle >= 360.)
 				transform.rotation.angle -= 360.f;
 
-			draw();
+			hierarchy.setLocal(node, Mat4::rotation(transform.rotation.angle, { 0.f, 1.f, 0.f }));
+		}
+
+		void draw() const override
+		{
+			glColor3f(1.f, 165 / 255.f, 0);
+			hierarchy.load(node);
+			Primitives::drawWireSphereOnScreen(5, 30, 30);
 		}
 
 		void setTransform(const Transform& newTransform) override
@@ -174,24 +145,17 @@ namespace SolarySystem
 	private:
 
 		Transform transform;
-
-		void draw()
-		{
-			glColor3f(1.f, 165 / 255.f, 0);
-			glPushMatrix();
-			glRotated(transform.rotation.angle, 0., 1., 0.);
-			glutWireSphere(5, 30, 30);
-			glPopMatrix();
-		}
+		Node node;
 	};
 
 	struct Moon 
 	{
-		Moon(const Transform& pTransform, const Color& pColor, float pSpeedAnglePerSec)
+		Moon(Node parent, const Transform& pTransform, const Color& pColor, float pSpeedAnglePerSec)
 			:
 			transform{pTransform},
 			color{pColor},
-			speedAnglePerSec{ pSpeedAnglePerSec }
+			speedAnglePerSec{ pSpeedAnglePerSec },
+			node{ hierarchy.add(parent) }
 		{
 
 		}
@@ -203,22 +167,15 @@ namespace SolarySystem
 			angle += speedAnglePerSec * deltaTime;
 			if (angle >= 360.f)
 				angle -= 360.f;
+
+			hierarchy.setLocal(node, getOrbitMatrix(transform.rotation, transform.translation));
 		}
 
-		void draw()
+		void draw() const
 		{
-			const auto& moonLoc = transform.translation;
-			const auto& moonRot = transform.rotation;
-
-			glPushMatrix();
 			glColor3f(color.R, color.G, color.B);
-
-			glRotated(moonRot.angle, moonRot.dirs.X, moonRot.dirs.Y, moonRot.dirs.Z);
-			glTranslated(moonLoc.X, moonLoc.Y, moonLoc.Z);
-			glRotated(moonRot.angle, 0.f, 1.f, 0.f);
-
-			glutWireSphere(1., 30, 30);
-			glPopMatrix();
+			hierarchy.load(node);
+			Primitives::drawWireSphereOnScreen(1., 30, 30);
 		}
 
 	private:
@@ -226,7 +183,7 @@ namespace SolarySystem
 		Transform transform;
 		Color color;
 		float speedAnglePerSec;
-	
+		Node node;
 	};
 
 	struct Earth : Actor
@@ -236,6 +193,7 @@ namespace SolarySystem
 			sun{pSun},
 			r{pR},
 			transform{ initTransform() },
+			node{ hierarchy.add() },
 			moonRotX{ initMoonRotX() },
 			moonRotY{ initMoonRotY() }
 		{
@@ -248,10 +206,20 @@ namespace SolarySystem
 			if (transform.rotation.angle >= 360.)
 				transform.rotation.angle -= 360.f;
 
+			hierarchy.setLocal(node, getOrbitMatrix(transform.rotation, transform.translation));
+
 			moonRotX.tick(deltaTime);
 			moonRotY.tick(deltaTime);
+		}
 
-			draw();
+		void draw() const override
+		{
+			moonRotX.draw();
+			moonRotY.draw();
+
+			glColor3f(0.f, 0.f, 1.f);
+			hierarchy.load(node);
+			Primitives::drawWireSphereOnScreen(2., 30, 30);
 		}
 
 		void setTransform(const Transform& newTransform) override
@@ -269,6 +237,8 @@ namespace SolarySystem
 		const std::reference_wrapper<const Sun> sun;
 		float r;
 		Transform transform;
+		// Declared before the moons, they are its children in the hierarchy
+		Node node;
 		Moon moonRotX;
 		Moon moonRotY;
 
@@ -289,7 +259,7 @@ namespace SolarySystem
 			transform.rotation.angle = 30.f;
 			transform.rotation.dirs = { 0.f, 1.f, 0.f };
 			
-			return Moon(transform, {1.f, 0.f, 0.f}, 90.f);
+			return Moon(node, transform, {1.f, 0.f, 0.f}, 90.f);
 		}
 
 		Moon initMoonRotY() const noexcept
@@ -300,27 +270,7 @@ namespace SolarySystem
 			transform.rotation.angle = 0.f;
 			transform.rotation.dirs = { 1.f, 0.f, 0.f };
 
-			return Moon(transform, { 0.7f, 0.7f, 0.7f }, 180.f);
-		}
-
-		void draw()
-		{
-			const auto& loc = transform.translation;
-			const auto& rot = transform.rotation;
-
-			glPushMatrix();
-
-			glRotated(rot.angle, rot.dirs.X, rot.dirs.Y, rot.dirs.Z);
-			glTranslated(loc.X, loc.Y, loc.Z);
-			glRotated(rot.angle, 0.f, 1.f, 0.f);
-
-			moonRotX.draw();
-			moonRotY.draw();
-
-			glColor3f(0.f, 0.f, 1.f);
-			glutWireSphere(2., 30, 30);
-			
-			glPopMatrix();
+			return Moon(node, transform, { 0.7f, 0.7f, 0.7f }, 180.f);
 		}
 	};
 
@@ -332,7 +282,8 @@ namespace SolarySystem
 			rotUpDown{ 0.f, {0.f, 0., 1.f} },
 			color{ pColor },
 			speedAnglePerSec{ pSpeedAnglePerSec },
-			radius{pRadius}
+			radius{pRadius},
+			node{ hierarchy.add() }
 		{
 
 		}
@@ -343,7 +294,15 @@ namespace SolarySystem
 
 			if (rotUpDown.angle >= 360.)
 				rotUpDown.angle -= 360.f;
-			draw();
+
+			hierarchy.setLocal(node, getRotationMatrix(transform.rotation) * getOrbitMatrix(rotUpDown, transform.translation));
+		}
+
+		void draw() const override
+		{
+			glColor3f(color.R, color.G, color.B);
+			hierarchy.load(node);
+			Primitives::drawWireSphereOnScreen(radius, 30, 30);
 		}
 
 		void setTransform(const Transform& newTransform) override
@@ -362,28 +321,7 @@ namespace SolarySystem
 		Color color;
 		float speedAnglePerSec;
 		float radius;
-
-		void draw()
-		{
-			const auto& loc = transform.translation;
-			const auto& rot = transform.rotation;
-			glColor3f(color.R, color.G, color.B);
-
-			glPushMatrix();
-			glRotated(rot.angle, rot.dirs.X, rot.dirs.Y, rot.dirs.Z);
-				
-				glPushMatrix();
-			
-				glRotated(rotUpDown.angle, rotUpDown.dirs.X, rotUpDown.dirs.Y, rotUpDown.dirs.Z);
-				glTranslated(loc.X, loc.Y, loc.Z);
-				glRotated(rotUpDown.angle, 0.f, 1.f, 0.f);
-
-				glutWireSphere(radius, 30, 30);
-			
-				glPopMatrix();
-			
-			glPopMatrix();
-		}
+		Node node;
 	};
 
 	
@@ -403,23 +341,21 @@ namespace SolarySystem
 
 	void tick(float deltaTime)
 	{
-		glTranslated(0.f, 0.f, -30.f);
-		glRotated(45., 1.f, 0.f, 0.f);
 		for (auto& actor : actors)
 			actor->tick(deltaTime);
 
+		hierarchy.evaluate(Mat4::translation({ 0.f, 0.f, -30.f }) * Mat4::rotation(45.f, { 1.f, 0.f, 0.f }));
+
+		for (const auto& actor : actors)
+			actor->draw();
 	}
 
 	void drawScene(void)
 	{
-		using namespace std::chrono;
-
 		glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 		glLoadIdentity();
 
-		auto d = duration_cast<milliseconds>(system_clock::now() - tp);
-		const auto deltaTime = float(d.count()) * milliseconds::period::num / milliseconds::period::den;
-		tp = system_clock::now();
+		const auto deltaTime = stopwatch.tick();
 
 		tick(deltaTime);
 		glutSwapBuffers();
@@ -451,6 +387,7 @@ namespace SolarySystem
 	{
 		isAnimate = false;
 		actors.clear();
+		hierarchy.clear();
 		initActors();
 		glutPostRedisplay();
 	}
@@ -459,7 +396,7 @@ namespace SolarySystem
 	{
 		glClearColor(1.0, 1.0, 1.0, 0.0);
 		glEnable(GL_DEPTH_TEST);
-		tp = std::chrono::system_clock::now();
+		stopwatch.reset();
 		initActors();
 	}
 
@@ -491,7 +428,7 @@ namespace SolarySystem
 
 			if (isAnimate)
 			{
-				tp = std::chrono::system_clock::now();
+				stopwatch.reset();
 				animate(1);
 			}
 			break;
@@ -535,4 +472,6 @@ namespace SolarySystem
 
 		return 0;
 	}
+
+	static SceneRegistry::Registrar registrar{ { "SolarySystem", main, setup, drawScene, resize, keyInput } };
 }
@@ -1,9 +1,12 @@
+#pragma once
 ///////////////////////////////////////////////////////////////////////////////////////          
 // This program approximates a sphere with triangle strips.
 //
 // Interaction:
 // Press P/p to increase/decrease the number of longitudinal slices.
 // Press Q/q to increase/decrease the number of latitudinal slices.
+// Press a to toggle picking the slices from the size of the sphere on screen.
+// Press h to cycle through the ways of submitting the sphere to OpenGL.
 // Press x, X, y, Y, z, Z to turn the sphere.
 /////////////////////////////////////////////////////////////////////////////////////// 
 
@@ -11,15 +14,25 @@
 
 #include <cmath>
 #include <vector>
+#include <memory>
+#include <iterator>
+#include <algorithm>
 #include <iostream>
 #include <GL/glew.h>
 #include <GL/freeglut.h>
+#include "SceneRegistry.h"
+#include "SimdMath.h"
+#include "ParametricSurface.h"
+#include "LevelOfDetail.h"
+#include "Instancing.h"
+#include "GLContext.h"
 
 namespace Sphere
 {
 	static float R = 5.0;
 	static int p = 6;
 	static int q = 4;
+	static bool isAutomaticSlices;
 	static float Xangle = 0.0, Yangle = 0.0, Zangle = 0.0;
 
 	struct SphereHandler
@@ -30,88 +43,77 @@ namespace Sphere
 		virtual void pOrQChanged() = 0;
 	};
 	
+	// The point at longitude i of p and latitude j of q, the equator is latitude 0
+	SimdMath::Vec3 getSpherePoint(int i, int j)
+	{
+		const auto fi = M_PI_2 * j / q;
+		const auto th = 2.0 * i / p * M_PI;
+
+		return SimdMath::Vec3(R * cos(fi) * cos(th), R * sin(fi), -R * cos(fi) * sin(th));
+	}
+
+	// Latitudes from firstLatitude to q as rows and p + 1 longitudes as columns
+	ParametricSurface::Mesh getSphereMesh(int firstLatitude)
+	{
+		return ParametricSurface::tessellate({ p, q - firstLatitude }, [firstLatitude](int i, int j) {
+			return getSpherePoint(i, j + firstLatitude);
+		});
+	}
+
 	struct ImmediateHandler : SphereHandler
 	{
 		void setup() override
 		{
-
+			mesh = getSphereMesh(-q);
 		}
 
 		void drawScene() override
 		{
-			int j, i;
-			for (j = -q; j < q; j++)
+			for (int j = 0; j < mesh.vSlices; j++)
 			{
-				glBegin(GL_TRIANGLE_STRIP);
-				for (i = 0; i <= p; i++)
-				{
-					auto fi = M_PI_2 * (j + 1) / q;
-					const auto th = 2.0 * i / p * M_PI;
-
-					glVertex3f(R * cos(fi) * cos(th), R * sin(fi), -R * cos(fi) * sin(th));
+				const auto strip = mesh.getStrip(j);
 
-					fi = M_PI_2 * j / q;
-
-					glVertex3f(R * cos(fi) * cos(th), R * sin(fi), -R * cos(fi) * sin(th));
-
-				}
+				glBegin(GL_TRIANGLE_STRIP);
+				for (int i = 0; i < mesh.getStripLength(); i++)
+					glVertex3fv(&mesh.positions[strip[i]].X);
 				glEnd();
 			}
 		}
 
 		void pOrQChanged() override
 		{
-
+			mesh = getSphereMesh(-q);
 		}
+
+		private:
+
+		ParametricSurface::Mesh mesh;
 	};
 
 	struct DrawElementsHandler : SphereHandler
 	{
 		void setup() override
 		{
+			mesh = getSphereMesh(-q);
 			glEnableClientState(GL_VERTEX_ARRAY);
 		}
 
 		void drawScene() override
 		{
-			int j, i, index;
-			for (j = -q; j < q; j++)
-			{
-				std::vector<float> vertices;
-				vertices.reserve((p + 1) * 3);
-
-				std::vector<unsigned int> indices;
-				indices.reserve(p + 1);
-
-				for (i = 0, index = 0; i <= p; i++, index += 2)
-				{
-					auto fi = M_PI_2 * (j + 1) / q;
-					const auto th = 2.0 * i / p * M_PI;
-
-					vertices.push_back(R * cos(fi) * cos(th));
-					vertices.push_back(R * sin(fi));
-					vertices.push_back(-R * cos(fi) * sin(th));
-
-					indices.push_back(index);
+			glVertexPointer(3, GL_FLOAT, 0, mesh.positions.data());
 
-					fi = M_PI_2 * j / q;
-
-					vertices.push_back(R * cos(fi) * cos(th));
-					vertices.push_back(R * sin(fi));
-					vertices.push_back(-R * cos(fi) * sin(th));
-
-					indices.push_back(index + 1);
-				}
-
-				glVertexPointer(3, GL_FLOAT, 0, vertices.data());
-				glDrawElements(GL_TRIANGLE_STRIP, indices.size(), GL_UNSIGNED_INT, indices.data());
-			}
+			for (int j = 0; j < mesh.vSlices; j++)
+				glDrawElements(GL_TRIANGLE_STRIP, mesh.counts[j], GL_UNSIGNED_INT, mesh.getStrip(j));
 		}
 
 		void pOrQChanged() override
 		{
-
+			mesh = getSphereMesh(-q);
 		}
+
+		private:
+
+		ParametricSurface::Mesh mesh;
 	};
 
 	struct DrawArraysHandler : SphereHandler
@@ -125,7 +127,7 @@ namespace Sphere
 		void drawScene() override
 		{
 			glVertexPointer(3, GL_FLOAT, 0, vertices.data());
-			glDrawArrays(GL_TRIANGLE_STRIP, 0, vertices.size() / 3);
+			glDrawArrays(GL_TRIANGLE_STRIP, 0, vertices.size());
 		}
 
 		void pOrQChanged() override
@@ -136,28 +138,14 @@ namespace Sphere
 
 		private:
 
+		// The strips of all the rows one after another as a single strip
 		void fillVertices()
 		{
-			int j, i;
-			for (j = -q; j < q; j++)
-			{
-				for (i = 0; i <= p; i++)
-				{
-					auto fi = M_PI_2 * (j + 1) / q;
-					const auto th = 2.0 * i / p * M_PI;
-
-					vertices.push_back(R * cos(fi) * cos(th));
-					vertices.push_back(R * sin(fi));
-					vertices.push_back(-R * cos(fi) * sin(th));
-
-					fi = M_PI_2 * j / q;
-
-					vertices.push_back(R * cos(fi) * cos(th));
-					vertices.push_back(R * sin(fi));
-					vertices.push_back(-R * cos(fi) * sin(th));
+			const auto mesh = getSphereMesh(-q);
 
-				}
-			}
+			vertices.reserve(mesh.indices.size());
+			for (const auto index : mesh.indices)
+				vertices.push_back(mesh.positions[index]);
 		}
 		
 		void clearVertices()
@@ -165,7 +153,7 @@ namespace Sphere
 			vertices.erase(std::begin(vertices), std::end(vertices));
 		}
 
-		std::vector<float> vertices;
+		std::vector<SimdMath::Vec3> vertices;
 	};
 
 	struct ListsHandler : SphereHandler
@@ -194,39 +182,313 @@ namespace Sphere
 		{
 			if(initial)
 				hemSphere = glGenLists(1);
+
+			const auto mesh = getSphereMesh(0);
 			
 			glNewList(hemSphere, GL_COMPILE);
-			int j, i;
-			for (j = 0; j < q; j++)
+			for (int j = 0; j < mesh.vSlices; j++)
 			{
+				const auto strip = mesh.getStrip(j);
+
 				glBegin(GL_TRIANGLE_STRIP);
-				for (i = 0; i <= p; i++)
-				{
-					auto fi = M_PI_2 * (j + 1) / q;
-					const auto th = 2.0 * i / p * M_PI;
+				for (int i = 0; i < mesh.getStripLength(); i++)
+					glVertex3fv(&mesh.positions[strip[i]].X);
+				glEnd();
+			}
+			glEndList();
+		}
+		unsigned int hemSphere;
+
+	};
+
+	// The mesh in a vertex and an element buffer, all the rows drawn by one glMultiDrawElements
+	struct VAOHandler : SphereHandler
+	{
+		// The objects are only deleted in the context that made them
+		~VAOHandler() override
+		{
+			if (GLContext::isCurrent(context))
+			{
+				glDeleteVertexArrays(1, &vertexArray);
+				glDeleteBuffers(2, buffers);
+			}
+		}
+
+		void setup() override
+		{
+			context = GLContext::getGeneration();
+
+			glGenVertexArrays(1, &vertexArray);
+			glGenBuffers(2, buffers);
+
+			glBindVertexArray(vertexArray);
+			glBindBuffer(GL_ARRAY_BUFFER, buffers[VERTICES]);
+			glEnableClientState(GL_VERTEX_ARRAY);
+			glVertexPointer(3, GL_FLOAT, 0, nullptr);
+			glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, buffers[INDICES]);
+			glBindVertexArray(0);
+			glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+			fillBuffers();
+		}
+
+		void drawScene() override
+		{
+			glBindVertexArray(vertexArray);
+			glMultiDrawElements(GL_TRIANGLE_STRIP, mesh.counts.data(), GL_UNSIGNED_INT, mesh.offsets.data(), mesh.counts.size());
+			glBindVertexArray(0);
+		}
+
+		void pOrQChanged() override
+		{
+			fillBuffers();
+		}
+
+		private:
+
+		enum Buffers
+		{
+			VERTICES,
+			INDICES
+		};
 
-					glVertex3f(R * cos(fi) * cos(th), R * sin(fi), -R * cos(fi) * sin(th));
+		void fillBuffers()
+		{
+			mesh = getSphereMesh(-q);
+
+			glBindBuffer(GL_ARRAY_BUFFER, buffers[VERTICES]);
+			glBufferData(GL_ARRAY_BUFFER, mesh.positions.size() * sizeof(mesh.positions[0]), mesh.positions.data(), GL_STATIC_DRAW);
+			glBindBuffer(GL_ARRAY_BUFFER, 0);
 
-					fi = M_PI_2 * j / q;
+			glBindVertexArray(vertexArray);
+			glBufferData(GL_ELEMENT_ARRAY_BUFFER, mesh.indices.size() * sizeof(mesh.indices[0]), mesh.indices.data(), GL_STATIC_DRAW);
+			glBindVertexArray(0);
+		}
 
-					glVertex3f(R * cos(fi) * cos(th), R * sin(fi), -R * cos(fi) * sin(th));
+		// The counts and offsets of the rows in the element buffer
+		ParametricSurface::Mesh mesh;
+		unsigned context = 0;
+		GLuint vertexArray = 0;
+		GLuint buffers[2] = {};
+	};
 
+	// Copies the vertices every frame into a persistently mapped buffer, as a mesh
+	// changing every frame would. The buffer has a region for each of the last
+	// regionsN frames, and a fence per region keeps the copy from overwriting
+	// vertices the GPU may still be reading
+	struct PersistentMappedHandler : SphereHandler
+	{
+		~PersistentMappedHandler() override
+		{
+			if (GLContext::isCurrent(context))
+				destroyBuffers();
+		}
+
+		void setup() override
+		{
+			if (!GLEW_ARB_buffer_storage)
+			{
+				std::cerr << "Persistent mapping needs GL_ARB_buffer_storage" << std::endl;
+				return;
+			}
+
+			createBuffers();
+		}
+
+		void drawScene() override
+		{
+			if (!vertices)
+				return;
+
+			if (fences[region])
+			{
+				while (glClientWaitSync(fences[region], GL_SYNC_FLUSH_COMMANDS_BIT, 1000000000) == GL_TIMEOUT_EXPIRED);
+				glDeleteSync(fences[region]);
+			}
+
+			const auto vertexCount = mesh.positions.size();
+			std::copy(mesh.positions.begin(), mesh.positions.end(), vertices + region * vertexCount);
+			std::fill(baseVertices.begin(), baseVertices.end(), static_cast<GLint>(region * vertexCount));
+
+			glBindVertexArray(vertexArray);
+			glMultiDrawElementsBaseVertex(GL_TRIANGLE_STRIP, mesh.counts.data(), GL_UNSIGNED_INT, mesh.offsets.data(), mesh.counts.size(), baseVertices.data());
+			glBindVertexArray(0);
+
+			fences[region] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+			region = (region + 1) % regionsN;
+		}
+
+		void pOrQChanged() override
+		{
+			// The storage of a buffer cannot be resized, a new one is made for the new mesh
+			if (!vertices)
+				return;
+
+			destroyBuffers();
+			createBuffers();
+		}
+
+		private:
+
+		static constexpr int regionsN = 3;
+
+		enum Buffers
+		{
+			VERTICES,
+			INDICES
+		};
+
+		void createBuffers()
+		{
+			mesh = getSphereMesh(-q);
+			baseVertices.resize(mesh.counts.size());
+			context = GLContext::getGeneration();
+
+			glGenVertexArrays(1, &vertexArray);
+			glGenBuffers(2, buffers);
+
+			glBindVertexArray(vertexArray);
+
+			const auto flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+			const auto size = regionsN * mesh.positions.size() * sizeof(mesh.positions[0]);
+
+			glBindBuffer(GL_ARRAY_BUFFER, buffers[VERTICES]);
+			glBufferStorage(GL_ARRAY_BUFFER, size, nullptr, flags);
+			vertices = static_cast<SimdMath::Vec3*>(glMapBufferRange(GL_ARRAY_BUFFER, 0, size, flags));
+			glEnableClientState(GL_VERTEX_ARRAY);
+			glVertexPointer(3, GL_FLOAT, 0, nullptr);
+
+			glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, buffers[INDICES]);
+			glBufferData(GL_ELEMENT_ARRAY_BUFFER, mesh.indices.size() * sizeof(mesh.indices[0]), mesh.indices.data(), GL_STATIC_DRAW);
+
+			glBindVertexArray(0);
+			glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+			if (!vertices)
+				std::cerr << "Cannot map the vertex buffer persistently" << std::endl;
+		}
+
+		void destroyBuffers()
+		{
+			for (auto& fence : fences)
+			{
+				if (fence)
+					glDeleteSync(fence);
+				fence = nullptr;
+			}
+
+			// Deleting a buffer unmaps it
+			glDeleteVertexArrays(1, &vertexArray);
+			glDeleteBuffers(2, buffers);
+			vertices = nullptr;
+			region = 0;
+		}
+
+		ParametricSurface::Mesh mesh;
+		std::vector<GLint> baseVertices;
+		unsigned context = 0;
+		GLuint vertexArray = 0;
+		GLuint buffers[2] = {};
+		SimdMath::Vec3* vertices = nullptr;
+		GLsync fences[regionsN] = {};
+		int region = 0;
+	};
+
+	// One pole to pole strip of the first slice, drawn p times turned about the axis
+	struct InstancedHandler : SphereHandler
+	{
+		void setup() override
+		{
+			fillSlices();
+		}
+
+		void drawScene() override
+		{
+			slices.draw();
+		}
+
+		void pOrQChanged() override
+		{
+			fillSlices();
+		}
+
+		private:
+
+		void fillSlices()
+		{
+			std::vector<SimdMath::Vec3> positions;
+			std::vector<unsigned int> indices;
+
+			for (int j = -q; j <= q; j++)
+			{
+				for (int i = 0; i < 2; i++)
+				{
+					indices.push_back(positions.size());
+					positions.push_back(getSpherePoint(i, j));
 				}
-				glEnd();
 			}
-			glEndList();
+
+			// The sphere is drawn black like the other handlers draw it with glColor
+			std::vector<Instancing::Instance> instances;
+			for (int i = 0; i < p; i++)
+				instances.push_back({ SimdMath::Mat4::rotation(360.f * i / p, { 0.f, 1.f, 0.f }), { 0.f, 0.f, 0.f } });
+
+			slices.setMesh(GL_TRIANGLE_STRIP, positions, indices);
+			slices.setInstances(instances);
 		}
-		unsigned int hemSphere;
 
+		Instancing::Batch slices;
+	};
+
+	struct HandlerType
+	{
+		const char* name;
+		std::unique_ptr<SphereHandler> (*create)();
 	};
 
+	template<typename Handler>
+	std::unique_ptr<SphereHandler> createHandler()
+	{
+		return std::make_unique<Handler>();
+	}
+
+	// Every way of drawing the sphere, h cycles through them
+	static const HandlerType handlerTypes[] = {
+		{ "immediate", createHandler<ImmediateHandler> },
+		{ "draw elements", createHandler<DrawElementsHandler> },
+		{ "draw arrays", createHandler<DrawArraysHandler> },
+		{ "display lists", createHandler<ListsHandler> },
+		{ "VAO", createHandler<VAOHandler> },
+		{ "persistent map", createHandler<PersistentMappedHandler> },
+		{ "instanced", createHandler<InstancedHandler> }
+	};
+	static int handlerType = 3;
+
 	static std::unique_ptr<SphereHandler> sphereHandler;
 
+	// The fewest slices keeping the silhouette within LevelOfDetail::maxError pixels for the current matrices
+	void pickSlices()
+	{
+		const auto step = LevelOfDetail::getMaxStep(LevelOfDetail::getProjectedRadius(R));
+		const auto newP = std::max(3, static_cast<int>(std::ceil(2 * M_PI / step)));
+		const auto newQ = std::max(3, static_cast<int>(std::ceil(M_PI_2 / step)));
+
+		if (newP == p && newQ == q)
+			return;
+
+		p = newP;
+		q = newQ;
+		std::cout << "p = " << p << ", q = " << q << std::endl;
+
+		if (sphereHandler)
+			sphereHandler->pOrQChanged();
+	}
+
 	void setup(void)
 	{
 		glClearColor(1.0, 1.0, 1.0, 0.0);
 
-		sphereHandler = std::make_unique<ListsHandler>();
+		sphereHandler = handlerTypes[handlerType].create();
 		sphereHandler->setup();
 	}
 
@@ -244,6 +506,9 @@ namespace Sphere
 
 		glPolygonMode(GL_FRONT_AND_BACK, GL_LINE);
 		glColor3f(0.0, 0.0, 0.0);
+
+		if (isAutomaticSlices)
+			pickSlices();
 		
 		if (sphereHandler)
 			sphereHandler->drawScene();
@@ -297,6 +562,17 @@ namespace Sphere
 				glutPostRedisplay();
 			}
 			break;
+		case 'a':
+			isAutomaticSlices = !isAutomaticSlices;
+			glutPostRedisplay();
+			break;
+		case 'h':
+			handlerType = (handlerType + 1) % std::size(handlerTypes);
+			std::cout << "Drawing with " << handlerTypes[handlerType].name << std::endl;
+			sphereHandler = handlerTypes[handlerType].create();
+			sphereHandler->setup();
+			glutPostRedisplay();
+			break;
 		case 'x':
 			Xangle += 5.0;
 			if (Xangle > 360.0) Xangle -= 360.0;
@@ -337,6 +613,8 @@ namespace Sphere
 		std::cout << "Interaction:" << std::endl;
 		std::cout << "Press P/p to increase/decrease the number of longitudinal slices." << std::endl
 			<< "Press Q/q to increase/decrease the number of latitudinal slices." << std::endl
+			<< "Press a to toggle picking the slices from the size of the sphere on screen." << std::endl
+			<< "Press h to cycle through the ways of submitting the sphere to OpenGL." << std::endl
 			<< "Press x, X, y, Y, z, Z to turn the Sphere." << std::endl;
 	}
 
@@ -366,4 +644,5 @@ namespace Sphere
 		return 0;
 	}
 
+	static SceneRegistry::Registrar registrar{ { "Sphere", main, setup, drawScene, resize, keyInput } };
 }
\ No newline at end of file
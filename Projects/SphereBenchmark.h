@@ -0,0 +1,83 @@
+#pragma once
+///////////////////////////////////////////////////////////////////////////////////////
+// Throughput of every way the Sphere scene submits its mesh, from 8 x 4 to
+// 2048 x 1024 slices, printed by the headless launcher with --sphere-paths.
+//
+// Each handler draws the scene through Offscreen::run, so the submit time is
+// the CPU cost of drawScene and the total time adds glFinish. The wireframe is
+// rasterized too, the framebuffer is kept small so submission weighs the most.
+///////////////////////////////////////////////////////////////////////////////////////
+
+#include <string>
+#include <ostream>
+#include <iomanip>
+#include <iterator>
+#include <algorithm>
+#include "Benchmark.h"
+#include "Offscreen.h"
+#include "Sphere.h"
+
+namespace SphereBenchmark
+{
+	// The size of the framebuffer run expects
+	constexpr int width = 64;
+	constexpr int height = 64;
+
+	struct Result
+	{
+		int p;
+		int q;
+		std::string handler;
+		double triangles;
+		Benchmark::Percentiles cpuMs;
+		Benchmark::Percentiles totalMs;
+	};
+
+	inline Result measure(const Offscreen::Context& context, int p, int q, int handlerType)
+	{
+		Sphere::p = p;
+		Sphere::q = q;
+		Sphere::handlerType = handlerType;
+
+		// Two triangles per quad, 2q rows of p quads
+		const auto triangles = 4.0 * p * q;
+
+		// Fewer frames for the large meshes, so immediate mode stays within seconds
+		Offscreen::RunSettings settings;
+		settings.warmupFrames = 2;
+		settings.frames = std::clamp(static_cast<int>(4e6 / triangles), 3, 100);
+
+		const auto samples = Offscreen::run(*SceneRegistry::findScene("Sphere"), context, settings);
+		const auto summary = Benchmark::summarize("Sphere", samples);
+
+		return { p, q, Sphere::handlerTypes[handlerType].name, triangles, summary.cpuMs, summary.totalMs };
+	}
+
+	inline void run(const Offscreen::Context& context, std::ostream& os)
+	{
+		os << std::right << std::setw(12) << "slices" << std::setw(16) << "handler" << std::setw(12) << "submit ms"
+			<< std::setw(12) << "total ms" << std::setw(12) << "Mtri/s" << '\n';
+
+		os << std::fixed << std::setprecision(3);
+
+		const auto p = Sphere::p;
+		const auto q = Sphere::q;
+		const auto handlerType = Sphere::handlerType;
+
+		for(int slices = 8; slices <= 2048; slices *= 4)
+		{
+			for(int type{}; type < static_cast<int>(std::size(Sphere::handlerTypes)); ++type)
+			{
+				const auto r = measure(context, slices, slices / 2, type);
+				const auto size = std::to_string(r.p) + " x " + std::to_string(r.q);
+
+				os << std::setw(12) << size << std::setw(16) << r.handler << std::setw(12) << r.cpuMs.p50
+					<< std::setw(12) << r.totalMs.p50 << std::setw(12) << r.triangles / r.totalMs.p50 / 1000.0 << std::endl;
+			}
+		}
+
+		Sphere::p = p;
+		Sphere::q = q;
+		Sphere::handlerType = handlerType;
+	}
+}
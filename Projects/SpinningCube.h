@@ -1,10 +1,15 @@
+#pragma once
 #define _USE_MATH_DEFINES
 
 #include <GL/glew.h>
 #include <GL/freeglut.h> 
+#include "SceneRegistry.h"
+#include "Primitives.h"
+#include "SimdMath.h"
+#include "FrameClock.h"
 #include <iostream>
+#include <cmath>
 #include <vector>
-#include <chrono>
 
 namespace SpinningCube
 {
@@ -14,69 +19,9 @@ namespace SpinningCube
 	static int width = 500;
 	static int height = 500;
 
-	std::chrono::system_clock::time_point tp;
+	FrameClock::Stopwatch stopwatch;
 
-	struct Vector
-	{
-		Vector(float pX = 0.f, float pY = 0.f, float pZ = 0.f)
-			:
-			X{ pX },
-			Y{ pY },
-			Z{ pZ }
-		{
-
-		}
-
-		float length() const noexcept
-		{
-			return std::sqrt(X * X + Y * Y + Z * Z);
-		}
-
-		Vector& operator+=(const Vector& rhs) noexcept
-		{
-			return *this = *this + rhs;;
-		}
-
-		Vector& operator-=(const Vector& rhs) noexcept
-		{
-			return *this = *this - rhs;;
-		}
-
-		Vector operator+(const Vector& rhs) const noexcept
-		{
-			return { X + rhs.X, Y + rhs.Y, Z + rhs.Z };
-		}
-
-		Vector operator-(const Vector& rhs) const noexcept
-		{
-			return { X - rhs.X, Y - rhs.Y, Z - rhs.Z };
-		}
-
-		Vector operator*(float v) const noexcept
-		{
-			return { X * v, Y * v, Z * v };
-		}
-
-		Vector& operator*=(float v) noexcept
-		{
-			return *this = *this * v;
-		}
-
-		bool operator==(const Vector& rhs) const noexcept
-		{
-			return (X == rhs.X) && (Y == rhs.Y) && (Z == rhs.Z);
-		}
-
-		bool operator!=(const Vector& rhs) const noexcept
-		{
-			return !((*this) == rhs);
-		}
-
-		float X;
-		float Y;
-		float Z;
-
-	};
+	using Vector = SimdMath::Vec3;
 
 	static const Vector ZeroVector;
 
@@ -85,22 +30,6 @@ namespace SpinningCube
 		return (a - b) < e;
 	}
 
-	Vector normalize(const Vector& v)
-	{
-		return { v.X / v.length(), v.Y / v.length(), v.Z / v.length() };
-	}
-
-	Vector operator* (float lhs, const Vector& rhs)
-	{
-		return rhs * lhs;
-	}
-
-	std::ostream& operator<<(std::ostream& os, const Vector& v)
-	{
-		os << "X: " << v.X << " Y: " << v.Y << " Z: " << v.Z;
-		return os;
-	}
-
 	struct Rotation
 	{
 		Rotation(float pAngle = 0, const Vector& pDirs = Vector{})
@@ -219,9 +148,9 @@ namespace SpinningCube
 			glRotated(angle, -dir.Y, dir.X, dir.Z);
 
 			if (isWire)
-				glutWireCube(size);
+				Primitives::drawWireCube(size);
 			else
-				glutSolidCube(size);
+				Primitives::drawSolidCube(size);
 			
 			drawPoints();
 
@@ -244,14 +173,10 @@ namespace SpinningCube
 
 	void drawScene(void)
 	{
-		using namespace std::chrono;
-
 		glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 		glLoadIdentity();
 
-		auto d = duration_cast<milliseconds>(system_clock::now() - tp);
-		deltaTime = float(d.count()) * milliseconds::period::num / milliseconds::period::den;
-		tp = system_clock::now();
+		deltaTime = stopwatch.tick();
 
 		tick(deltaTime);
 		glutSwapBuffers();
@@ -267,7 +192,7 @@ namespace SpinningCube
 	{
 		glClearColor(0.0, 0.0, 0.0, 0.0);
 		glEnable(GL_DEPTH_TEST);
-		tp = std::chrono::system_clock::now();
+		stopwatch.reset();
 		animate(1);
 	}
 
@@ -352,4 +277,6 @@ namespace SpinningCube
 
 		return 0;
 	}
+
+	static SceneRegistry::Registrar registrar{ { "SpinningCube", main, setup, drawScene, resize, keyInput } };
 }
@@ -1,5 +1,9 @@
+#pragma once
 ///////////////////////////////////////////////////////         
 // This program make spiral band.
+//
+// Interaction:
+// Press o to toggle between the strip and a vertex cache optimized triangle list.
 ///////////////////////////////////////////////////////        
 
 #define _USE_MATH_DEFINES 
@@ -9,39 +13,38 @@
 #include <iostream>
 #include <GL/glew.h>
 #include <GL/freeglut.h>
+#include "SceneRegistry.h"
+#include "SimdMath.h"
+#include "ParametricSurface.h"
+#include "VertexCache.h"
 #include <vector>
 
 namespace SpiralBand
 {
 	static float Xangle = 50.f, Yangle = 0.f, Zangle = 0.f;
 	static float R = 20.f;
-	static std::vector<float> vertices;
-	static std::vector<unsigned int> indices;
+	static const int N = 400;
+	static ParametricSurface::Mesh mesh;
+	static bool isVertexCacheOptimized;
 
-	void fillVertices()
+	// One turn per 40 steps of the helix from -10pi to 10pi, row 1 is the lower edge
+	void fillMesh()
 	{
-		float t;
-		for (t = -10 * M_PI; t <= 10 * M_PI; t += M_PI / 20.0)
-		{
-			vertices.push_back(R * cos(t));
-			vertices.push_back(R * sin(t));
-			vertices.push_back(t - 60.0);
+		mesh = ParametricSurface::tessellate({ N, 1 }, [](int i, int j) {
+			const float t = -10 * M_PI + i * M_PI / 20.0;
 
-			vertices.push_back(R * cos(t));
-			vertices.push_back(R * sin(t));
-			vertices.push_back(t - 55.0);
-		}
+			return SimdMath::Vec3(R * cos(t), R * sin(t), t - (j == 0 ? 55.0 : 60.0));
+		});
+
+		if (isVertexCacheOptimized)
+			mesh = VertexCache::optimize(std::move(mesh));
+
+		glVertexPointer(3, GL_FLOAT, 0, mesh.positions.data());
 	}
 
-	void fillIndices()
+	void printVertexCacheStats()
 	{
-		float t;
-		int k;
-		for (k = 0,t = -10 * M_PI; t <= 10 * M_PI; t += M_PI / 20.0)
-		{
-			indices.push_back(++k);
-			indices.push_back(++k);
-		}
+		std::cout << (isVertexCacheOptimized ? "Optimized triangle list: " : "Strip: ") << VertexCache::getStats(mesh) << std::endl;
 	}
 
 	void drawScene(void)
@@ -58,17 +61,15 @@ namespace SpiralBand
 		glPolygonMode(GL_FRONT_AND_BACK, GL_LINE);
 		glColor3f(0.0, 0.0, 0.0);
 
-		glDrawElements(GL_TRIANGLE_STRIP, indices.size(), GL_UNSIGNED_INT, indices.data());
+		glDrawElements(isVertexCacheOptimized ? GL_TRIANGLES : GL_TRIANGLE_STRIP, mesh.indices.size(), GL_UNSIGNED_INT, mesh.indices.data());
 
 		glFlush();
 	}
 
 	void setup(void)
 	{
-		fillVertices();
-		fillIndices();
 		glEnableClientState(GL_VERTEX_ARRAY);
-		glVertexPointer(3, GL_FLOAT, 0, vertices.data());
+		fillMesh();
 		glClearColor(1.0, 1.0, 1.0, 0.0);
 	}
 
@@ -89,6 +90,12 @@ namespace SpiralBand
 		case 27:
 			exit(0);
 			break;
+		case 'o':
+			isVertexCacheOptimized = !isVertexCacheOptimized;
+			fillMesh();
+			printVertexCacheStats();
+			glutPostRedisplay();
+			break;
 		case 'x':
 			Xangle += 5.0;
 			if (Xangle > 360.0) Xangle -= 360.0;
@@ -124,8 +131,15 @@ namespace SpiralBand
 		}
 	}
 
+	void printInteraction(void)
+	{
+		std::cout << "Interaction:\n";
+		std::cout << "Press o to toggle between the strip and a vertex cache optimized triangle list" << std::endl;
+	}
+
 	int main(int argc, char** argv)
 	{
+		printInteraction();
 		glutInit(&argc, argv);
 
 		glutInitContextVersion(4, 3);
@@ -148,5 +162,7 @@ namespace SpiralBand
 
 		return 0;
 	}
+
+	static SceneRegistry::Registrar registrar{ { "SpiralBand", main, setup, drawScene, resize, keyInput } };
 }
 
@@ -0,0 +1,38 @@
+#pragma once
+///////////////////////////////////////////////////////////////////////////////////////
+// Draw tables of fixed-resolution meshes, built at compile time.
+//
+// Scenes whose slice counts are constants keep these tables as constexpr
+// variables. The tables are then baked into the binary instead of being filled at
+// setup, and every loop over them is specialized for its resolution.
+///////////////////////////////////////////////////////////////////////////////////////
+
+#include <GL/glew.h>
+
+namespace Tessellation
+{
+	// Count runs of Length vertices following each other in one vertex array,
+	// the firsts and counts of glMultiDrawArrays for equal fans and strips
+	template<int Count, int Length>
+	struct Runs
+	{
+		GLint firsts[Count];
+		GLsizei counts[Count];
+
+		static constexpr int vertexCount = Count * Length;
+	};
+
+	template<int Count, int Length>
+	constexpr Runs<Count, Length> makeRuns()
+	{
+		Runs<Count, Length> r{};
+
+		for(int i{}; i < Count; ++i)
+		{
+			r.firsts[i] = Length * i;
+			r.counts[i] = Length;
+		}
+
+		return r;
+	}
+}
@@ -1,3 +1,4 @@
+#pragma once
 ///////////////////////////////////////////////////////////////////////////////////////          
 //Affine Combinations test
 /////////////////////////////////////////////////////////////////////////////////////// 
@@ -9,6 +10,7 @@
 #include <iostream>
 #include <GL/glew.h>
 #include <GL/freeglut.h>
+#include "SceneRegistry.h"
 
 namespace AffineCombinations
 {
@@ -96,4 +98,5 @@ namespace AffineCombinations
 		return 0;
 	}
 
+	static SceneRegistry::Registrar registrar{ { "AffineCombinations", main, setup, drawScene, resize, keyInput } };
 }
@@ -1,5 +1,11 @@
+#pragma once
 ///////////////////////////////////////////////////////////////////////////////////////          
 //Usage of Cohen-Sazerland clip algorithm
+//
+// The lines are clipped all together by SegmentClip.
+//
+// Interaction:
+// Press k to switch between the Cohen-Sutherland and Liang-Barsky kernels.
 /////////////////////////////////////////////////////////////////////////////////////// 
 
 #define _USE_MATH_DEFINES 
@@ -10,6 +16,8 @@
 #include <random>
 #include <GL/glew.h>
 #include <GL/freeglut.h>
+#include "SceneRegistry.h"
+#include "SegmentClip.h"
 
 namespace TestCohenSazerland
 {
@@ -130,15 +138,45 @@ namespace TestCohenSazerland
 		return os;
 	}
 
-	using Line = std::pair<Vector, Vector>;
+	// Lines as a structure of arrays, the way SegmentClip takes them
+	struct Lines
+	{
+		void resize(std::size_t n)
+		{
+			x0.resize(n);
+			y0.resize(n);
+			x1.resize(n);
+			y1.resize(n);
+		}
+
+		std::size_t size() const noexcept
+		{
+			return x0.size();
+		}
+
+		SegmentClip::Segments get()
+		{
+			return { x0.data(), y0.data(), x1.data(), y1.data() };
+		}
+
+		std::vector<float> x0;
+		std::vector<float> y0;
+		std::vector<float> x1;
+		std::vector<float> y1;
+	};
 	
-	std::vector<Line> lines;
+	Lines lines;
+	Lines clippedLines;
+	std::vector<std::uint8_t> accepted;
+	SegmentClip::Kernel kernel = SegmentClip::Kernel::cohenSutherland;
 
 	void InitLines()
 	{
 		const auto randLines = 100;
 		
-		lines.reserve(randLines);
+		lines.resize(randLines);
+		clippedLines.resize(randLines);
+		accepted.resize(randLines);
 		
 		std::random_device dev;
 		std::mt19937 rng(dev());
@@ -147,8 +185,10 @@ namespace TestCohenSazerland
 
 		for(int i = 0; i < randLines; ++i)
 		{
-			const auto line = Line{ {distX(rng), distY(rng)}, {distX(rng), distY(rng)} };
-			lines.push_back(line);
+			lines.x0[i] = distX(rng);
+			lines.y0[i] = distY(rng);
+			lines.x1[i] = distX(rng);
+			lines.y1[i] = distY(rng);
 		}	
 	}
 
@@ -160,101 +200,6 @@ namespace TestCohenSazerland
                 glPointSize(4.0);
         }
 
-	struct CohenSazerland
-	{
-		static bool ClipSegment(Vector& v1, Vector& v2, const RealRect& pWindow)
-		{
-			window = pWindow;
-			return ClipSegmentImpl(v1, v2);
-		}
-
-	private:
-		enum LOCATIONS{LEFT = 8, TOP = 4, RIGHT = 2, BOTTOM = 1};
-
-		static bool IsOutside(const unsigned char code)
-		{
-			return code != 0;
-		}
-
-		static unsigned char GetCodesForPoint(const Vector& v)
-		{
-			unsigned char code{};
-			
-			if(v.X < window.l) code |= LEFT;
-			if(v.Y > window.t) code |= TOP;
-			if(v.X > window.r) code |= RIGHT;
-			if(v.Y < window.b) code |= BOTTOM;
-
-			return code;
-		}
-
-
-		static bool IsTrivialAccept(const unsigned char code1, const unsigned char code2)
-		{
-			return !(code1 | code2);
-		}
-
-		static bool IsTrivialReject(const unsigned char code1, const unsigned char code2)
-		{
-			return (code1 & code2);
-		}
-
-		static void ChopLine(Vector& v, unsigned char code, float delx, float dely)
-		{
-			if(code & LEFT)
-			{
-				v.Y += (window.l - v.X) * dely / delx;
-				v.X = window.l;
-			}
-			else if(code & RIGHT)
-			{
-				v.Y += (window.r - v.X) * dely / delx;
-				v.X = window.r;
-			}
-			else if(code & BOTTOM)
-			{
-				v.X += (window.b - v.Y) * delx / dely;
-				v.Y = window.b;
-			}
-			else if(code & TOP)
-			{
-				v.X += (window.t - v.Y) * delx / dely;
-				v.Y = window.t;
-			}
-		}
-
-		static bool IsPointInBounds(const Vector& v)
-		{
-			return ((v.X >= window.l) && (v.X <= window.r))
-				&&
-			       ((v.Y >= window.b) && (v.Y <= window.t));
-		}
-
-		static bool ClipSegmentImpl(Vector& v1, Vector& v2)
-		{
-			for(int i = 0; i < 4; ++i)
-			{
-				const auto code1 = GetCodesForPoint(v1);
-				const auto code2 = GetCodesForPoint(v2);
-				
-				if(IsTrivialAccept(code1, code2)) return true;
-				if(IsTrivialReject(code1, code2)) return false;
-			
-				const auto delx = v2.X - v1.X;
-				const auto dely = v2.Y - v1.Y;	
-
-				ChopLine(v1, code1, delx, dely);
-				ChopLine(v2, code2, delx, dely);
-			}
-
-			return IsPointInBounds(v1) && IsPointInBounds(v2);
-		}
-
-		static RealRect window;
-	};
-
-	RealRect CohenSazerland::window{};		
-
 	void DrawWindowBounds(const RealRect& window)
 	{
 		glBegin(GL_LINE_LOOP);
@@ -291,25 +236,22 @@ namespace TestCohenSazerland
 		glLineWidth(3.f);
 		DrawWindowBounds(window);
 
+		SegmentClip::clip(lines.get(), clippedLines.get(), lines.size(), { window.l, window.r, window.b, window.t }, kernel, accepted.data());
+
 		glLineWidth(1.f);
-		for(const auto& i : lines)
+		for(std::size_t i{}; i < lines.size(); ++i)
 		{
-			auto v1 = i.first;
-		      	auto v2 = i.second;	
-			
 			glBegin(GL_LINES);
 
 			glColor3f(0.f, 0.f, 1.f);
-				glVertex2f(v1.X, v1.Y);
-				glVertex2f(v2.X, v2.Y);	
+				glVertex2f(lines.x0[i], lines.y0[i]);
+				glVertex2f(lines.x1[i], lines.y1[i]);	
 			
-			const auto accepted = CohenSazerland::ClipSegment(v1, v2, window);
-			
-			if(accepted)
+			if(accepted[i])
 			{
 				glColor3f(1.f, 0.f, 0.f);
-					glVertex2f(v1.X, v1.Y);
-					glVertex2f(v2.X, v2.Y);
+					glVertex2f(clippedLines.x0[i], clippedLines.y0[i]);
+					glVertex2f(clippedLines.x1[i], clippedLines.y1[i]);
 			}
 
 			glEnd();
@@ -402,6 +344,11 @@ namespace TestCohenSazerland
 				rectSetter = RectangleSetter{};
 				glutPostRedisplay();
 				break;
+			case 'k':
+				kernel = kernel == SegmentClip::Kernel::cohenSutherland ? SegmentClip::Kernel::liangBarsky : SegmentClip::Kernel::cohenSutherland;
+				std::cout << (kernel == SegmentClip::Kernel::cohenSutherland ? "Cohen-Sutherland" : "Liang-Barsky") << " clipping" << std::endl;
+				glutPostRedisplay();
+				break;
 		}
 	}
 
@@ -445,7 +392,8 @@ namespace TestCohenSazerland
 		std::cout << "2. See test sample\n";
 		std::cout << "Actions: \n";
 		std::cout << "1. Press (R) to restart\n";
-		std::cout << "2. Quit with (ESC)\n";
+		std::cout << "2. Press (k) to switch between the Cohen-Sutherland and Liang-Barsky kernels\n";
+		std::cout << "3. Quit with (ESC)\n";
 	}
 
 	
@@ -477,4 +425,5 @@ namespace TestCohenSazerland
 		return 0;
 	}
 
+	static SceneRegistry::Registrar registrar{ { "TestCohenSazerland", main, setup, drawScene, resize, keyInput } };
 }
@@ -1,3 +1,4 @@
+#pragma once
 
 #define _USE_MATH_DEFINES
 
@@ -5,6 +6,7 @@
 #include <iostream>
 #include <GL/glew.h>
 #include <GL/freeglut.h> 
+#include "SceneRegistry.h"
 #include <vector>
 
 namespace ThreeLeggedStool
@@ -238,4 +240,6 @@ namespace ThreeLeggedStool
 
 		return 0;
 	}
+
+	static SceneRegistry::Registrar registrar{ { "ThreeLeggedStool", main, setup, drawScene, resize, keyInput } };
 }
\ No newline at end of file
@@ -1,6 +1,10 @@
+#pragma once
 #include <iostream>
 #include <GL/glew.h>
 #include <GL/freeglut.h> 
+#include "SceneRegistry.h"
+#include "Primitives.h"
+#include "TransformHierarchy.h"
 
 namespace TorusSatellites
 {
@@ -10,48 +14,61 @@ namespace TorusSatellites
 	static bool isAnimate;
 	static int animationPeriod = 100; // Time interval between frames.
 
+	using SimdMath::Mat4;
+	using TransformHierarchy::Node;
+
+	TransformHierarchy::Hierarchy hierarchy;
+
+	// The planet moves along the torus and the satellites orbit the planet
+	const Node torus = hierarchy.add();
+	const Node planet = hierarchy.add(torus);
+	const Node firstSatellite = hierarchy.add(planet);
+	const Node secondSatellite = hierarchy.add(planet);
+
+	void updateHierarchy()
+	{
+		hierarchy.setLocal(planet,
+			Mat4::rotation(longAngle, { 0.f, 0.f, 1.f }) *
+			Mat4::translation({ 12.f, 0.f, 0.f }) *
+			Mat4::rotation(latAngle, { 0.f, 1.f, 0.f }) *
+			Mat4::translation({ -12.f + 20.f, 0.f, 0.f }));
+
+		const auto satelliteRotation = Mat4::rotation(latAngle * 2.5f, { 0.f, 1.f, 0.f });
+
+		hierarchy.setLocal(firstSatellite,
+			satelliteRotation * Mat4::rotation(120.f, { 0.f, 1.f, 0.f }) * Mat4::translation({ 5.f, 0.f, 0.f }));
+		hierarchy.setLocal(secondSatellite,
+			satelliteRotation * Mat4::rotation(240.f, { 0.f, 1.f, 0.f }) * Mat4::translation({ 6.f, 0.f, 0.f }));
+
+		hierarchy.evaluate(
+			Mat4::translation({ 0.f, 0.f, -25.f }) *
+			Mat4::rotation(Zangle, { 0.f, 0.f, 1.f }) *
+			Mat4::rotation(Yangle, { 0.f, 1.f, 0.f }) *
+			Mat4::rotation(Xangle, { 1.f, 0.f, 0.f }));
+	}
+
 	// Drawing routine.
 	void drawScene(void)
 	{
 		glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-		glLoadIdentity();
-		glTranslatef(0.0, 0.0, -25.0);
 
-		glRotatef(Zangle, 0.0, 0.0, 1.0);
-		glRotatef(Yangle, 0.0, 1.0, 0.0);
-		glRotatef(Xangle, 1.0, 0.0, 0.0);
+		updateHierarchy();
 
+		hierarchy.load(torus);
 		glColor3f(0.0, 1.0, 0.0);
-		glutWireTorus(2.0, 12.0, 20, 20);
-
-		glRotatef(longAngle, 0.0, 0.0, 1.0);
-
-		glTranslatef(12.0, 0.0, 0.0);
-		glRotatef(latAngle, 0.0, 1.0, 0.0);
-		glTranslatef(-12.0, 0.0, 0.0);
-
-		glTranslatef(20.0, 0.0, 0.0);
+		Primitives::drawWireTorus(2.0, 12.0, 20, 20);
 
+		hierarchy.load(planet);
 		glColor3f(0.0, 0.0, 1.0);
-		glutWireSphere(2.0, 10, 10);
-
-		glPushMatrix();
-		glRotated(latAngle * 2.5f, 0.0, 1.0, 0.0);
-		glRotated(120, 0.0, 1.0, 0.0);
-		glTranslated(5.0, 0.0, 0.0);
+		Primitives::drawWireSphere(2.0, 10, 10);
 
+		hierarchy.load(firstSatellite);
 		glColor3f(1.0, 0.0, 0.0);
-		glutWireSphere(1.25, 10, 10);
-		glPopMatrix();
-
-		glPushMatrix();
-		glRotated(latAngle * 2.5f, 0.0, 1.0, 0.0);
-		glRotated(240, 0.0, 1.0, 0.0);
-		glTranslated(6.0, 0.0, 0.0);
+		Primitives::drawWireSphere(1.25, 10, 10);
 
+		hierarchy.load(secondSatellite);
 		glColor3f(0.0, 1.0, 0.0);
-		glutWireSphere(1.0, 10, 10);
-		glPopMatrix();
+		Primitives::drawWireSphere(1.0, 10, 10);
 
 		glutSwapBuffers();
 	}
@@ -176,4 +193,6 @@ namespace TorusSatellites
 		
 		return 0;
 	}
+
+	static SceneRegistry::Registrar registrar{ { "TorusSatellites", main, setup, drawScene, resize, keyInput } };
 }
\ No newline at end of file
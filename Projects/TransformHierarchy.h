@@ -0,0 +1,88 @@
+#pragma once
+///////////////////////////////////////////////////////////////////////////////////////
+// Transform hierarchies evaluated on the CPU instead of with glPushMatrix,
+// glRotate, glTranslate and glPopMatrix around every node.
+//
+// The nodes live in flat arrays with every parent before its children, so
+// evaluate() computes all the world matrices in one forward pass of SIMD matrix
+// products, and drawing a node costs a single glLoadMatrixf.
+///////////////////////////////////////////////////////////////////////////////////////
+
+#include <vector>
+#include <cassert>
+#include <GL/glew.h>
+#include "SimdMath.h"
+
+namespace TransformHierarchy
+{
+	using SimdMath::Mat4;
+
+	// Index of a node in its hierarchy
+	using Node = int;
+
+	// The parent of the top nodes, their world matrix is the root matrix times the local one
+	const Node noParent = -1;
+
+	struct Hierarchy
+	{
+		Node add(Node parent = noParent, const Mat4& local = Mat4::identity())
+		{
+			assert(parent < static_cast<Node>(parents.size()));
+
+			parents.push_back(parent);
+			locals.push_back(local);
+			worlds.push_back(local);
+
+			return static_cast<Node>(parents.size() - 1);
+		}
+
+		void setLocal(Node node, const Mat4& local)
+		{
+			locals[node] = local;
+		}
+
+		const Mat4& getLocal(Node node) const
+		{
+			return locals[node];
+		}
+
+		const Mat4& getWorld(Node node) const
+		{
+			return worlds[node];
+		}
+
+		// root is usually the view matrix, the world matrices are modelview matrices then
+		void evaluate(const Mat4& root)
+		{
+			for(std::size_t i{}; i < locals.size(); ++i)
+			{
+				const auto parent = parents[i];
+				worlds[i] = (parent == noParent ? root : worlds[parent]) * locals[i];
+			}
+		}
+
+		// Makes the world matrix of the node the current modelview matrix
+		void load(Node node) const
+		{
+			glLoadMatrixf(worlds[node].data());
+		}
+
+		std::size_t size() const noexcept
+		{
+			return parents.size();
+		}
+
+		void clear()
+		{
+			parents.clear();
+			locals.clear();
+			worlds.clear();
+		}
+
+	private:
+
+		std::vector<Node> parents;
+		std::vector<Mat4> locals;
+		std::vector<Mat4> worlds;
+	};
+}
@@ -1,77 +1,31 @@
+#pragma once
+///////////////////////////////////////////////////////////////////////////////////////
+// This program draws a mask triangulated into triangle fans
+//
+// Interaction:
+// Press space to toggle the wireframe.
+// Press +/- to grow or shrink the ears.
+///////////////////////////////////////////////////////////////////////////////////////
+
 #include <GL/glew.h>
 #include <GL/freeglut.h> 
+#include "SceneRegistry.h"
+#include "SimdMath.h"
+#include "ArcGenerator.h"
 #include <iostream>
 #include <vector>
 #include <cmath>
 #include <numeric>
+#include <algorithm>
 
 namespace TriangulateMask
 {
-	struct Vector
-	{
-	Vector(float pX = 0.f, float pY = 0.f, float pZ = 0.f)
-		:
-		X{ pX },
-		Y{ pY },
-		Z{ pZ }
-	{
-
-	}
-
-	float length() const noexcept
-	{
-		return std::sqrt(X * X + Y * Y + Z * Z);
-	}
-
-	Vector& operator+=(const Vector& rhs) noexcept
-	{
-		return *this = *this + rhs;;
-	}
-
-	Vector& operator-=(const Vector& rhs) noexcept
-	{
-		return *this = *this - rhs;;
-	}
-
-	Vector operator+(const Vector& rhs) const noexcept
-	{
-		return { X + rhs.X, Y + rhs.Y, Z + rhs.Z };
-	}
-
-	Vector operator-(const Vector& rhs) const noexcept
-	{
-		return { X - rhs.X, Y - rhs.Y, Z - rhs.Z };
-	}
-
-	Vector operator*(float v) const noexcept
-	{
-		return { X * v, Y * v, Z * v };
-	}
+	using Vector = SimdMath::Vec3;
 
-	bool operator==(const Vector& rhs) const noexcept
-	{
-		return (X == rhs.X) && (Y == rhs.Y) && (Z == rhs.Z);
-	}
-
-	bool operator!=(const Vector& rhs) const noexcept
-	{
-		return !(*this == rhs);
-	}
-
-		float X;
-		float Y;
-		float Z;
-	};
-
-
-	inline float dotProduct(const Vector& lhs, const Vector& rhs)
-	{
-		return lhs.X * rhs.X + lhs.Y * rhs.Y + lhs.Z * rhs.Z;
-	}
 
 	inline float getAngleBetweenVectors(const Vector& lhs, const Vector& rhs)
 	{
-	const auto scalarProduct = dotProduct(lhs, rhs);
+	const auto scalarProduct = dot(lhs, rhs);
 	const auto lengthsMult = lhs.length() * rhs.length();
 
 	return acosf(scalarProduct / lengthsMult) / M_PI * 180;
@@ -90,14 +44,26 @@ namespace TriangulateMask
 		foreheadStartAngle{ 2.f * (2.f * M_PI / faceAroundCircleLines) },
 		earR{7.f},
 		left{getLeftEyeLeftUp(), 10.f, getStartEarLeftPoint().Y - getEndEarLeftPoint().Y},
-		right{getRightEyeLeftUp(), 10.f, getStartEarRightPoint().Y - getEndEarRightPoint().Y}
+		right{getRightEyeLeftUp(), 10.f, getStartEarRightPoint().Y - getEndEarRightPoint().Y},
+		mesh{},
+		meshDirty{true}
 		{
 
 		}
 
 		void init()
 		{
+			glGenVertexArrays(1, &mesh.vertexArray);
+			glGenBuffers(1, &mesh.buffer);
+
+			glBindVertexArray(mesh.vertexArray);
+			glBindBuffer(GL_ARRAY_BUFFER, mesh.buffer);
 			glEnableClientState(GL_VERTEX_ARRAY);
+			glVertexPointer(3, GL_FLOAT, 0, 0);
+			glBindVertexArray(0);
+			glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+			buildMesh();
 		}
 
 		void drawVertices(const std::vector<Vector>& vertices)
@@ -163,24 +129,15 @@ namespace TriangulateMask
 
 		void draw()
 		{
+			if(meshDirty)
+				buildMesh();
+
 			glPolygonMode(GL_FRONT_AND_BACK, wireFrame ? GL_LINE : GL_FILL);
-			
-			std::vector<std::vector<Vector>> fillVertices{
-				fillForeheadVertices(),
-				fillLeftEarVertices(),
-				fillRightEarVertices(),
-				fillMiddleVertices()
-			};
 
-			const auto vertices = getFilledTriangleFanVertices(fillVertices);
-			const auto first = getFilledTriangleFanFirst(fillVertices);
-			const auto count = getFilledTriangleFanCount(fillVertices);
-			
 			glColor3f(0.f, 0.f, 0.f);
-			glVertexPointer(3, GL_FLOAT, 0.f, vertices.data());
-			glMultiDrawArrays(GL_TRIANGLE_FAN, first.data(), count.data(), fillVertices.size());
-
-			drawChinVertices();
+			glBindVertexArray(mesh.vertexArray);
+			glMultiDrawArrays(GL_TRIANGLE_FAN, mesh.firsts.data(), mesh.counts.data(), mesh.counts.size());
+			glBindVertexArray(0);
 		}
 
 		void toggleWireframeMode()
@@ -189,30 +146,76 @@ namespace TriangulateMask
 			glutPostRedisplay();
 		}
 
+		float getEarR() const noexcept
+		{
+			return earR;
+		}
+
+		// The setters of the shape only mark the mesh, it is rebuilt by the next draw
+		void setFaceR(float pFaceR)
+		{
+			faceR = pFaceR;
+			invalidateMesh();
+		}
+
+		void setEarR(float pEarR)
+		{
+			earR = pEarR;
+			invalidateMesh();
+		}
+
+		void setEyes(const Vector& leftEyeLeftUp, const Vector& rightEyeLeftUp, float width, float height)
+		{
+			left = { leftEyeLeftUp, width, height };
+			right = { rightEyeLeftUp, width, height };
+			invalidateMesh();
+		}
+
 	private:
 
-		std::vector<Vector> getArcPointsFromTo(const Vector& centerPoint, float startAngle, float endAngle, float R, int N) const
+		// All the parts as triangle fans in one vertex buffer
+		struct MaskMesh
 		{
-			std::vector<Vector> r;
-			r.reserve(N);
+			GLuint vertexArray;
+			GLuint buffer;
+			std::vector<GLint> firsts;
+			std::vector<GLsizei> counts;
+		};
 
-			float offset = startAngle;
-			float t;
-			float path = std::abs(endAngle - startAngle);
+		void invalidateMesh()
+		{
+			meshDirty = true;
+			glutPostRedisplay();
+		}
 
-			for(int i{}; i <= N; ++i)
-			{
-				t = offset - (path / N) * i;
+		void buildMesh()
+		{
+			std::vector<std::vector<Vector>> fillVertices{
+				fillForeheadVertices(),
+				fillLeftEarVertices(),
+				fillRightEarVertices(),
+				fillMiddleVertices()
+			};
 
-				Vector point{
-					centerPoint.X + R * cos(t),
-					centerPoint.Y + R * sin(t)
-				};
+			for(auto& fan : getChinFans())
+				fillVertices.push_back(std::move(fan));
 
-				r.push_back(point);
-			}
+			const auto vertices = getFilledTriangleFanVertices(fillVertices);
+			mesh.firsts = getFilledTriangleFanFirst(fillVertices);
+			mesh.counts = getFilledTriangleFanCount(fillVertices);
 
-			return r;
+			glBindBuffer(GL_ARRAY_BUFFER, mesh.buffer);
+			glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(float), vertices.data(), GL_STATIC_DRAW);
+			glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+			meshDirty = false;
+		}
+
+		// Always goes clockwise from startAngle
+		std::vector<Vector> getArcPointsFromTo(const Vector& centerPoint, float startAngle, float endAngle, float R, int N) const
+		{
+			const auto path = std::abs(endAngle - startAngle);
+			return ArcGenerator::getArcPoints({ centerPoint.X, centerPoint.Y }, R, startAngle, startAngle - path, N);
 		}
 
 		std::vector<Vector> getLeftCheekArcPoints() const 
@@ -258,13 +261,19 @@ namespace TriangulateMask
 			return r;
 		}
 
-		void drawChinVertices()
+		// The chin strip as a four-vertex fan per quad, the same triangles
+		// but drawn by the multi-draw of the other parts
+		std::vector<std::vector<Vector>> getChinFans()
 		{
-			const auto chinVertices = fillChinVertices();
-			
-			glColor3f(0.f, 0.f, 0.f);
-			glVertexPointer(3, GL_FLOAT, 0, chinVertices.data());
-			glDrawArrays(GL_TRIANGLE_STRIP, 0, chinVertices.size());
+			const auto strip = fillChinVertices();
+
+			std::vector<std::vector<Vector>> r;
+			r.reserve(strip.size() / 2);
+
+			for(std::size_t i{}; i + 3 < strip.size(); i += 2)
+				r.push_back({ strip[i + 1], strip[i], strip[i + 2], strip[i + 3] });
+
+			return r;
 		}
 
 		std::vector<Vector>  fillMiddleVertices()
@@ -583,6 +592,9 @@ namespace TriangulateMask
 
 		} left, right;
 
+		MaskMesh mesh;
+		bool meshDirty;
+
 	} mask;
 
 	void drawScene(void)
@@ -622,13 +634,27 @@ namespace TriangulateMask
 		case ' ':
 			mask.toggleWireframeMode();
 			break;
+		case '+':
+			mask.setEarR(std::min(mask.getEarR() + 0.5f, 10.f));
+			break;
+		case '-':
+			mask.setEarR(std::max(mask.getEarR() - 0.5f, 5.f));
+			break;
 		default:
 			break;
 		}
 	}
 
+	void printInteraction(void)
+	{
+		std::cout << "Interaction:\n";
+		std::cout << "Press space to toggle the wireframe" << std::endl;
+		std::cout << "Press +/- to grow or shrink the ears" << std::endl;
+	}
+
 	int main(int argc, char **argv)
 	{
+		printInteraction();
 		glutInit(&argc, argv);
 
 		glutInitContextVersion(4, 3);
@@ -652,4 +678,6 @@ namespace TriangulateMask
 
 		glutMainLoop();
 	}
+
+	static SceneRegistry::Registrar registrar{ { "TriangulateMask", main, setup, drawScene, resize, keyInput } };
 }
\ No newline at end of file
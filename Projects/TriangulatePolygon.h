@@ -0,0 +1,215 @@
+#pragma once
+/////////////////////////////////////////////////////////////////////
+// This program fills a wavy star with four holes through the polygon
+// triangulator and shows the triangles it made
+//
+// Interaction:
+// Press +/- to double/halve the vertices.
+// Press m to switch between automatic, ear clipping and sweep.
+// Press d to toggle the delaunay flips.
+// Press space to toggle the wireframe.
+/////////////////////////////////////////////////////////////////////
+
+#include <iostream>
+#include <vector>
+#include <GL/glew.h>
+#include <GL/freeglut.h>
+#include "SceneRegistry.h"
+#include "Triangulator.h"
+#include "TriangulatorBenchmark.h"
+
+namespace TriangulatePolygon
+{
+	using Triangulator::Method;
+
+	static std::size_t verticesN = 256;
+	static Method method = Method::automatic;
+	static bool delaunay = false;
+	static bool wireFrame = true;
+
+	static unsigned int vertexArray;
+	static unsigned int buffers[2];
+	static GLsizei indicesN;
+	static std::size_t meshVerticesN;
+	static bool meshDirty = true;
+
+	const char* getMethodName(Method m)
+	{
+		switch(m)
+		{
+		case Method::earClipping:
+			return "ear clipping";
+		case Method::sweep:
+			return "sweep";
+		default:
+			return "automatic";
+		}
+	}
+
+	// The triangulation only changes with the keys, so it is kept in buffers between frames
+	void buildMesh()
+	{
+		const auto shape = TriangulatorBenchmark::getTestShape(verticesN);
+		const auto vertices = Triangulator::getVertices(shape);
+		auto indices = Triangulator::triangulate(shape, method);
+
+		if(delaunay)
+			Triangulator::makeDelaunay(vertices, indices);
+
+		glBindBuffer(GL_ARRAY_BUFFER, buffers[0]);
+		glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(vertices[0]), vertices.data(), GL_STATIC_DRAW);
+		glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+		glBindVertexArray(vertexArray);
+		glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(indices[0]), indices.data(), GL_STATIC_DRAW);
+		glBindVertexArray(0);
+
+		indicesN = static_cast<GLsizei>(indices.size());
+		meshVerticesN = vertices.size();
+		meshDirty = false;
+	}
+
+	void printMesh()
+	{
+		std::cout << meshVerticesN << " vertices, " << indicesN / 3 << " triangles, "
+			<< getMethodName(method) << (delaunay ? " + delaunay" : "") << std::endl;
+	}
+
+	void drawScene(void)
+	{
+		if(meshDirty)
+			buildMesh();
+
+		glClear(GL_COLOR_BUFFER_BIT);
+
+		glBindVertexArray(vertexArray);
+
+		glColor3f(0.6f, 0.8f, 1.f);
+		glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
+		glDrawElements(GL_TRIANGLES, indicesN, GL_UNSIGNED_INT, 0);
+
+		if(wireFrame)
+		{
+			glColor3f(0.f, 0.f, 0.f);
+			glPolygonMode(GL_FRONT_AND_BACK, GL_LINE);
+			glDrawElements(GL_TRIANGLES, indicesN, GL_UNSIGNED_INT, 0);
+			glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
+		}
+
+		glBindVertexArray(0);
+
+		glFlush();
+	}
+
+	void setup(void)
+	{
+		glGenVertexArrays(1, &vertexArray);
+		glGenBuffers(2, buffers);
+
+		glBindVertexArray(vertexArray);
+		glBindBuffer(GL_ARRAY_BUFFER, buffers[0]);
+		glEnableClientState(GL_VERTEX_ARRAY);
+		glVertexPointer(3, GL_FLOAT, 0, 0);
+		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, buffers[1]);
+		glBindVertexArray(0);
+		glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+		meshDirty = true;
+
+		glClearColor(1.0, 1.0, 1.0, 0.0);
+	}
+
+	void resize(int w, int h)
+	{
+		glViewport(0, 0, w, h);
+		glMatrixMode(GL_PROJECTION);
+		glLoadIdentity();
+		glOrtho(-1.5, 1.5, -1.5, 1.5, -1.0, 1.0);
+		glMatrixMode(GL_MODELVIEW);
+		glLoadIdentity();
+	}
+
+	void keyInput(unsigned char key, int x, int y)
+	{
+		switch (key)
+		{
+		case 27:
+			exit(0);
+			break;
+		case '+':
+			// Ear clipping already takes most of a second up here
+			if(verticesN < 1 << 14)
+			{
+				verticesN *= 2;
+				meshDirty = true;
+			}
+			break;
+		case '-':
+			if(verticesN > 8)
+			{
+				verticesN /= 2;
+				meshDirty = true;
+			}
+			break;
+		case 'm':
+			method = method == Method::automatic ? Method::earClipping
+				: method == Method::earClipping ? Method::sweep : Method::automatic;
+			meshDirty = true;
+			break;
+		case 'd':
+			delaunay = !delaunay;
+			meshDirty = true;
+			break;
+		case ' ':
+			wireFrame = !wireFrame;
+			break;
+		default:
+			break;
+		}
+
+		if(meshDirty)
+		{
+			buildMesh();
+			printMesh();
+		}
+
+		glutPostRedisplay();
+	}
+
+	void printInteraction(void)
+	{
+		std::cout << "Interaction:" << std::endl;
+		std::cout << "Press +/- to double/halve the vertices.\n"
+			<< "Press m to switch between automatic, ear clipping and sweep.\n"
+			<< "Press d to toggle the delaunay flips.\n"
+			<< "Press space to toggle the wireframe." << std::endl;
+	}
+
+	int main(int argc, char** argv)
+	{
+		printInteraction();
+		glutInit(&argc, argv);
+
+		glutInitContextVersion(4, 3);
+		glutInitContextProfile(GLUT_COMPATIBILITY_PROFILE);
+
+		glutInitDisplayMode(GLUT_SINGLE | GLUT_RGBA);
+		glutInitWindowSize(500, 500);
+		glutInitWindowPosition(100, 100);
+		glutCreateWindow("TriangulatePolygon");
+		glutDisplayFunc(drawScene);
+		glutReshapeFunc(resize);
+		glutKeyboardFunc(keyInput);
+
+		glewExperimental = GL_TRUE;
+		glewInit();
+
+		setup();
+
+		glutMainLoop();
+
+		return 0;
+	}
+
+	static SceneRegistry::Registrar registrar{ { "TriangulatePolygon", main, setup, drawScene, resize, keyInput } };
+}
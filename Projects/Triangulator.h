@@ -0,0 +1,869 @@
+#pragma once
+///////////////////////////////////////////////////////////////////////////////////////
+// Triangulation of simple polygons with holes into indexed triangle lists.
+//
+// A shape is a list of rings: the first ring is the outline and the others are
+// holes, in any orientation. The indices refer to the vertices of all the rings
+// one after another, like getVertices() returns them, and every triangle is
+// counterclockwise.
+//
+// Ear clipping (holes bridged into the outline) is quadratic but has the least
+// setup, so it is used for small shapes. Larger ones go through a sweep that
+// splits the shape into y-monotone pieces and triangulates every piece in linear
+// time, O(n log n) overall. makeDelaunay() then flips the diagonals into the
+// constrained Delaunay triangulation, the one without thin slivers.
+///////////////////////////////////////////////////////////////////////////////////////
+
+#define _USE_MATH_DEFINES
+
+#include <set>
+#include <cmath>
+#include <vector>
+#include <cassert>
+#include <cstdint>
+#include <limits>
+#include <utility>
+#include <algorithm>
+#include "SimdMath.h"
+
+namespace Triangulator
+{
+	using SimdMath::Vec3;
+
+	// A closed outline of at least three vertices, only X and Y are used
+	using Ring = std::vector<Vec3>;
+
+	enum class Method
+	{
+		automatic,
+		earClipping,
+		sweep
+	};
+
+	// Shapes with more vertices are swept when the method is automatic
+	constexpr std::size_t earClippingLimit = 256;
+
+	inline std::vector<Vec3> getVertices(const std::vector<Ring>& rings)
+	{
+		std::vector<Vec3> r;
+
+		std::size_t verticesN{};
+		for(const auto& ring : rings)
+			verticesN += ring.size();
+
+		r.reserve(verticesN);
+		for(const auto& ring : rings)
+			r.insert(r.end(), ring.begin(), ring.end());
+
+		return r;
+	}
+
+	namespace Detail
+	{
+		// Twice the signed area of abc, positive when it turns counterclockwise
+		inline double orient(const Vec3& a, const Vec3& b, const Vec3& c)
+		{
+			return (static_cast<double>(b.X) - a.X) * (static_cast<double>(c.Y) - a.Y)
+				- (static_cast<double>(b.Y) - a.Y) * (static_cast<double>(c.X) - a.X);
+		}
+
+		// Sweep order, top to bottom and left to right on the same height
+		inline bool isAbove(const Vec3& a, const Vec3& b)
+		{
+			return a.Y > b.Y || (a.Y == b.Y && a.X < b.X);
+		}
+
+		inline void addTriangle(std::vector<unsigned int>& indices, const std::vector<Vec3>& points,
+			unsigned int a, unsigned int b, unsigned int c)
+		{
+			if(orient(points[a], points[b], points[c]) < 0.0)
+				std::swap(b, c);
+
+			indices.push_back(a);
+			indices.push_back(b);
+			indices.push_back(c);
+		}
+
+		// The rings linked so that the inside of the shape is on the left of every edge
+		struct Outline
+		{
+			std::vector<Vec3> points;
+			std::vector<unsigned int> next;
+			std::vector<unsigned int> prev;
+			// First vertex and size of every ring
+			std::vector<std::pair<unsigned int, unsigned int>> rings;
+		};
+
+		inline Outline makeOutline(const std::vector<Ring>& rings)
+		{
+			Outline r;
+			r.points = getVertices(rings);
+			r.next.resize(r.points.size());
+			r.prev.resize(r.points.size());
+
+			unsigned int first{};
+			for(std::size_t ringIndex{}; ringIndex < rings.size(); ++ringIndex)
+			{
+				const auto n = static_cast<unsigned int>(rings[ringIndex].size());
+				assert(n >= 3);
+
+				double area{};
+				for(unsigned int k{}; k < n; ++k)
+				{
+					const auto& a = r.points[first + k];
+					const auto& b = r.points[first + (k + 1) % n];
+					area += static_cast<double>(a.X) * b.Y - static_cast<double>(b.X) * a.Y;
+				}
+
+				// The outline goes counterclockwise and the holes clockwise
+				const bool reversed = (area > 0.0) != (ringIndex == 0);
+
+				for(unsigned int k{}; k < n; ++k)
+				{
+					auto& next = reversed ? r.prev : r.next;
+					auto& prev = reversed ? r.next : r.prev;
+
+					next[first + k] = first + (k + 1) % n;
+					prev[first + k] = first + (k + n - 1) % n;
+				}
+
+				r.rings.emplace_back(first, n);
+				first += n;
+			}
+
+			return r;
+		}
+
+		///////////////////////////////////////////////////////////////////////////////
+		// Ear clipping
+
+		// A doubly linked list of nodes over the outline, the holes are spliced into
+		// it with bridges, which repeat the two vertices they connect
+		struct EarList
+		{
+			std::vector<unsigned int> vertex;
+			std::vector<unsigned int> next;
+			std::vector<unsigned int> prev;
+
+			unsigned int duplicate(unsigned int node)
+			{
+				vertex.push_back(vertex[node]);
+				next.push_back(node);
+				prev.push_back(node);
+				return static_cast<unsigned int>(vertex.size() - 1);
+			}
+		};
+
+		// Whether the point is inside the angle of the shape at the node
+		inline bool isLocallyInside(const Outline& o, const EarList& l, unsigned int node, const Vec3& p)
+		{
+			const auto& a = o.points[l.vertex[l.prev[node]]];
+			const auto& b = o.points[l.vertex[node]];
+			const auto& c = o.points[l.vertex[l.next[node]]];
+
+			if(orient(a, b, c) >= 0.0)
+				return orient(a, b, p) >= 0.0 && orient(b, c, p) >= 0.0;
+
+			return orient(a, b, p) >= 0.0 || orient(b, c, p) >= 0.0;
+		}
+
+		inline bool isInTriangle(const Vec3& a, const Vec3& b, const Vec3& c, const Vec3& p)
+		{
+			return orient(a, b, p) >= 0.0 && orient(b, c, p) >= 0.0 && orient(c, a, p) >= 0.0;
+		}
+
+		// Eberly's bridge: the ray from the rightmost hole vertex to +X hits an edge,
+		// its right end is visible unless a reflex vertex hides it, then that vertex is
+		inline unsigned int findBridge(const Outline& o, const EarList& l, unsigned int start, const Vec3& m)
+		{
+			unsigned int hitEdge = start;
+			double hitX = std::numeric_limits<double>::infinity();
+			bool hit = false;
+
+			auto node = start;
+			do
+			{
+				const auto& a = o.points[l.vertex[node]];
+				const auto& b = o.points[l.vertex[l.next[node]]];
+
+				// Only edges going up face the hole from the right
+				if(a.Y <= m.Y && m.Y <= b.Y && a.Y != b.Y)
+				{
+					const auto x = a.X + (static_cast<double>(m.Y) - a.Y) * (static_cast<double>(b.X) - a.X) / (static_cast<double>(b.Y) - a.Y);
+
+					if(x >= m.X && x < hitX)
+					{
+						hitX = x;
+						hitEdge = node;
+						hit = true;
+					}
+				}
+
+				node = l.next[node];
+			} while(node != start);
+
+			if(!hit)
+				return start;
+
+			auto bridge = o.points[l.vertex[hitEdge]].X > o.points[l.vertex[l.next[hitEdge]]].X ? hitEdge : l.next[hitEdge];
+			const Vec3 hitPoint{ static_cast<float>(hitX), m.Y };
+			const auto bridgePoint = o.points[l.vertex[bridge]];
+
+			auto bestTangent = std::numeric_limits<double>::infinity();
+
+			node = start;
+			do
+			{
+				const auto& p = o.points[l.vertex[node]];
+
+				const bool inside = isInTriangle(m, hitPoint, bridgePoint, p) || isInTriangle(m, bridgePoint, hitPoint, p);
+
+				if(node != bridge && p.X > m.X && inside && isLocallyInside(o, l, node, m))
+				{
+					const auto tangent = std::abs(static_cast<double>(p.Y) - m.Y) / (static_cast<double>(p.X) - m.X);
+
+					if(tangent < bestTangent)
+					{
+						bestTangent = tangent;
+						bridge = node;
+					}
+				}
+
+				node = l.next[node];
+			} while(node != start);
+
+			// After earlier bridges the same vertex can be in the list twice,
+			// only one of the copies sees the hole
+			const auto bridgeVertex = l.vertex[bridge];
+			node = start;
+			do
+			{
+				if(l.vertex[node] == bridgeVertex && isLocallyInside(o, l, node, m))
+					return node;
+
+				node = l.next[node];
+			} while(node != start);
+
+			return bridge;
+		}
+
+		inline void spliceHole(EarList& l, unsigned int bridge, unsigned int holeNode)
+		{
+			const auto bridgeCopy = l.duplicate(bridge);
+			const auto holeCopy = l.duplicate(holeNode);
+
+			const auto bridgeNext = l.next[bridge];
+			const auto holePrev = l.prev[holeNode];
+
+			l.next[bridge] = holeNode;
+			l.prev[holeNode] = bridge;
+
+			l.next[holePrev] = holeCopy;
+			l.prev[holeCopy] = holePrev;
+
+			l.next[holeCopy] = bridgeCopy;
+			l.prev[bridgeCopy] = holeCopy;
+
+			l.next[bridgeCopy] = bridgeNext;
+			l.prev[bridgeNext] = bridgeCopy;
+		}
+
+		inline bool isEar(const Outline& o, const EarList& l, unsigned int ear)
+		{
+			const auto& a = o.points[l.vertex[l.prev[ear]]];
+			const auto& b = o.points[l.vertex[ear]];
+			const auto& c = o.points[l.vertex[l.next[ear]]];
+
+			if(orient(a, b, c) <= 0.0)
+				return false;
+
+			for(auto node = l.next[l.next[ear]]; node != l.prev[ear]; node = l.next[node])
+			{
+				const auto& p = o.points[l.vertex[node]];
+
+				// The copies a bridge leaves at the corners do not block the ear
+				if((p.X == a.X && p.Y == a.Y) || (p.X == b.X && p.Y == b.Y) || (p.X == c.X && p.Y == c.Y))
+					continue;
+
+				if(isInTriangle(a, b, c, p))
+				{
+					const auto& prev = o.points[l.vertex[l.prev[node]]];
+					const auto& next = o.points[l.vertex[l.next[node]]];
+
+					if(orient(prev, p, next) <= 0.0)
+						return false;
+				}
+			}
+
+			return true;
+		}
+
+		inline std::vector<unsigned int> clipEars(const Outline& o)
+		{
+			EarList l{ {}, o.next, o.prev };
+			l.vertex.resize(o.points.size());
+			for(unsigned int i{}; i < l.vertex.size(); ++i)
+				l.vertex[i] = i;
+
+			// Holes from right to left, so no bridge crosses a hole spliced before
+			std::vector<unsigned int> holes;
+			for(std::size_t i{ 1 }; i < o.rings.size(); ++i)
+			{
+				auto rightmost = o.rings[i].first;
+				for(auto v = o.rings[i].first; v < o.rings[i].first + o.rings[i].second; ++v)
+				{
+					if(o.points[v].X > o.points[rightmost].X)
+						rightmost = v;
+				}
+
+				holes.push_back(rightmost);
+			}
+
+			std::sort(holes.begin(), holes.end(), [&o](unsigned int lhs, unsigned int rhs) {
+				return o.points[lhs].X > o.points[rhs].X;
+			});
+
+			for(const auto hole : holes)
+				spliceHole(l, findBridge(o, l, 0, o.points[hole]), hole);
+
+			std::vector<unsigned int> indices;
+			indices.reserve((o.points.size() + 2 * holes.size()) * 3);
+
+			auto remaining = l.vertex.size();
+			unsigned int ear{};
+			auto stop = ear;
+			bool noEars = false;
+
+			while(remaining > 3)
+			{
+				const auto prev = l.prev[ear];
+				const auto next = l.next[ear];
+
+				// A whole round without an ear only happens on rounding trouble,
+				// clipping anyway still gives a triangle list of the right size
+				if(noEars || isEar(o, l, ear))
+				{
+					addTriangle(indices, o.points, l.vertex[prev], l.vertex[ear], l.vertex[next]);
+
+					l.next[prev] = next;
+					l.prev[next] = prev;
+					--remaining;
+
+					ear = next;
+					stop = next;
+					noEars = false;
+					continue;
+				}
+
+				ear = next;
+				noEars = ear == stop;
+			}
+
+			addTriangle(indices, o.points, l.vertex[l.prev[ear]], l.vertex[ear], l.vertex[l.next[ear]]);
+
+			return indices;
+		}
+
+		///////////////////////////////////////////////////////////////////////////////
+		// Monotone sweep
+
+		enum class VertexType
+		{
+			start,
+			end,
+			split,
+			merge,
+			regular
+		};
+
+		// Edge i goes from vertex i to next[i], edges in the sweep status are ordered
+		// by where they cross the sweep line
+		struct EdgeOrder
+		{
+			using is_transparent = void;
+
+			const Outline* outline;
+			const double* sweepY;
+
+			double getX(unsigned int edge) const
+			{
+				const auto& a = outline->points[edge];
+				const auto& b = outline->points[outline->next[edge]];
+
+				if(a.Y == b.Y)
+					return a.X;
+
+				return a.X + (*sweepY - a.Y) * (static_cast<double>(b.X) - a.X) / (static_cast<double>(b.Y) - a.Y);
+			}
+
+			bool operator()(unsigned int lhs, unsigned int rhs) const
+			{
+				const auto lhsX = getX(lhs);
+				const auto rhsX = getX(rhs);
+				return lhsX != rhsX ? lhsX < rhsX : lhs < rhs;
+			}
+
+			bool operator()(unsigned int lhs, double x) const
+			{
+				return getX(lhs) < x;
+			}
+
+			bool operator()(double x, unsigned int rhs) const
+			{
+				return x < getX(rhs);
+			}
+		};
+
+		inline VertexType getVertexType(const Outline& o, unsigned int v)
+		{
+			const auto& p = o.points[v];
+			const auto& prev = o.points[o.prev[v]];
+			const auto& next = o.points[o.next[v]];
+
+			const bool convex = orient(prev, p, next) > 0.0;
+
+			if(isAbove(p, prev) && isAbove(p, next))
+				return convex ? VertexType::start : VertexType::split;
+
+			if(isAbove(prev, p) && isAbove(next, p))
+				return convex ? VertexType::end : VertexType::merge;
+
+			return VertexType::regular;
+		}
+
+		// The diagonals that cut the shape into y-monotone pieces, de Berg et al. 3.2
+		inline std::vector<std::pair<unsigned int, unsigned int>> getMonotoneDiagonals(const Outline& o)
+		{
+			const auto n = static_cast<unsigned int>(o.points.size());
+
+			std::vector<unsigned int> events(n);
+			for(unsigned int i{}; i < n; ++i)
+				events[i] = i;
+
+			std::sort(events.begin(), events.end(), [&o](unsigned int lhs, unsigned int rhs) {
+				return isAbove(o.points[lhs], o.points[rhs]);
+			});
+
+			std::vector<VertexType> types(n);
+			for(unsigned int i{}; i < n; ++i)
+				types[i] = getVertexType(o, i);
+
+			double sweepY{};
+			using Status = std::set<unsigned int, EdgeOrder>;
+			Status status{ EdgeOrder{ &o, &sweepY } };
+			std::vector<Status::iterator> positions(n, status.end());
+			std::vector<unsigned int> helpers(n);
+			std::vector<std::pair<unsigned int, unsigned int>> diagonals;
+
+			const auto insert = [&](unsigned int edge, unsigned int helper) {
+				positions[edge] = status.insert(edge).first;
+				helpers[edge] = helper;
+			};
+
+			const auto remove = [&](unsigned int edge, unsigned int v) {
+				if(positions[edge] == status.end())
+					return;
+
+				if(types[helpers[edge]] == VertexType::merge)
+					diagonals.emplace_back(v, helpers[edge]);
+
+				status.erase(positions[edge]);
+				positions[edge] = status.end();
+			};
+
+			// The edge directly left of v gets v as its helper
+			const auto updateLeft = [&](unsigned int v, bool always) {
+				auto it = status.lower_bound(static_cast<double>(o.points[v].X));
+				if(it == status.begin())
+					return;
+
+				const auto edge = *--it;
+				if(always || types[helpers[edge]] == VertexType::merge)
+					diagonals.emplace_back(v, helpers[edge]);
+
+				helpers[edge] = v;
+			};
+
+			for(const auto v : events)
+			{
+				sweepY = o.points[v].Y;
+				const auto prevEdge = o.prev[v];
+
+				switch(types[v])
+				{
+				case VertexType::start:
+					insert(v, v);
+					break;
+				case VertexType::end:
+					remove(prevEdge, v);
+					break;
+				case VertexType::split:
+					updateLeft(v, true);
+					insert(v, v);
+					break;
+				case VertexType::merge:
+					remove(prevEdge, v);
+					updateLeft(v, false);
+					break;
+				case VertexType::regular:
+					// The inside is on the right when the outline goes down through v
+					if(isAbove(o.points[v], o.points[o.next[v]]))
+					{
+						remove(prevEdge, v);
+						insert(v, v);
+					}
+					else
+					{
+						updateLeft(v, false);
+					}
+					break;
+				}
+			}
+
+			return diagonals;
+		}
+
+		// Triangulates one y-monotone piece given counterclockwise, de Berg et al. 3.3
+		// chain and stack are scratch space kept between the pieces
+		inline void triangulateMonotone(const std::vector<Vec3>& points, const std::vector<unsigned int>& piece,
+			std::vector<std::pair<unsigned int, bool>>& chain, std::vector<std::size_t>& stack,
+			std::vector<unsigned int>& indices)
+		{
+			const auto k = piece.size();
+
+			if(k == 3)
+			{
+				addTriangle(indices, points, piece[0], piece[1], piece[2]);
+				return;
+			}
+
+			std::size_t top{};
+			std::size_t bottom{};
+			for(std::size_t i{ 1 }; i < k; ++i)
+			{
+				if(isAbove(points[piece[i]], points[piece[top]]))
+					top = i;
+				if(isAbove(points[piece[bottom]], points[piece[i]]))
+					bottom = i;
+			}
+
+			// Counterclockwise from the top vertex runs down the left chain
+			chain.clear();
+			for(auto i = top; ; i = (i + 1) % k)
+			{
+				chain.emplace_back(piece[i], true);
+				if(i == bottom)
+					break;
+			}
+			for(auto i = (bottom + 1) % k; i != top; i = (i + 1) % k)
+				chain.emplace_back(piece[i], false);
+
+			// Both chains are already sorted, so merging them would do, but the sort
+			// of a nearly sorted range costs little next to the sweep
+			std::sort(chain.begin(), chain.end(), [&points](const auto& lhs, const auto& rhs) {
+				return isAbove(points[lhs.first], points[rhs.first]);
+			});
+
+			stack.clear();
+			stack.push_back(0);
+			stack.push_back(1);
+
+			for(std::size_t j{ 2 }; j + 1 < k; ++j)
+			{
+				const auto u = chain[j].first;
+				const bool left = chain[j].second;
+
+				if(left != chain[stack.back()].second)
+				{
+					for(std::size_t s{}; s + 1 < stack.size(); ++s)
+						addTriangle(indices, points, u, chain[stack[s]].first, chain[stack[s + 1]].first);
+
+					const auto last = stack.back();
+					stack.clear();
+					stack.push_back(last);
+					stack.push_back(j);
+				}
+				else
+				{
+					auto last = stack.back();
+					stack.pop_back();
+
+					while(!stack.empty())
+					{
+						const auto& p = points[chain[stack.back()].first];
+						const auto turn = orient(p, points[chain[last].first], points[u]);
+
+						if(left ? turn <= 0.0 : turn >= 0.0)
+							break;
+
+						addTriangle(indices, points, u, chain[last].first, chain[stack.back()].first);
+						last = stack.back();
+						stack.pop_back();
+					}
+
+					stack.push_back(last);
+					stack.push_back(j);
+				}
+			}
+
+			const auto u = chain[k - 1].first;
+			for(std::size_t s{}; s + 1 < stack.size(); ++s)
+				addTriangle(indices, points, u, chain[stack[s]].first, chain[stack[s + 1]].first);
+		}
+
+		inline std::vector<unsigned int> sweep(const Outline& o)
+		{
+			const auto n = static_cast<unsigned int>(o.points.size());
+			const auto diagonals = getMonotoneDiagonals(o);
+
+			// Half-edges with the inside on their left: the outline edges once and
+			// the diagonals both ways, grouped by their start vertex
+			std::vector<unsigned int> firstOut(n + 1, 0);
+			for(unsigned int v{}; v < n; ++v)
+				++firstOut[v + 1];
+			for(const auto& d : diagonals)
+			{
+				++firstOut[d.first + 1];
+				++firstOut[d.second + 1];
+			}
+			for(unsigned int v{}; v < n; ++v)
+				firstOut[v + 1] += firstOut[v];
+
+			std::vector<unsigned int> targets(firstOut[n]);
+			std::vector<unsigned int> fill(firstOut.begin(), firstOut.end() - 1);
+			for(unsigned int v{}; v < n; ++v)
+				targets[fill[v]++] = o.next[v];
+			for(const auto& d : diagonals)
+			{
+				targets[fill[d.first]++] = d.second;
+				targets[fill[d.second]++] = d.first;
+			}
+
+			const auto getAngle = [&o](unsigned int from, unsigned int to) {
+				return std::atan2(static_cast<double>(o.points[to].Y) - o.points[from].Y, static_cast<double>(o.points[to].X) - o.points[from].X);
+			};
+
+			// Walking a piece: after a -> b take the first edge out of b clockwise from b -> a
+			const auto getNext = [&](unsigned int from, unsigned int halfEdge) {
+				const auto b = targets[halfEdge];
+				if(firstOut[b + 1] - firstOut[b] == 1)
+					return firstOut[b];
+
+				const auto back = getAngle(b, from);
+				auto best = firstOut[b];
+				auto bestDelta = 10.0;
+
+				for(auto e = firstOut[b]; e < firstOut[b + 1]; ++e)
+				{
+					auto delta = back - getAngle(b, targets[e]);
+					while(delta <= 0.0)
+						delta += 2.0 * M_PI;
+					while(delta > 2.0 * M_PI)
+						delta -= 2.0 * M_PI;
+
+					if(delta < bestDelta)
+					{
+						bestDelta = delta;
+						best = e;
+					}
+				}
+
+				return best;
+			};
+
+			std::vector<unsigned int> sources(targets.size());
+			for(unsigned int v{}; v < n; ++v)
+			{
+				for(auto e = firstOut[v]; e < firstOut[v + 1]; ++e)
+					sources[e] = v;
+			}
+
+			std::vector<unsigned int> indices;
+			indices.reserve((n + 2 * (o.rings.size() - 1)) * 3);
+
+			std::vector<char> visited(targets.size(), 0);
+			std::vector<unsigned int> piece;
+			std::vector<std::pair<unsigned int, bool>> chain;
+			std::vector<std::size_t> stack;
+
+			for(unsigned int start{}; start < targets.size(); ++start)
+			{
+				if(visited[start])
+					continue;
+
+				piece.clear();
+				auto e = start;
+				while(!visited[e])
+				{
+					visited[e] = 1;
+					piece.push_back(sources[e]);
+					e = getNext(sources[e], e);
+				}
+
+				if(piece.size() >= 3)
+					triangulateMonotone(o.points, piece, chain, stack, indices);
+			}
+
+			return indices;
+		}
+
+		///////////////////////////////////////////////////////////////////////////////
+		// Delaunay flips
+
+		// Positive when d is inside the circle through the counterclockwise abc
+		inline double inCircle(const Vec3& a, const Vec3& b, const Vec3& c, const Vec3& d, double& magnitude)
+		{
+			const double adx = static_cast<double>(a.X) - d.X, ady = static_cast<double>(a.Y) - d.Y;
+			const double bdx = static_cast<double>(b.X) - d.X, bdy = static_cast<double>(b.Y) - d.Y;
+			const double cdx = static_cast<double>(c.X) - d.X, cdy = static_cast<double>(c.Y) - d.Y;
+
+			const auto ad = adx * adx + ady * ady;
+			const auto bd = bdx * bdx + bdy * bdy;
+			const auto cd = cdx * cdx + cdy * cdy;
+
+			magnitude = ad * std::abs(bdx * cdy - bdy * cdx) + bd * std::abs(cdx * ady - cdy * adx) + cd * std::abs(adx * bdy - ady * bdx);
+
+			return ad * (bdx * cdy - bdy * cdx) + bd * (cdx * ady - cdy * adx) + cd * (adx * bdy - ady * bdx);
+		}
+	}
+
+	inline std::vector<unsigned int> triangulate(const std::vector<Ring>& rings, Method method = Method::automatic)
+	{
+		if(rings.empty())
+			return {};
+
+		const auto outline = Detail::makeOutline(rings);
+
+		if(method == Method::automatic)
+			method = outline.points.size() <= earClippingLimit ? Method::earClipping : Method::sweep;
+
+		return method == Method::earClipping ? Detail::clipEars(outline) : Detail::sweep(outline);
+	}
+
+	// Lawson flips until every diagonal is locally Delaunay, the outline edges stay
+	inline void makeDelaunay(const std::vector<Vec3>& vertices, std::vector<unsigned int>& indices)
+	{
+		const auto trianglesN = indices.size() / 3;
+
+		// Across edge k of triangle t, the edge from corner k to corner k + 1
+		std::vector<std::int64_t> neighbors(indices.size(), -1);
+		{
+			std::vector<std::pair<std::uint64_t, unsigned int>> edges;
+			edges.reserve(indices.size());
+
+			for(std::size_t i{}; i < indices.size(); ++i)
+			{
+				const std::uint64_t a = indices[i];
+				const std::uint64_t b = indices[i / 3 * 3 + (i + 1) % 3];
+				edges.emplace_back(std::min(a, b) << 32 | std::max(a, b), static_cast<unsigned int>(i));
+			}
+
+			std::sort(edges.begin(), edges.end());
+
+			for(std::size_t i{}; i + 1 < edges.size(); ++i)
+			{
+				if(edges[i].first == edges[i + 1].first)
+				{
+					neighbors[edges[i].second] = edges[i + 1].second / 3;
+					neighbors[edges[i + 1].second] = edges[i].second / 3;
+					++i;
+				}
+			}
+		}
+
+		std::vector<std::uint64_t> pending;
+		pending.reserve(indices.size());
+		for(std::size_t i{}; i < indices.size(); ++i)
+		{
+			if(neighbors[i] > static_cast<std::int64_t>(i / 3))
+				pending.push_back(i);
+		}
+
+		const auto corner = [&indices](std::size_t t, std::size_t k) -> unsigned int& {
+			return indices[t * 3 + k % 3];
+		};
+
+		// Lawson needs at most quadratic flips, more means cocircular points
+		// flipping back and forth on rounding
+		auto flipsLeft = trianglesN * trianglesN / 2 + 16;
+
+		while(!pending.empty() && flipsLeft > 0)
+		{
+			const auto edge = pending.back();
+			pending.pop_back();
+
+			const auto t = edge / 3;
+			const auto k = edge % 3;
+			const auto neighbor = neighbors[edge];
+			if(neighbor < 0)
+				continue;
+
+			const auto u = static_cast<std::size_t>(neighbor);
+			const auto a = corner(t, k);
+			const auto b = corner(t, k + 1);
+			const auto c = corner(t, k + 2);
+
+			std::size_t j{};
+			while(j < 3 && !(corner(u, j) == b && corner(u, j + 1) == a))
+				++j;
+			if(j == 3)
+				continue;
+
+			const auto d = corner(u, j + 2);
+
+			double magnitude{};
+			const auto circle = Detail::inCircle(vertices[a], vertices[b], vertices[c], vertices[d], magnitude);
+			if(circle <= 1e-12 * magnitude)
+				continue;
+
+			if(Detail::orient(vertices[a], vertices[d], vertices[c]) <= 0.0 || Detail::orient(vertices[d], vertices[b], vertices[c]) <= 0.0)
+				continue;
+
+			// abc + bad become adc + dbc
+			const auto tb = neighbors[t * 3 + (k + 1) % 3];
+			const auto tc = neighbors[t * 3 + (k + 2) % 3];
+			const auto ua = neighbors[u * 3 + (j + 1) % 3];
+			const auto ub = neighbors[u * 3 + (j + 2) % 3];
+
+			indices[t * 3] = a;
+			indices[t * 3 + 1] = d;
+			indices[t * 3 + 2] = c;
+			neighbors[t * 3] = ua;
+			neighbors[t * 3 + 1] = static_cast<std::int64_t>(u);
+			neighbors[t * 3 + 2] = tc;
+
+			indices[u * 3] = d;
+			indices[u * 3 + 1] = b;
+			indices[u * 3 + 2] = c;
+			neighbors[u * 3] = ub;
+			neighbors[u * 3 + 1] = tb;
+			neighbors[u * 3 + 2] = static_cast<std::int64_t>(t);
+
+			// The triangles across the moved edges now see the other one
+			const auto relink = [&](std::int64_t other, std::size_t from, std::size_t to) {
+				if(other < 0)
+					return;
+
+				for(std::size_t i{}; i < 3; ++i)
+				{
+					if(neighbors[other * 3 + i] == static_cast<std::int64_t>(from))
+						neighbors[other * 3 + i] = static_cast<std::int64_t>(to);
+				}
+			};
+
+			relink(ua, u, t);
+			relink(tb, t, u);
+
+			pending.push_back(t * 3);
+			pending.push_back(t * 3 + 2);
+			pending.push_back(u * 3);
+			pending.push_back(u * 3 + 1);
+			--flipsLeft;
+		}
+	}
+
+	inline void makeDelaunay(const std::vector<Ring>& rings, std::vector<unsigned int>& indices)
+	{
+		makeDelaunay(getVertices(rings), indices);
+	}
+}
@@ -0,0 +1,134 @@
+#pragma once
+///////////////////////////////////////////////////////////////////////////////////////
+// Timing of the polygon triangulator on shapes from 10 to 1,000,000 vertices,
+// printed by the headless launcher with --triangulation.
+//
+// The test shape is a wavy star with four round holes once it is large enough.
+// Its vertices are noisy but deterministic, so runs can be compared.
+///////////////////////////////////////////////////////////////////////////////////////
+
+#define _USE_MATH_DEFINES
+
+#include <cmath>
+#include <chrono>
+#include <string>
+#include <vector>
+#include <ostream>
+#include <iomanip>
+#include "Benchmark.h"
+#include "Triangulator.h"
+
+namespace TriangulatorBenchmark
+{
+	using Triangulator::Ring;
+	using Triangulator::Method;
+
+	// Every ring stays star-shaped around its center, so the shape is always simple
+	inline std::vector<Triangulator::Ring> getTestShape(std::size_t verticesN)
+	{
+		const auto getNoise = [](std::size_t i) {
+			return static_cast<float>(std::sin(i * 12.9898) * 0.02);
+		};
+
+		const std::size_t holeN = verticesN >= 64 ? verticesN / 8 : 0;
+		const auto outlineN = verticesN - 4 * holeN;
+
+		std::vector<Ring> r(1);
+		r[0].reserve(outlineN);
+
+		for(std::size_t i{}; i < outlineN; ++i)
+		{
+			const auto t = 2 * M_PI * i / outlineN;
+			const auto R = 1.f + 0.3f * static_cast<float>(std::sin(7 * t)) + getNoise(i);
+			r[0].emplace_back(R * static_cast<float>(std::cos(t)), R * static_cast<float>(std::sin(t)), 0.f);
+		}
+
+		if(holeN == 0)
+			return r;
+
+		const float centers[4][2]{ { 0.35f, 0.35f }, { -0.35f, 0.35f }, { -0.35f, -0.35f }, { 0.35f, -0.35f } };
+
+		for(const auto& center : centers)
+		{
+			Ring hole;
+			hole.reserve(holeN);
+
+			for(std::size_t i{}; i < holeN; ++i)
+			{
+				const auto t = 2 * M_PI * i / holeN;
+				const auto R = 0.1f + getNoise(i + outlineN) * 0.5f;
+				hole.emplace_back(center[0] + R * static_cast<float>(std::cos(t)), center[1] + R * static_cast<float>(std::sin(t)), 0.f);
+			}
+
+			r.push_back(std::move(hole));
+		}
+
+		return r;
+	}
+
+	struct Result
+	{
+		std::size_t vertices;
+		std::string method;
+		std::size_t triangles;
+		Benchmark::Percentiles ms;
+	};
+
+	template<typename Triangulate>
+	Result measure(std::size_t verticesN, const std::string& method, Triangulate triangulate)
+	{
+		const auto shape = getTestShape(verticesN);
+
+		std::vector<double> times;
+		std::size_t trianglesN{};
+		double totalMs{};
+
+		// At least three runs, then more while they fit in about a second
+		while(times.size() < 3 || (totalMs < 1000.0 && times.size() < 200))
+		{
+			const auto start = std::chrono::steady_clock::now();
+			const auto indices = triangulate(shape);
+			const auto end = std::chrono::steady_clock::now();
+
+			times.push_back(std::chrono::duration<double, std::milli>(end - start).count());
+			totalMs += times.back();
+			trianglesN = indices.size() / 3;
+		}
+
+		return { verticesN, method, trianglesN, Benchmark::getPercentiles(std::move(times)) };
+	}
+
+	inline void run(std::ostream& os)
+	{
+		os << std::right << std::setw(10) << "vertices" << std::setw(16) << "method" << std::setw(12) << "triangles"
+			<< std::setw(12) << "p50 ms" << std::setw(12) << "max ms" << '\n';
+
+		os << std::fixed << std::setprecision(3);
+
+		const auto print = [&os](const Result& r) {
+			os << std::setw(10) << r.vertices << std::setw(16) << r.method << std::setw(12) << r.triangles
+				<< std::setw(12) << r.ms.p50 << std::setw(12) << r.ms.max << std::endl;
+		};
+
+		for(std::size_t verticesN{ 10 }; verticesN <= 1000000; verticesN *= 10)
+		{
+			// Ear clipping is quadratic, past 10k vertices a run takes seconds
+			if(verticesN <= 10000)
+			{
+				print(measure(verticesN, "ear clipping", [](const std::vector<Ring>& shape) {
+					return Triangulator::triangulate(shape, Method::earClipping);
+				}));
+			}
+
+			print(measure(verticesN, "sweep", [](const std::vector<Ring>& shape) {
+				return Triangulator::triangulate(shape, Method::sweep);
+			}));
+
+			print(measure(verticesN, "sweep+delaunay", [](const std::vector<Ring>& shape) {
+				auto indices = Triangulator::triangulate(shape, Method::sweep);
+				Triangulator::makeDelaunay(shape, indices);
+				return indices;
+			}));
+		}
+	}
+}
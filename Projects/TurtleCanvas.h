@@ -1,14 +1,29 @@
+#pragma once
 ///////////////////////////////////////////////////////////////////////////////////////          
 //Example of turtle graphics
+//
+// The drawings are recorded into turtle programs and replayed from their segments,
+// the L-system curves are expanded while they are drawn, on several threads.
+//
+// Interaction:
+// Press n to draw the next turtle drawing.
+// Press + and - to change the generation of the L-system curves.
 /////////////////////////////////////////////////////////////////////////////////////// 
 
 #define _USE_MATH_DEFINES 
 
 #include <cmath>
+#include <tuple>
+#include <algorithm>
 #include <vector>
+#include <iterator>
 #include <iostream>
 #include <GL/glew.h>
 #include <GL/freeglut.h>
+#include "SceneRegistry.h"
+#include "LineBatch.h"
+#include "TurtleProgram.h"
+#include "LSystem.h"
 
 namespace TurtleCanvas
 {
@@ -71,6 +86,8 @@ namespace TurtleCanvas
 	using FloatRect = Rect<float>;
 
 	void Display();
+	void NextDrawing();
+	void ChangeGenerations(int change);
 
 	struct Canvas
 	{
@@ -92,6 +109,18 @@ namespace TurtleCanvas
 				case 27:
 					exit(0);
 					break;	
+				case 'n':
+					NextDrawing();
+					glutPostRedisplay();
+					break;
+				case '+':
+					ChangeGenerations(1);
+					glutPostRedisplay();
+					break;
+				case '-':
+					ChangeGenerations(-1);
+					glutPostRedisplay();
+					break;
 			}
 		}
 
@@ -126,6 +155,14 @@ namespace TurtleCanvas
 			glewExperimental = GL_TRUE;
 			glewInit();
 
+			Setup(width, height);
+		}
+
+		void Setup(int pWidth, int pHeight)
+		{
+			width = pWidth;
+			height = pHeight;
+
 			SetWindow(0.f, width, 0.f, height);
 			SetViewport(0.f, width, 0.f, height);
 			CP.Set(0.f, 0.f);
@@ -133,6 +170,7 @@ namespace TurtleCanvas
 		
 		void SetWindow(float l, float r, float b, float t)
 		{
+			lines.flush();
 			glMatrixMode(GL_PROJECTION);
 			glLoadIdentity();
 			gluOrtho2D(l, r, b, t);
@@ -141,6 +179,7 @@ namespace TurtleCanvas
 
 		void SetViewport(int l, int r, int b, int t)
 		{
+			lines.flush();
 			viewport.Set(l, r, b, t);
 			glViewport(l, b, r - l, t - b);
 		}
@@ -165,6 +204,8 @@ namespace TurtleCanvas
 
 		void ClearScreen()
 		{
+			// The segments not drawn yet would be cleared anyway
+			lines.clear();
 			glClear(GL_COLOR_BUFFER_BIT);
 		}
 
@@ -176,18 +217,19 @@ namespace TurtleCanvas
 		void SetColor(float r, float g, float b)
 		{
 			glColor3f(r, g, b);
+			lines.setColor(r, g, b);
 		}
 
 		void LineTo(float x, float y)
 		{
-			glBegin(GL_LINES);
-				glVertex2f(CP.X, CP.Y);
-				glVertex2f(x, y);
-			glEnd();
+			if(recording)
+			{
+				recording->add(TurtleProgram::Op::LINE_TO, x, y);
+				return;
+			}
 
+			lines.add(CP.X, CP.Y, x, y);
 			CP.Set(x, y);
-
-			glFlush();
 		}
 
 		void LineTo(const Point2& p)
@@ -195,23 +237,48 @@ namespace TurtleCanvas
 			LineTo(p.X, p.Y);
 		}		
 
+		// Draws the segments added since the last call
+		void Flush()
+		{
+			lines.flush();
+			glFlush();
+		}
+
 		void MoveTo(float x, float y)
 		{
+			if(recording)
+			{
+				recording->add(TurtleProgram::Op::MOVE_TO, x, y);
+				return;
+			}
+
 			CP.Set(x, y);
 		}
 
 		void MoveTo(const Point2& p)
 		{
-			CP = p;
+			MoveTo(p.X, p.Y);
 		}
 
 		void MoveRel(float dx, float dy)
 		{
+			if(recording)
+			{
+				recording->add(TurtleProgram::Op::MOVE_REL, dx, dy);
+				return;
+			}
+
 			CP.Set(CP.X + dx, CP.Y + dy);
 		}
 
 		void LineRel(float dx, float dy)
 		{
+			if(recording)
+			{
+				recording->add(TurtleProgram::Op::LINE_REL, dx, dy);
+				return;
+			}
+
 			float X = CP.X + dx;
 			float Y = CP.Y + dy;
 			
@@ -230,28 +297,111 @@ namespace TurtleCanvas
 
 		void TurnTo(float angle)
 		{
+			if(recording)
+			{
+				recording->add(TurtleProgram::Op::TURN_TO, angle);
+				return;
+			}
+
 			CD = angle;
 		}
 
 		void Turn(float angle)
 		{
+			if(recording)
+			{
+				recording->add(TurtleProgram::Op::TURN, angle);
+				return;
+			}
+
 			CD += angle;
 		}
 
 		void Forward(float dist, bool isVisible)
 		{
-			const float RadPerDeg = 0.017453393;
-			float X = CP.X + dist * cos(RadPerDeg * CD);
-			float Y = CP.Y + dist * sin(RadPerDeg * CD);
+			if(recording)
+			{
+				recording->add(isVisible ? TurtleProgram::Op::FORWARD : TurtleProgram::Op::SKIP, dist);
+				return;
+			}
+
+			const auto next = TurtleProgram::advance(GetState(), dist);
 
 			if(isVisible)
 			{
-				LineTo(X, Y);
+				LineTo(next.X, next.Y);
 			}
 			else
 			{
-				MoveTo(X, Y);
+				MoveTo(next.X, next.Y);
+			}
+		}
+
+		void Push()
+		{
+			if(recording)
+			{
+				recording->add(TurtleProgram::Op::PUSH);
+				return;
+			}
+
+			saved.push_back(GetState());
+		}
+
+		// A Pop with nothing pushed leaves the turtle where it is
+		void Pop()
+		{
+			if(recording)
+			{
+				recording->add(TurtleProgram::Op::POP);
+				return;
+			}
+
+			if(saved.empty())
+				return;
+
+			CP.Set(saved.back().X, saved.back().Y);
+			CD = saved.back().CD;
+			saved.pop_back();
+		}
+
+		// The pen commands go to program instead of the screen until StopRecording
+		void Record(TurtleProgram::Program& program)
+		{
+			recording = &program;
+		}
+
+		void StopRecording()
+		{
+			recording = nullptr;
+		}
+
+		TurtleProgram::State GetState() const noexcept
+		{
+			return { CP.X, CP.Y, CD };
+		}
+
+		// Draws segments evaluated before and leaves the turtle at end
+		void Replay(const std::vector<TurtleProgram::Segment>& segments, const TurtleProgram::State& end)
+		{
+			for(const auto& segment : segments)
+			{
+				lines.add(segment.X0, segment.Y0, segment.X1, segment.Y1);
 			}
+
+			CP.Set(end.X, end.Y);
+			CD = end.CD;
+		}
+
+		// Draws segments right away, so they need not be kept until Flush
+		void DrawSegments(const std::vector<TurtleProgram::Segment>& segments)
+		{
+			for(const auto& segment : segments)
+			{
+				lines.add(segment.X0, segment.Y0, segment.X1, segment.Y1);
+			}
+
+			lines.flush();
 		}
 		
 		private:
@@ -261,6 +411,9 @@ namespace TurtleCanvas
 		Point2 CP;
 		IntRect viewport;
 		FloatRect window;
+		LineBatch::Batch lines;
+		TurtleProgram::Program* recording = nullptr;
+		std::vector<TurtleProgram::State> saved;
 		
 		float width;
 		float height;
@@ -426,27 +579,23 @@ namespace TurtleCanvas
 		}
 	}
 
-	void TurtleDrawWithString(Canvas& cvs, float length = 60.f, const std::string& str = "FLFLFLFRFLFLFLFRFLFLFLFR")
+	// Draws what the axiom of grammar becomes after the given generations, the string is expanded while it is read
+	void TurtleDrawWithString(Canvas& cvs, const LSystem::Grammar& grammar, int generations, float length)
 	{
 		cvs.MoveTo(cvs.GetScreenWidth() / 2, cvs.GetScreenHeight() / 2);
 
-		for(const auto i : str)
+		LSystem::Stream stream{ grammar, generations };
+		for(char symbol; stream.next(symbol);)
 		{
-			if(i == 'F')
-			{
-				cvs.Forward(length, true);
-			}
-			else if(i == 'L')
-			{
-				cvs.Turn(60);
-			}
-			else if(i == 'R')
-			{
-				cvs.Turn(-60);
-			}
+			LSystem::interpret(symbol, grammar.getAngle(), length, cvs);
 		}
 	}
 
+	void TurtleDrawWithString(Canvas& cvs, float length = 60.f, const std::string& str = "FLFLFLFRFLFLFLFRFLFLFLFR")
+	{
+		TurtleDrawWithString(cvs, LSystem::Grammar{ str, {}, 60.f }, 0, length);
+	}
+
 	void SimpleMotifMeandr(Canvas& cvs, float length)
 	{
 		cvs.Forward(length, true);
@@ -709,23 +858,125 @@ namespace TurtleCanvas
 		}
 	}
 	
+	// An L-system drawn with a step that keeps it the same size at every generation
+	struct Curve
+	{
+		LSystem::Grammar grammar;
+		int generations;
+		int maxGenerations;
+		// The step is multiplied by shrink with every generation
+		float shrink;
+		// The step at generation 0 as a part of the shorter side of the screen
+		float size;
+		// Where the curve starts as parts of the screen, and its first direction
+		float X;
+		float Y;
+		float CD;
+	};
+
+	static Curve dragon{ { "FX", { { 'X', "X+YF+" }, { 'Y', "-FX-Y" } }, 90.f }, 14, 22, 0.70710678f, 0.55f, 0.57f, 0.73f, 0.f };
+	static Curve koch{ { "F", { { 'F', "F+F--F+F" } }, 60.f }, 7, 12, 1.f / 3, 1.2f, 0.05f, 0.3f, 0.f };
+	static Curve hilbert{ { "A", { { 'A', "+BF-AFA-FB+" }, { 'B', "-AF+BFB+FA-" } }, 90.f }, 6, 11, 0.5f, 0.9f, 0.1625f, 0.05f, 0.f };
+	static Curve plant{ { "X", { { 'X', "F+[[X]-X]-F[-FX]+X" }, { 'F', "FF" } }, 25.f }, 6, 11, 0.5f, 0.45f, 0.2f, 0.02f, 65.f };
+
+	// Curves are generated on several threads and drawn in batches, they are too large to record
+	void DrawCurve(Canvas& cvs, const Curve& curve)
+	{
+		const auto side = std::min(cvs.GetScreenWidth(), cvs.GetScreenHeight());
+		const TurtleProgram::State start{ curve.X * cvs.GetScreenWidth(), curve.Y * cvs.GetScreenHeight(), curve.CD };
+		const auto length = curve.size * side * std::pow(curve.shrink, curve.generations);
+
+		LSystem::generate(curve.grammar, curve.generations, start, length, [&cvs](const std::vector<TurtleProgram::Segment>& segments) {
+			cvs.DrawSegments(segments);
+		});
+	}
+
+	struct Drawing
+	{
+		const char* name;
+		void (*draw)(Canvas&);
+		Curve* curve = nullptr;
+	};
+
+	static const Drawing drawings[] =
+	{
+		{ "polyspiral", DrawPolyspiralARecursive },
+		{ "polyspiral B", DrawPolyspiralB },
+		{ "polyspiral C", DrawPolyspiralC },
+		{ "polyspiral D", DrawPolyspiralD },
+		{ "hook", HookDraw },
+		{ "square in squares", [](Canvas& cvs) { SquareInSquares(cvs); } },
+		{ "triangle in triangles", [](Canvas& cvs) { TriangleInTriangles(cvs); } },
+		{ "famous logo", [](Canvas& cvs) { FamousLogo(cvs); } },
+		{ "string", [](Canvas& cvs) { TurtleDrawWithString(cvs); } },
+		{ "simple meander", [](Canvas& cvs) { SimpleMeandr(cvs); } },
+		{ "T meander", [](Canvas& cvs) { TMeandr(cvs); } },
+		{ "Y meander", [](Canvas& cvs) { YMeandr(cvs); } },
+		{ "tough meander 1", [](Canvas& cvs) { ToughMeandr1(cvs); } },
+		{ "tough meander 2", [](Canvas& cvs) { ToughMeandr2(cvs); } },
+		{ "tough meander 3", [](Canvas& cvs) { ToughMeandr3(cvs); } },
+		{ "dragon curve", nullptr, &dragon },
+		{ "Koch curve", nullptr, &koch },
+		{ "Hilbert curve", nullptr, &hilbert },
+		{ "fractal plant", nullptr, &plant },
+	};
+
+	static int drawing = 0;
+
+	// The drawing is recorded once and its segments replayed until the drawing or the screen size changes
+	static TurtleProgram::Replay<Canvas, std::tuple<int, float, float>> replay;
+
+	void NextDrawing()
+	{
+		drawing = (drawing + 1) % std::size(drawings);
+		std::cout << "Drawing the " << drawings[drawing].name << std::endl;
+	}
+
+	void ChangeGenerations(int change)
+	{
+		auto* curve = drawings[drawing].curve;
+		if(!curve)
+			return;
+
+		curve->generations = std::clamp(curve->generations + change, 0, curve->maxGenerations);
+		std::cout << "Generation " << curve->generations << ", " << LSystem::getSegmentsN(curve->grammar, curve->generations) << " segments" << std::endl;
+	}
+
 	void Display()
 	{
 		auto& cvs = Canvas::Get();
 		cvs.ClearScreen();
 		cvs.SetColor(0.f, 0.f, 0.f);
 		
-		DrawPolyspiralARecursive(cvs);	
+		if(drawings[drawing].curve)
+		{
+			DrawCurve(cvs, *drawings[drawing].curve);
+		}
+		else
+		{
+			replay.draw(cvs, { drawing, cvs.GetScreenWidth(), cvs.GetScreenHeight() }, drawings[drawing].draw);
+		}
+
+		cvs.Flush();
 	}
 
 
 
 	void printInteraction()
 	{
-
+		std::cout << "Interaction:\n";
+		std::cout << "Press n to draw the next turtle drawing" << std::endl;
+		std::cout << "Press + and - to change the generation of the L-system curves" << std::endl;
 	}
 
 	
+	void setup()
+	{
+		auto& cvs = Canvas::Get();
+		cvs.Setup(640, 480);
+		cvs.SetBackgroundColor(1.f, 1.f, 1.f);
+	}
+
 	int main(int argc, char** argv)
 	{
 		printInteraction();
@@ -740,4 +991,5 @@ namespace TurtleCanvas
 		return 0;
 	}
 
+	static SceneRegistry::Registrar registrar{ { "TurtleCanvas", main, setup, Display, Canvas::Resize, Canvas::KeyInput } };
 }
@@ -1,14 +1,22 @@
+#pragma once
 ///////////////////////////////////////////////////////////////////////////////////////          
 //Example of turtle graphics with ngons
+//
+// Interaction:
+// Press + and - to double and halve the vertices of the rosette.
 /////////////////////////////////////////////////////////////////////////////////////// 
 
 #define _USE_MATH_DEFINES 
 
 #include <cmath>
 #include <vector>
+#include <algorithm>
 #include <iostream>
 #include <GL/glew.h>
 #include <GL/freeglut.h>
+#include "SceneRegistry.h"
+#include "LineBatch.h"
+#include "Rosette.h"
 
 namespace TurtleCanvasNgons
 {
@@ -71,6 +79,7 @@ namespace TurtleCanvasNgons
 	using FloatRect = Rect<float>;
 
 	void Display();
+	void ChangeRosette(bool isLarger);
 
 	struct Canvas
 	{
@@ -92,6 +101,14 @@ namespace TurtleCanvasNgons
 				case 27:
 					exit(0);
 					break;	
+				case '+':
+					ChangeRosette(true);
+					glutPostRedisplay();
+					break;
+				case '-':
+					ChangeRosette(false);
+					glutPostRedisplay();
+					break;
 			}
 		}
 
@@ -126,6 +143,14 @@ namespace TurtleCanvasNgons
 			glewExperimental = GL_TRUE;
 			glewInit();
 
+			Setup(width, height);
+		}
+
+		void Setup(int pWidth, int pHeight)
+		{
+			width = pWidth;
+			height = pHeight;
+
 			SetWindow(0.f, width, 0.f, height);
 			SetViewport(0.f, width, 0.f, height);
 			CP.Set(0.f, 0.f);
@@ -133,6 +158,7 @@ namespace TurtleCanvasNgons
 		
 		void SetWindow(float l, float r, float b, float t)
 		{
+			lines.flush();
 			glMatrixMode(GL_PROJECTION);
 			glLoadIdentity();
 			gluOrtho2D(l, r, b, t);
@@ -141,6 +167,7 @@ namespace TurtleCanvasNgons
 
 		void SetViewport(int l, int r, int b, int t)
 		{
+			lines.flush();
 			viewport.Set(l, r, b, t);
 			glViewport(l, b, r - l, t - b);
 		}
@@ -165,6 +192,8 @@ namespace TurtleCanvasNgons
 
 		void ClearScreen()
 		{
+			// The segments not drawn yet would be cleared anyway
+			lines.clear();
 			glClear(GL_COLOR_BUFFER_BIT);
 		}
 
@@ -176,18 +205,13 @@ namespace TurtleCanvasNgons
 		void SetColor(float r, float g, float b)
 		{
 			glColor3f(r, g, b);
+			lines.setColor(r, g, b);
 		}
 
 		void LineTo(float x, float y)
 		{
-			glBegin(GL_LINES);
-				glVertex2f(CP.X, CP.Y);
-				glVertex2f(x, y);
-			glEnd();
-
+			lines.add(CP.X, CP.Y, x, y);
 			CP.Set(x, y);
-
-			glFlush();
 		}
 
 		void LineTo(const Point2& p)
@@ -195,6 +219,13 @@ namespace TurtleCanvasNgons
 			LineTo(p.X, p.Y);
 		}		
 
+		// Draws the segments added since the last call
+		void Flush()
+		{
+			lines.flush();
+			glFlush();
+		}
+
 		void MoveTo(float x, float y)
 		{
 			CP.Set(x, y);
@@ -266,6 +297,7 @@ namespace TurtleCanvasNgons
 		Point2 CP;
 		IntRect viewport;
 		FloatRect window;
+		LineBatch::Batch lines;
 		
 		float width;
 		float height;
@@ -302,29 +334,14 @@ namespace TurtleCanvasNgons
 		}
 	}
 
-	void Rosette(Canvas& cvs, int N, float R, const Point2& Start)
-	{
-		if(N < 3) return;
-
-		std::vector<Point2> points;
-		points.reserve(N);
-		
-		const auto angle = 2 * M_PI / N;
-
-		for(int i = 0; i < N; ++i)
-		{
-			const auto angleInc = angle + angle * i;
-			points.push_back(Point2(R * std::cos(angleInc) + Start.X, R * std::sin(angleInc) + Start.Y));
-		}
+	static int rosetteN = 20;
+	// The chords of the rosette are drawn from buffers, with one draw call
+	static Rosette::Batch rosette;
 
-		for(int i = 0; i < (N - 1); ++i)
-		{
-			for(int j = i + 1; j < N; ++j)
-			{
-				cvs.MoveTo(points[i]);
-				cvs.LineTo(points[j]);
-			}
-		}
+	void ChangeRosette(bool isLarger)
+	{
+		rosetteN = isLarger ? std::min(rosetteN * 2, 5120) : std::max(rosetteN / 2, 5);
+		std::cout << "Rosette of " << rosetteN << " vertices, " << Rosette::getChordsN(rosetteN) << " chords" << std::endl;
 	}
 
 	void Display()
@@ -333,17 +350,28 @@ namespace TurtleCanvasNgons
 		cvs.ClearScreen();
 		cvs.SetColor(0.f, 0.f, 0.f);
 		
-		Rosette(cvs, 20, 100.f, Point2(cvs.GetScreenWidth() / 2, cvs.GetScreenHeight() / 2));	
+		rosette.set(rosetteN, 100.f, cvs.GetScreenWidth() / 2, cvs.GetScreenHeight() / 2);
+		rosette.draw();
+
+		cvs.Flush();
 	}
 
 
 
 	void printInteraction()
 	{
-
+		std::cout << "Interaction:\n";
+		std::cout << "Press + and - to double and halve the vertices of the rosette" << std::endl;
 	}
 
 	
+	void setup()
+	{
+		auto& cvs = Canvas::Get();
+		cvs.Setup(640, 480);
+		cvs.SetBackgroundColor(1.f, 1.f, 1.f);
+	}
+
 	int main(int argc, char** argv)
 	{
 		printInteraction();
@@ -358,4 +386,5 @@ namespace TurtleCanvasNgons
 		return 0;
 	}
 
+	static SceneRegistry::Registrar registrar{ { "TurtleCanvasNgons", main, setup, Display, Canvas::Resize, Canvas::KeyInput } };
 }
@@ -0,0 +1,243 @@
+#pragma once
+///////////////////////////////////////////////////////////////////////////////////////
+// Turtle routines recorded once and replayed from their line segments.
+//
+// A Program is the list of the pen commands a routine gave, recorded by a canvas
+// instead of drawing them. evaluate() runs the commands from a turtle State with
+// the same float math as the canvas and gives the visible segments and where the
+// turtle stops, so a replayed drawing is the drawing the routine would make.
+//
+// A Replay keeps the program of a routine for a key of the parameters it depends
+// on and the segments of every state it started from. Routines that do not turn
+// the turtle a whole number of times start from another heading every redisplay,
+// so a few of those are kept and the oldest are dropped after maxEntries. Some,
+// like the polyspirals, never start from the same state twice: after maxEntries
+// misses in a row the Replay stops looking states up and evaluates the program
+// every redisplay into the same segments until the key changes.
+///////////////////////////////////////////////////////////////////////////////////////
+
+#include <cmath>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+namespace TurtleProgram
+{
+	// The current position of the pen and its direction in degrees
+	struct State
+	{
+		float X;
+		float Y;
+		float CD;
+
+		bool operator==(const State& other) const noexcept
+		{
+			return X == other.X && Y == other.Y && CD == other.CD;
+		}
+	};
+
+	struct Segment
+	{
+		float X0;
+		float Y0;
+		float X1;
+		float Y1;
+	};
+
+	enum class Op : std::uint8_t
+	{
+		MOVE_TO,
+		LINE_TO,
+		MOVE_REL,
+		LINE_REL,
+		FORWARD,
+		SKIP,
+		TURN,
+		TURN_TO,
+		PUSH,
+		POP
+	};
+
+	struct Command
+	{
+		Op op;
+		float a;
+		float b;
+	};
+
+	// Where the turtle is after going dist along its direction
+	inline State advance(State state, float dist)
+	{
+		const float RadPerDeg = 0.017453393;
+		state.X = state.X + dist * cos(RadPerDeg * state.CD);
+		state.Y = state.Y + dist * sin(RadPerDeg * state.CD);
+
+		return state;
+	}
+
+	class Program
+	{
+	public:
+
+		void add(Op op, float a = 0.f, float b = 0.f)
+		{
+			commands.push_back({ op, a, b });
+		}
+
+		void clear()
+		{
+			commands.clear();
+		}
+
+		std::size_t getCommandsN() const noexcept
+		{
+			return commands.size();
+		}
+
+		// Appends the visible segments of the commands run from state, returns where the turtle stops
+		State evaluate(State state, std::vector<Segment>& segments) const
+		{
+			std::vector<State> saved;
+
+			const auto lineTo = [&](float x, float y) {
+				segments.push_back({ state.X, state.Y, x, y });
+				state.X = x;
+				state.Y = y;
+			};
+
+			for(const auto& command : commands)
+			{
+				switch(command.op)
+				{
+					case Op::MOVE_TO:
+						state.X = command.a;
+						state.Y = command.b;
+						break;
+					case Op::LINE_TO:
+						lineTo(command.a, command.b);
+						break;
+					case Op::MOVE_REL:
+						state.X = state.X + command.a;
+						state.Y = state.Y + command.b;
+						break;
+					case Op::LINE_REL:
+						lineTo(state.X + command.a, state.Y + command.b);
+						break;
+					case Op::FORWARD:
+					{
+						const auto next = advance(state, command.a);
+						lineTo(next.X, next.Y);
+						break;
+					}
+					case Op::SKIP:
+						state = advance(state, command.a);
+						break;
+					case Op::TURN:
+						state.CD += command.a;
+						break;
+					case Op::TURN_TO:
+						state.CD = command.a;
+						break;
+					case Op::PUSH:
+						saved.push_back(state);
+						break;
+					case Op::POP:
+						if(!saved.empty())
+						{
+							state = saved.back();
+							saved.pop_back();
+						}
+						break;
+				}
+			}
+
+			return state;
+		}
+
+	private:
+
+		std::vector<Command> commands;
+	};
+
+	// Canvas needs Record, StopRecording, GetState and Replay(segments, end)
+	template<typename Canvas, typename Key>
+	class Replay
+	{
+	public:
+
+		static constexpr std::size_t maxEntries = 64;
+
+		// Draws routine(cvs) from the cached segments, the routine is recorded again when key changes
+		template<typename Routine>
+		void draw(Canvas& cvs, const Key& pKey, Routine routine)
+		{
+			if(!isRecorded || !(pKey == key))
+			{
+				program.clear();
+				cvs.Record(program);
+				routine(cvs);
+				cvs.StopRecording();
+
+				entries.clear();
+				key = pKey;
+				isRecorded = true;
+				misses = 0;
+			}
+
+			const auto start = cvs.GetState();
+
+			if(misses >= maxEntries)
+			{
+				// The states met so far are not coming back
+				entries.clear();
+				uncached.segments.clear();
+				uncached.end = program.evaluate(start, uncached.segments);
+				cvs.Replay(uncached.segments, uncached.end);
+				return;
+			}
+
+			const Entry* entry = nullptr;
+			for(const auto& e : entries)
+			{
+				if(e.start == start)
+					entry = &e;
+			}
+
+			misses = entry ? 0 : misses + 1;
+
+			if(!entry)
+			{
+				if(entries.size() == maxEntries)
+					entries.erase(entries.begin());
+
+				entries.push_back({ start, {}, start });
+				entries.back().end = program.evaluate(start, entries.back().segments);
+				entry = &entries.back();
+			}
+
+			cvs.Replay(entry->segments, entry->end);
+		}
+
+		const Program& getProgram() const noexcept
+		{
+			return program;
+		}
+
+	private:
+
+		struct Entry
+		{
+			State start;
+			std::vector<Segment> segments;
+			State end;
+		};
+
+		Program program;
+		Key key{};
+		bool isRecorded = false;
+		std::vector<Entry> entries;
+		// Lookups in a row that found nothing
+		std::size_t misses = 0;
+		Entry uncached{};
+	};
+}
@@ -1,3 +1,4 @@
+#pragma once
 ///////////////////////////////////////////////////////////////////////////////////////          
 //Simple twin program
 /////////////////////////////////////////////////////////////////////////////////////// 
@@ -9,6 +10,7 @@
 #include <iostream>
 #include <GL/glew.h>
 #include <GL/freeglut.h>
+#include "SceneRegistry.h"
 #include <sstream>
 
 namespace TwinTry
@@ -438,4 +440,5 @@ namespace TwinTry
 		return 0;
 	}
 
+	static SceneRegistry::Registrar registrar{ { "TwinTry", main, setup, drawScene, resize, keyInput } };
 }
@@ -1,3 +1,4 @@
+#pragma once
 /////////////////////////////////////////////////////////////////////         
 // This program draws a circle with of VBO and glDrawArrays()
 ///////////////////////////////////////////////////////////////////// 
@@ -9,6 +10,8 @@
 #include <iostream>
 #include <GL/glew.h>
 #include <GL/freeglut.h> 
+#include "SceneRegistry.h"
+#include "ArcGenerator.h"
 #include <vector>
 
 namespace VAOCircle
@@ -31,14 +34,11 @@ namespace VAOCircle
 	{
 		vertices.reserve((N + 1) * 3);
 
-		float t;
-		for (int i = 0; i <= N; ++i)
-		{
-			t = 2 * M_PI * i / N;
-			vertices.push_back(X + R * cos(t));
-			vertices.push_back(Y - R * sin(t));
+		ArcGenerator::forEachPoint(0.f, 2 * M_PI, N, [](float c, float s) {
+			vertices.push_back(X + R * c);
+			vertices.push_back(Y - R * s);
 			vertices.push_back(0.0);
-		}
+		});
 
 		vertices.shrink_to_fit();
 	}
@@ -120,4 +120,6 @@ namespace VAOCircle
 
 		return 0;
 	}
+
+	static SceneRegistry::Registrar registrar{ { "VAOCircle", main, setup, drawScene, resize, keyInput } };
 }
\ No newline at end of file
@@ -1,8 +1,11 @@
+#pragma once
 //////////////////////////////////////////////////////////////////////////////////////          
-// This program draws sphere as two hemispheres with using two VAOs with VBOs inside
+// This program draws sphere as two hemispheres with using two VAOs with VBOs inside,
+// with fewer slices the smaller the sphere is on screen
 // 
 // Interaction:
 // Press x, X, y, Y, z, Z to turn the sphere.
+// Press o to toggle between the strips and vertex cache optimized triangle lists.
 ////////////////////////////////////////////////////////////////////////////////////// 
 
 #define _USE_MATH_DEFINES 
@@ -11,6 +14,12 @@
 #include <iostream>
 #include <GL/glew.h>
 #include <GL/freeglut.h> 
+#include "SceneRegistry.h"
+#include "SimdMath.h"
+#include "ParametricSurface.h"
+#include "LevelOfDetail.h"
+#include "VertexCache.h"
+#include "MeshCache.h"
 #include <vector>
 
 namespace VAOSphere
@@ -31,72 +40,96 @@ namespace VAOSphere
 	static const int LONG_SLICES = 20;
 	static const int LAT_SLICES = 10;
 	static float Xangle = 0.0, Yangle = 0.0, Zangle = 0.0;
-	static float vertices[3 * (LONG_SLICES + 1) * (LAT_SLICES + 1)];
-	static unsigned int indices[LAT_SLICES][2 * (LONG_SLICES + 1)];
-	static int countIndices[LAT_SLICES]; 
-	void* offsets[LAT_SLICES];
-	static unsigned int buffer[2];
+	// Every hemisphere at LONG_SLICES x LAT_SLICES and its coarser levels, one after another in its buffer
+	static LevelOfDetail::Levels levels[2];
+	static bool isVertexCacheOptimized;
+	// The index counts and byte offsets of the strips, or the one triangle list, of every level,
+	// the same in the element buffers of both hemispheres
+	static std::vector<std::vector<GLsizei>> counts;
+	static std::vector<std::vector<const void*>> offsets;
+	static unsigned int buffers[2][2];
 	static unsigned int VAOs[2];
 
-	void fillVertices(HSPH hsph)
-	{
-		int i, j, k, until;
-		j = hsph == HSPH::UP ? 0 : -LAT_SLICES;
-		until = hsph == HSPH::UP ? LAT_SLICES : 0;
+	// Part of the mesh cache key, bumped when the formula below changes
+	constexpr int meshVersion = 1;
 
-		k = 0;
-		for (; j <= until; j++)
-			for (i = 0; i <= LONG_SLICES; i++)
-			{
-				vertices[k++] = RADIUS * cos((float)j / LAT_SLICES * M_PI / 2.0) * cos(2.0 * (float)i / LONG_SLICES * M_PI);
-				vertices[k++] = RADIUS * sin((float)j / LAT_SLICES * M_PI / 2.0);
-				vertices[k++] = -RADIUS * cos((float)j / LAT_SLICES * M_PI / 2.0) * sin(2.0 * (float)i / LONG_SLICES * M_PI);
-			}
+	LevelOfDetail::Levels getLevels(HSPH hsph)
+	{
+		return LevelOfDetail::Levels(LONG_SLICES, LAT_SLICES, [hsph](int longSlices, int latSlices) {
+			const int firstLatitude = hsph == HSPH::UP ? 0 : -latSlices;
+			const auto key = MeshCache::getKey(meshVersion, longSlices, latSlices, firstLatitude, RADIUS, isVertexCacheOptimized);
+
+			return MeshCache::getMesh("VAOSphere", key, [=] {
+				auto mesh = ParametricSurface::tessellate({ longSlices, latSlices }, [=](int i, int j) {
+					j += firstLatitude;
+
+					return SimdMath::Vec3(
+						RADIUS * cos((float)j / latSlices * M_PI / 2.0) * cos(2.0 * (float)i / longSlices * M_PI),
+						RADIUS * sin((float)j / latSlices * M_PI / 2.0),
+						-RADIUS * cos((float)j / latSlices * M_PI / 2.0) * sin(2.0 * (float)i / longSlices * M_PI)
+					);
+				});
+
+				return isVertexCacheOptimized ? VertexCache::optimize(std::move(mesh)) : mesh;
+			});
+		}, M_PI / 2.0);
 	}
 
-	void fillIndices()
+	void fillBuffers(HSPH hsph)
 	{
-		int i, j;
-		for (j = 0; j < LAT_SLICES; j++)
+		levels[hsph] = getLevels(hsph);
+
+		std::vector<SimdMath::Vec3> vertices;
+		std::vector<unsigned int> indices;
+		counts.clear();
+		offsets.clear();
+
+		for (std::size_t level = 0; level < levels[hsph].size(); level++)
 		{
-			for (i = 0; i <= LONG_SLICES; i++)
+			const auto& mesh = levels[hsph].getMesh(level);
+			const auto firstVertex = static_cast<unsigned int>(vertices.size());
+			const auto firstByte = indices.size() * sizeof(unsigned int);
+
+			vertices.insert(vertices.end(), mesh.positions.begin(), mesh.positions.end());
+			for (const auto index : mesh.indices)
+				indices.push_back(firstVertex + index);
+
+			if (mesh.topology == ParametricSurface::Topology::triangles)
 			{
-				indices[j][2 * i] = (j + 1) * (LONG_SLICES + 1) + i;
-				indices[j][2 * i + 1] = j * (LONG_SLICES + 1) + i;
+				counts.push_back({ static_cast<GLsizei>(mesh.indices.size()) });
+				offsets.push_back({ reinterpret_cast<const void*>(firstByte) });
+				continue;
 			}
+
+			counts.push_back(mesh.counts);
+			offsets.emplace_back();
+			for (const auto offset : mesh.offsets)
+				offsets.back().push_back(static_cast<const char*>(offset) + firstByte);
 		}
-	}
 
-	void fillCountIndices(void)
-	{
-		int j;
-		for (j = 0; j < LAT_SLICES; j++) countIndices[j] = 2 * (LONG_SLICES + 1);
-	}
+		glBindBuffer(GL_ARRAY_BUFFER, buffers[hsph][VERTICES]);
+		glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(vertices[0]), vertices.data(), GL_STATIC_DRAW);
 
-	void fillOffsets(void)
-	{
-		int j;
-		for (j = 0; j < LAT_SLICES; j++) offsets[j] = (void*)(2 * (LONG_SLICES + 1) * j * sizeof(unsigned int));
+		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, buffers[hsph][INDICES]);
+		glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(indices[0]), indices.data(), GL_STATIC_DRAW);
 	}
 
 	void initVAO(HSPH hsph)
 	{
 		glBindVertexArray(VAOs[hsph]);
 
-		fillVertices(hsph);
-		fillIndices();
-
-		glGenBuffers(2, buffer);
-		glBindBuffer(GL_ARRAY_BUFFER, buffer[VERTICES]);
-		glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
-
-		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, buffer[INDICES]);
-		glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(indices), indices, GL_STATIC_DRAW);
+		glGenBuffers(2, buffers[hsph]);
+		fillBuffers(hsph);
 
 		glEnableClientState(GL_VERTEX_ARRAY);
 		glVertexPointer(3, GL_FLOAT, 0, 0);
 	}
 
+	void printVertexCacheStats()
+	{
+		std::cout << (isVertexCacheOptimized ? "Optimized triangle lists: " : "Strips: ") << VertexCache::getStats(levels[HSPH::UP].getMesh(0)) << std::endl;
+	}
+
 	void setup(void)
 	{
 		glClearColor(1.0, 1.0, 1.0, 0.0);
@@ -105,9 +138,6 @@ namespace VAOSphere
 
 		initVAO(HSPH::UP);
 		initVAO(HSPH::DOWN);
-
-		fillOffsets();
-		fillCountIndices();
 	}
 
 	void drawScene(void)
@@ -125,11 +155,14 @@ namespace VAOSphere
 		glPolygonMode(GL_FRONT_AND_BACK, GL_LINE);
 		glColor3f(0.0, 0.0, 0.0);
 
+		const auto level = levels[HSPH::UP].getLevelFor(RADIUS);
+		const auto mode = isVertexCacheOptimized ? GL_TRIANGLES : GL_TRIANGLE_STRIP;
+
 		glBindVertexArray(VAOs[HSPH::UP]);
-		glMultiDrawElements(GL_TRIANGLE_STRIP, countIndices, GL_UNSIGNED_INT, (const void**)offsets, LAT_SLICES);
+		glMultiDrawElements(mode, counts[level].data(), GL_UNSIGNED_INT, offsets[level].data(), counts[level].size());
 
 		glBindVertexArray(VAOs[HSPH::DOWN]);
-		glMultiDrawElements(GL_TRIANGLE_STRIP, countIndices, GL_UNSIGNED_INT, (const void**)offsets, LAT_SLICES);
+		glMultiDrawElements(mode, counts[level].data(), GL_UNSIGNED_INT, offsets[level].data(), counts[level].size());
 
 		glFlush();
 	}
@@ -150,6 +183,15 @@ namespace VAOSphere
 		case 27:
 			exit(0);
 			break;
+		case 'o':
+			isVertexCacheOptimized = !isVertexCacheOptimized;
+			// Both hemispheres get the same index layout, the tables of the last one serve both
+			glBindVertexArray(0);
+			fillBuffers(HSPH::UP);
+			fillBuffers(HSPH::DOWN);
+			printVertexCacheStats();
+			glutPostRedisplay();
+			break;
 		case 'x':
 			Xangle += 5.0;
 			if (Xangle > 360.0) Xangle -= 360.0;
@@ -189,6 +231,7 @@ namespace VAOSphere
 	{
 		std::cout << "Interaction:" << std::endl;
 		std::cout << "Press x, X, y, Y, z, Z to turn the sphere" << std::endl;
+		std::cout << "Press o to toggle between the strips and vertex cache optimized triangle lists" << std::endl;
 	}
 
 	int main(int argc, char** argv)
@@ -216,4 +259,6 @@ namespace VAOSphere
 
 		return 0;
 	}
+
+	static SceneRegistry::Registrar registrar{ { "VAOSphere", main, setup, drawScene, resize, keyInput } };
 }
\ No newline at end of file
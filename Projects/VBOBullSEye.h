@@ -1,3 +1,4 @@
+#pragma once
 ///////////////////////////////////////////////////////////////////////////////////////////        
 //  This program draws BullSEye with help of glMultiDrawArrays()
 /////////////////////////////////////////////////////////////////////////////////////////// 
@@ -9,22 +10,23 @@
 #include <iostream>
 #include <GL/glew.h>
 #include <GL/freeglut.h> 
+#include "SceneRegistry.h"
+#include "ArcGenerator.h"
+#include "Tessellation.h"
 #include <vector>
 
 namespace VBOBullSEye
 {
-	static int N = 40;
+	static const int N = 40;
+	static const int discsN = 5;
 	static std::vector<float> verticesAndColors;
-	static std::vector<int> firsts;
-	static std::vector<int> counts;
+	// Every disc is a fan of its center and N + 1 points on the circle
+	static constexpr auto discs = Tessellation::makeRuns<discsN, N + 2>();
 	static unsigned int verticesID;
 
 
 	void collectVerticesForDisc(float R0, float X, float Y, float Z, float R, float G, float B)
 	{
-		float t;
-		int i;
-
 		verticesAndColors.push_back(X);
 		verticesAndColors.push_back(Y);
 		verticesAndColors.push_back(Z);
@@ -34,22 +36,21 @@ namespace VBOBullSEye
 		verticesAndColors.push_back(B);
 
 
-		for (i = 0; i <= N; ++i)
-		{
-			t = 2 * M_PI * i / N;
-
-			verticesAndColors.push_back(X + R0 * cos(t));
-			verticesAndColors.push_back(Y + R0 * sin(t));
+		ArcGenerator::forEachPoint(0.f, 2 * M_PI, N, [&](float c, float s) {
+			verticesAndColors.push_back(X + R0 * c);
+			verticesAndColors.push_back(Y + R0 * s);
 			verticesAndColors.push_back(Z);
 
 			verticesAndColors.push_back(R);
 			verticesAndColors.push_back(G);
 			verticesAndColors.push_back(B);
-		}
+		});
 	}
 
 	void fillVertices()
 	{
+		verticesAndColors.reserve(discs.vertexCount * 6);
+
 		collectVerticesForDisc(20.0, 50.0, 50.0, 0.0, 1.f, 0.f, 0.f);
 		collectVerticesForDisc(50.0 / 3.0, 50.0, 50.0, 0.25, 1.f, 1.f, 1.f);
 		collectVerticesForDisc(40.0 / 3.0, 50.0, 50.0, 0.5, 1.f, 0.f, 0.f);
@@ -57,22 +58,6 @@ namespace VBOBullSEye
 		collectVerticesForDisc(5.0, 50.0, 50.0, 0.76, 1.f, 0.f, 0.f);
 	}
 
-	void fillFirsts()
-	{
-		for (int i = 0; i < 6; ++i)
-		{
-			firsts.push_back((N + 2) * i);
-		}
-	}
-
-	void fillCounts()
-	{
-		for (int i = 0; i < 5; ++i)
-		{
-			counts.push_back(N + 2);
-		}
-	}
-
 	void drawScene(void)
 	{
 		glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
@@ -80,7 +65,7 @@ namespace VBOBullSEye
 
 		glEnable(GL_DEPTH_TEST);
 
-		glMultiDrawArrays(GL_TRIANGLE_FAN, firsts.data(), counts.data(), counts.size());
+		glMultiDrawArrays(GL_TRIANGLE_FAN, discs.firsts, discs.counts, discsN);
 
 		glDisable(GL_DEPTH_TEST);
 
@@ -93,8 +78,6 @@ namespace VBOBullSEye
 		glEnableClientState(GL_COLOR_ARRAY);
 
 		fillVertices();
-		fillFirsts();
-		fillCounts();
 
 		glGenBuffers(1, &verticesID);
 		glBindBuffer(GL_ARRAY_BUFFER, verticesID);
@@ -151,4 +134,6 @@ namespace VBOBullSEye
 
 		return 0;
 	}
+
+	static SceneRegistry::Registrar registrar{ { "VBOBullSEye", main, setup, drawScene, resize, keyInput } };
 }
\ No newline at end of file
@@ -0,0 +1,270 @@
+#pragma once
+///////////////////////////////////////////////////////////////////////////////////////
+// Post-transform vertex cache optimization of indexed meshes.
+//
+// optimize turns the strips or triangles of a ParametricSurface mesh into a
+// triangle list ordered with Tom Forsyth's linear-speed algorithm: triangles
+// are scored by how recently their vertices were used in a simulated LRU cache
+// and how many triangles still need them, and the best one is emitted next.
+// The vertices are then renumbered in the order the triangles first use them,
+// so fetching them walks the vertex buffer forward. getStats simulates a FIFO
+// cache like the hardware one to compare layouts by ACMR, the vertices
+// transformed per triangle, and ATVR, the vertices transformed per vertex.
+///////////////////////////////////////////////////////////////////////////////////////
+
+#include <cmath>
+#include <vector>
+#include <cstddef>
+#include <ostream>
+#include <algorithm>
+#include "ParametricSurface.h"
+
+namespace VertexCache
+{
+	// The cache the optimizer models and the one the statistics simulate
+	constexpr int lruSize = 32;
+	constexpr int fifoSize = 16;
+
+	struct Stats
+	{
+		float acmr;
+		float atvr;
+	};
+
+	inline std::ostream& operator<<(std::ostream& os, const Stats& stats)
+	{
+		return os << "ACMR " << stats.acmr << ", ATVR " << stats.atvr;
+	}
+
+	// The triangles of a strip with the strip's winding, without the ones sharing an index
+	inline void appendStripTriangles(std::vector<unsigned int>& triangles, const unsigned int* strip, std::size_t count)
+	{
+		for(std::size_t k = 2; k < count; ++k)
+		{
+			const auto a = strip[k - 2 + (k & 1)];
+			const auto b = strip[k - 1 - (k & 1)];
+			const auto c = strip[k];
+
+			if(a != b && b != c && a != c)
+				triangles.insert(triangles.end(), { a, b, c });
+		}
+	}
+
+	// The triangles of a mesh in the order they are drawn
+	inline std::vector<unsigned int> getTriangles(const ParametricSurface::Mesh& mesh)
+	{
+		if(mesh.topology == ParametricSurface::Topology::triangles)
+			return mesh.indices;
+
+		std::vector<unsigned int> r;
+		r.reserve(3 * mesh.indices.size());
+
+		for(int j{}; j < static_cast<int>(mesh.counts.size()); ++j)
+			appendStripTriangles(r, mesh.getStrip(j), mesh.counts[j]);
+
+		return r;
+	}
+
+	// Misses of a FIFO cache of fifoSize entries while drawing the triangles
+	inline Stats getStats(const std::vector<unsigned int>& triangles, std::size_t vertexCount)
+	{
+		std::vector<unsigned int> fifo(fifoSize);
+		std::vector<char> isCached(vertexCount);
+		std::size_t next{}, cached{}, misses{};
+
+		for(const auto index : triangles)
+		{
+			if(isCached[index])
+				continue;
+
+			++misses;
+
+			if(cached == fifo.size())
+				isCached[fifo[next]] = false;
+			else
+				++cached;
+
+			fifo[next] = index;
+			isCached[index] = true;
+			next = (next + 1) % fifo.size();
+		}
+
+		const auto trianglesN = std::max<std::size_t>(triangles.size() / 3, 1);
+
+		return { static_cast<float>(misses) / trianglesN, static_cast<float>(misses) / std::max<std::size_t>(vertexCount, 1) };
+	}
+
+	inline Stats getStats(const ParametricSurface::Mesh& mesh)
+	{
+		return getStats(getTriangles(mesh), mesh.positions.size());
+	}
+
+	namespace Detail
+	{
+		// Forsyth's vertex score, cachePosition is -1 outside the cache
+		inline float getScore(int cachePosition, int remainingTriangles)
+		{
+			if(remainingTriangles == 0)
+				return -1.f;
+
+			float r{};
+
+			// The last triangle's vertices score the same, whichever order they were added in
+			if(cachePosition >= 0)
+				r = cachePosition < 3 ? 0.75f : std::pow(1.f - (cachePosition - 3) / static_cast<float>(lruSize - 3), 1.5f);
+
+			// Vertices with few triangles left are worth finishing off
+			return r + 2.f / std::sqrt(static_cast<float>(remainingTriangles));
+		}
+	}
+
+	// The triangles reordered for the vertex cache, every triangle keeps its winding
+	inline std::vector<unsigned int> optimizeTriangles(const std::vector<unsigned int>& triangles, std::size_t vertexCount)
+	{
+		const auto trianglesN = triangles.size() / 3;
+
+		// The triangles of every vertex, as offsets into one array
+		std::vector<std::size_t> firstTriangle(vertexCount + 1);
+		for(const auto index : triangles)
+			++firstTriangle[index + 1];
+		for(std::size_t v{}; v < vertexCount; ++v)
+			firstTriangle[v + 1] += firstTriangle[v];
+
+		std::vector<std::size_t> vertexTriangles(triangles.size());
+		std::vector<int> remaining(vertexCount);
+		for(std::size_t t{}; t < trianglesN; ++t)
+			for(int k{}; k < 3; ++k)
+			{
+				const auto v = triangles[3 * t + k];
+				vertexTriangles[firstTriangle[v] + remaining[v]++] = t;
+			}
+
+		std::vector<float> vertexScore(vertexCount);
+		for(std::size_t v{}; v < vertexCount; ++v)
+			vertexScore[v] = Detail::getScore(-1, remaining[v]);
+
+		std::vector<float> triangleScore(trianglesN);
+		std::vector<char> isAdded(trianglesN);
+		for(std::size_t t{}; t < trianglesN; ++t)
+			triangleScore[t] = vertexScore[triangles[3 * t]] + vertexScore[triangles[3 * t + 1]] + vertexScore[triangles[3 * t + 2]];
+
+		// Drops t from the triangles v still has to draw
+		const auto removeTriangle = [&](unsigned int v, std::size_t t) {
+			const auto first = vertexTriangles.begin() + firstTriangle[v];
+			const auto last = first + remaining[v];
+
+			std::iter_swap(std::find(first, last, t), last - 1);
+			--remaining[v];
+		};
+
+		std::vector<unsigned int> cache, nextCache;
+		cache.reserve(lruSize + 3);
+		nextCache.reserve(lruSize + 3);
+
+		std::vector<unsigned int> r;
+		r.reserve(triangles.size());
+
+		std::size_t scan{};
+		auto best = trianglesN;
+
+		for(std::size_t added{}; added < trianglesN; ++added)
+		{
+			// Nothing in the cache is left to draw, start over from the first triangle not added yet
+			if(best == trianglesN)
+			{
+				while(isAdded[scan])
+					++scan;
+
+				best = scan;
+				for(auto t = scan; t < trianglesN; ++t)
+					if(!isAdded[t] && triangleScore[t] > triangleScore[best])
+						best = t;
+			}
+
+			const auto* triangle = &triangles[3 * best];
+			r.insert(r.end(), triangle, triangle + 3);
+			isAdded[best] = true;
+
+			// The vertices of the triangle move to the front of the cache, the rest keep their order
+			nextCache.assign(triangle, triangle + 3);
+			for(const auto v : cache)
+				if(v != triangle[0] && v != triangle[1] && v != triangle[2])
+					nextCache.push_back(v);
+
+			for(int k{}; k < 3; ++k)
+				removeTriangle(triangle[k], best);
+
+			for(std::size_t i = lruSize; i < nextCache.size(); ++i)
+				vertexScore[nextCache[i]] = Detail::getScore(-1, remaining[nextCache[i]]);
+
+			nextCache.resize(std::min<std::size_t>(nextCache.size(), lruSize));
+			std::swap(cache, nextCache);
+
+			for(int i{}; i < static_cast<int>(cache.size()); ++i)
+				vertexScore[cache[i]] = Detail::getScore(i, remaining[cache[i]]);
+
+			// Only the triangles of cached vertices changed score, the best of them is drawn next
+			best = trianglesN;
+			for(const auto v : cache)
+			{
+				for(int k{}; k < remaining[v]; ++k)
+				{
+					const auto t = vertexTriangles[firstTriangle[v] + k];
+					triangleScore[t] = vertexScore[triangles[3 * t]] + vertexScore[triangles[3 * t + 1]] + vertexScore[triangles[3 * t + 2]];
+
+					if(best == trianglesN || triangleScore[t] > triangleScore[best])
+						best = t;
+				}
+			}
+		}
+
+		return r;
+	}
+
+	// Renumbers the vertices in the order the indices first use them, the unused ones go last
+	inline void reorderVertices(ParametricSurface::Mesh& mesh)
+	{
+		const auto vertexCount = mesh.positions.size();
+		std::vector<unsigned int> newIndex(vertexCount, static_cast<unsigned int>(vertexCount));
+		unsigned int next{};
+
+		for(auto& index : mesh.indices)
+		{
+			if(newIndex[index] == vertexCount)
+				newIndex[index] = next++;
+
+			index = newIndex[index];
+		}
+
+		for(auto& index : newIndex)
+			if(index == vertexCount)
+				index = next++;
+
+		const auto reorder = [&](std::vector<ParametricSurface::Vec3>& vertices) {
+			if(vertices.empty())
+				return;
+
+			std::vector<ParametricSurface::Vec3> r(vertexCount);
+			for(std::size_t v{}; v < vertexCount; ++v)
+				r[newIndex[v]] = vertices[v];
+
+			vertices = std::move(r);
+		};
+
+		reorder(mesh.positions);
+		reorder(mesh.normals);
+	}
+
+	// The mesh as a triangle list optimized for the vertex cache and for fetching its vertices
+	inline ParametricSurface::Mesh optimize(ParametricSurface::Mesh mesh)
+	{
+		mesh.indices = optimizeTriangles(getTriangles(mesh), mesh.positions.size());
+		mesh.topology = ParametricSurface::Topology::triangles;
+		mesh.counts.clear();
+		mesh.offsets.clear();
+
+		reorderVertices(mesh);
+
+		return mesh;
+	}
+}
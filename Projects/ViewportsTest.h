@@ -1,3 +1,4 @@
+#pragma once
 #define _USE_MATH_DEFINES 
 
 #include <cmath>
@@ -5,6 +6,7 @@
 #include <array>
 #include <GL/glew.h>
 #include <GL/freeglut.h> 
+#include "SceneRegistry.h"
 
 namespace ViewportsTest
 {
@@ -134,4 +136,6 @@ namespace ViewportsTest
 
 		return 0;
 	}
+
+	static SceneRegistry::Registrar registrar{ { "ViewportsTest", main, setup, drawScene, resize, keyInput } };
 }
\ No newline at end of file
@@ -0,0 +1,230 @@
+#include "Offscreen.h"
+#include "Scenes.h"
+#include "TriangulatorBenchmark.h"
+#include "SphereBenchmark.h"
+#include "ClipBenchmark.h"
+#include "MeshCache.h"
+
+#include <cstdio>
+#include <fstream>
+
+namespace
+{
+	void printUsage(const char* programName)
+	{
+		std::cout << "Usage: " << programName << " [OPTIONS] (SCENE... | --all)\n";
+		std::cout << "Renders scenes without a window and prints the time of every frame as CSV.\n";
+		std::cout << "  --frames N     frames to measure per scene (default 100)\n";
+		std::cout << "  --warmup N     frames rendered before measuring (default 5)\n";
+		std::cout << "  --size WxH     framebuffer size (default 500x500)\n";
+		std::cout << "  --period MS    synthetic time step between frames (default 16.67)\n";
+		std::cout << "  --keys STR     keys pressed after setup, e.g. \" \" to start animations\n";
+		std::cout << "  --bench        print p50/p95/p99/max per scene instead of every frame\n";
+		std::cout << "  --csv FILE     write the benchmark summary as CSV\n";
+		std::cout << "  --json FILE    write the benchmark summary as JSON\n";
+		std::cout << "  --mesh-cache DIR  load and save generated meshes in DIR, by default they are generated every run\n";
+		std::cout << "  --list         print registered scenes\n";
+		std::cout << "  --triangulation  time the polygon triangulator from 10 to 1,000,000 vertices\n";
+		std::cout << "  --sphere-paths   time every way of drawing the Sphere scene from 8x4 to 2048x1024 slices\n";
+		std::cout << "  --clipping       time the segment clipping kernels on 10,000,000 random segments\n";
+	}
+
+	struct Options
+	{
+		Offscreen::RunSettings settings;
+		int width = 500;
+		int height = 500;
+		bool bench = false;
+		std::string csvPath;
+		std::string jsonPath;
+		std::vector<std::string> scenes;
+	};
+
+	bool parseOptions(int argc, char** argv, Options& options)
+	{
+		for(int i = 1; i < argc; ++i)
+		{
+			const std::string arg = argv[i];
+			const bool hasValue = i + 1 < argc;
+
+			try
+			{
+				if(arg == "--frames" && hasValue)
+				{
+					options.settings.frames = std::stoi(argv[++i]);
+				}
+				else if(arg == "--warmup" && hasValue)
+				{
+					options.settings.warmupFrames = std::stoi(argv[++i]);
+				}
+				else if(arg == "--period" && hasValue)
+				{
+					options.settings.framePeriodMs = std::stod(argv[++i]);
+				}
+				else if(arg == "--keys" && hasValue)
+				{
+					options.settings.keys = argv[++i];
+				}
+				else if(arg == "--size" && hasValue)
+				{
+					if(std::sscanf(argv[++i], "%dx%d", &options.width, &options.height) != 2)
+						return false;
+				}
+				else if(arg == "--csv" && hasValue)
+				{
+					options.bench = true;
+					options.csvPath = argv[++i];
+				}
+				else if(arg == "--json" && hasValue)
+				{
+					options.bench = true;
+					options.jsonPath = argv[++i];
+				}
+				else if(arg == "--mesh-cache" && hasValue)
+				{
+					MeshCache::setDirectory(argv[++i]);
+				}
+				else if(arg == "--bench")
+				{
+					options.bench = true;
+				}
+				else if(arg == "--all")
+				{
+					for(const auto& scene : SceneRegistry::getScenes())
+						options.scenes.push_back(scene.first);
+				}
+				else if(arg.rfind("--", 0) == 0)
+				{
+					return false;
+				}
+				else
+				{
+					options.scenes.push_back(arg);
+				}
+			}
+			catch(const std::exception&)
+			{
+				return false;
+			}
+		}
+
+		return !options.scenes.empty() && options.settings.frames > 0 && options.settings.warmupFrames >= 0
+			&& options.settings.framePeriodMs > 0.0 && options.width > 0 && options.height > 0;
+	}
+
+	template<typename Writer>
+	bool writeReport(const std::string& path, const std::vector<Benchmark::Summary>& summaries, Writer writer)
+	{
+		if(path.empty())
+			return true;
+
+		std::ofstream file(path);
+		writer(file, summaries);
+
+		if(!file)
+		{
+			std::cerr << "Cannot write " << path << '\n';
+			return false;
+		}
+
+		return true;
+	}
+}
+
+int main(int argc, char** argv)
+{
+	// Benchmarks time the generators and leave the working directory alone
+	MeshCache::setDirectory({});
+
+	if(argc == 2 && std::string(argv[1]) == "--list")
+	{
+		SceneRegistry::printScenes(std::cout);
+		return 0;
+	}
+
+	if(argc == 2 && std::string(argv[1]) == "--triangulation")
+	{
+		TriangulatorBenchmark::run(std::cout);
+		return 0;
+	}
+
+	if(argc == 2 && std::string(argv[1]) == "--sphere-paths")
+	{
+		Offscreen::Context context;
+
+		if(!context.create(SphereBenchmark::width, SphereBenchmark::height))
+		{
+			std::cerr << "Offscreen context: " << context.getError() << '\n';
+			return -1;
+		}
+
+		SphereBenchmark::run(context, std::cout);
+		return 0;
+	}
+
+	if(argc == 2 && std::string(argv[1]) == "--clipping")
+	{
+		ClipBenchmark::run(std::cout);
+		return 0;
+	}
+
+	Options options;
+
+	if(!parseOptions(argc, argv, options))
+	{
+		printUsage(argv[0]);
+		return -1;
+	}
+
+	for(const auto& name : options.scenes)
+	{
+		if(!SceneRegistry::findScene(name))
+		{
+			std::cerr << "Unknown scene: " << name << "\nAvailable scenes:\n";
+			SceneRegistry::printScenes(std::cerr);
+			return -1;
+		}
+	}
+
+	std::vector<Benchmark::Summary> summaries;
+
+	if(!options.bench)
+		std::cout << "scene,frame,cpu_ms,total_ms,draw_calls,allocations\n" << std::fixed << std::setprecision(4);
+
+	for(const auto& name : options.scenes)
+	{
+		// A fresh context per scene so no GL state leaks from one scene into the next
+		Offscreen::Context context;
+
+		if(!context.create(options.width, options.height))
+		{
+			std::cerr << "Offscreen context: " << context.getError() << '\n';
+			return -1;
+		}
+
+		const auto samples = Offscreen::run(*SceneRegistry::findScene(name), context, options.settings);
+		summaries.push_back(Benchmark::summarize(name, samples));
+
+		if(options.bench)
+			continue;
+
+		for(int i{}; i < static_cast<int>(samples.size()); ++i)
+		{
+			const auto& s = samples[i];
+			std::cout << name << ',' << i << ',' << s.cpuMs << ',' << s.totalMs << ',' << s.drawCalls << ',' << s.allocations << '\n';
+		}
+
+		std::cerr << name << " (" << context.getRenderer() << "): " << samples.size()
+			<< " frames, mean cpu " << summaries.back().cpuMs.mean << " ms\n";
+	}
+
+	if(!options.bench)
+		return 0;
+
+	Benchmark::writeTable(std::cout, summaries);
+
+	const auto written = writeReport(options.csvPath, summaries, Benchmark::writeCsv)
+		&& writeReport(options.jsonPath, summaries, Benchmark::writeJson);
+
+	return written ? 0 : -1;
+}
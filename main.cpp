@@ -1,7 +1,54 @@
+#include "Scenes.h"
+#include "GLContext.h"
 
-#include "GoldenRectanglesRegression.h"
+#include <cstdlib>
+
+namespace
+{
+	const char* defaultSceneName = "GoldenRectanglesRegression";
+
+	void printUsage(const char* programName)
+	{
+		std::cout << "Usage: " << programName << " [SCENE [SCENE_ARGS...]]\n";
+		std::cout << "       " << programName << " --list\n";
+		std::cout << "Without SCENE " << defaultSceneName << " is launched.\n";
+	}
+}
 
 int main(int argc, char** argv)
 {
-	return GoldenRectanglesRegression::main(argc, argv);
+	const std::string sceneName = argc > 1 ? argv[1] : defaultSceneName;
+
+	if(sceneName == "--help" || sceneName == "-h")
+	{
+		printUsage(argv[0]);
+		return 0;
+	}
+
+	if(sceneName == "--list")
+	{
+		SceneRegistry::printScenes(std::cout);
+		return 0;
+	}
+
+	const auto scene = SceneRegistry::findScene(sceneName);
+
+	if(!scene)
+	{
+		std::cerr << "Unknown scene: " << sceneName << "\nAvailable scenes:\n";
+		SceneRegistry::printScenes(std::cerr);
+		return -1;
+	}
+
+	// The names statics still hold at exit are left alone, the window may be gone by then
+	std::atexit(GLContext::end);
+
+	// The scene sees the program name followed only by its own arguments
+	if(argc > 1)
+	{
+		argv[1] = argv[0];
+		return scene->main(argc - 1, argv + 1);
+	}
+
+	return scene->main(argc, argv);
 }